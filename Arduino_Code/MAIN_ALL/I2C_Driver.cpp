@@ -1,36 +1,169 @@
 #include "I2C_Driver.h"
 
+typedef struct {
+  uint8_t Address;
+  uint32_t Transactions;
+  uint32_t Errors;
+  esp_err_t Last_Error;
+} I2C_Device_Stats;
+
+static SemaphoreHandle_t I2C_Mutex = NULL;
+static uint32_t I2C_Clock = I2C_Clock_Hz;
+static uint32_t I2C_Recoveries = 0;
+static I2C_Device_Stats I2C_Devices[I2C_Device_MAX];        // Written with the bus mutex held
 
 void I2C_Init(void) {
-  Wire.begin( I2C_SDA_PIN, I2C_SCL_PIN);                       
+  if (!I2C_Mutex)
+    I2C_Mutex = xSemaphoreCreateRecursiveMutex();
+  Wire.begin( I2C_SDA_PIN, I2C_SCL_PIN, I2C_Clock);
+  Wire.setTimeOut(I2C_Timeout_MS);
 }
 
+bool I2C_Lock(void)
+{
+  if (!I2C_Mutex)
+    return true;                                              // Before I2C_Init(), only setup() runs
+  return xSemaphoreTakeRecursive(I2C_Mutex, pdMS_TO_TICKS(I2C_Lock_Timeout_MS)) == pdTRUE;
+}
+void I2C_Unlock(void)
+{
+  if (I2C_Mutex)
+    xSemaphoreGiveRecursive(I2C_Mutex);
+}
 
-bool I2C_Read(uint8_t Driver_addr, uint8_t Reg_addr, uint8_t *Reg_data, uint32_t Length)
+bool I2C_Set_Clock(uint32_t Hz)
+{
+  if (!I2C_Lock())
+    return false;
+  bool Ok = Wire.setClock(Hz);
+  if (Ok)
+    I2C_Clock = Hz;
+  I2C_Unlock();
+  return Ok;
+}
+uint32_t I2C_Get_Clock(void)
 {
-  Wire.beginTransmission(Driver_addr);
-  Wire.write(Reg_addr); 
-  if ( Wire.endTransmission(true)){
-    printf("The I2C transmission fails. - I2C Read\r\n");
-    return -1;
+  return I2C_Clock;
+}
+
+static I2C_Device_Stats *I2C_Device(uint8_t Address)
+{
+  for (int i = 0; i < I2C_Device_MAX; i++) {
+    if (I2C_Devices[i].Address == Address)
+      return &I2C_Devices[i];
+    if (!I2C_Devices[i].Address) {
+      I2C_Devices[i].Address = Address;
+      return &I2C_Devices[i];
+    }
   }
-  Wire.requestFrom(Driver_addr, Length);
-  for (int i = 0; i < Length; i++) {
-    *Reg_data++ = Wire.read();
+  return NULL;                                                // Not counted, the table is full
+}
+
+static esp_err_t I2C_Error(uint8_t Result)                    // Wire.endTransmission() result
+{
+  switch (Result) {
+    case 0:   return ESP_OK;
+    case 1:   return ESP_ERR_INVALID_SIZE;                    // More than the Wire buffer
+    case 2:   return ESP_ERR_NOT_FOUND;                       // Address NACK
+    case 5:   return ESP_ERR_TIMEOUT;
+    default:  return ESP_FAIL;                                // Data NACK or bus error
   }
-  return 0;
 }
-bool I2C_Write(uint8_t Driver_addr, uint8_t Reg_addr, const uint8_t *Reg_data, uint32_t Length)
+
+// A slave that was reset in the middle of a read can hold SDA low forever. Up to nine SCL pulses let it shift out
+// the rest of the byte, a STOP then returns the bus to idle.
+static void I2C_Bus_Recover(void)
 {
-  Wire.beginTransmission(Driver_addr);
-  Wire.write(Reg_addr);       
-  for (int i = 0; i < Length; i++) {
-    Wire.write(*Reg_data++);
+  I2C_Recoveries++;
+  Wire.end();
+  pinMode(I2C_SDA_PIN, INPUT_PULLUP);
+  pinMode(I2C_SCL_PIN, OUTPUT_OPEN_DRAIN);
+  digitalWrite(I2C_SCL_PIN, HIGH);
+  delayMicroseconds(5);
+  for (int i = 0; i < 9 && digitalRead(I2C_SDA_PIN) == LOW; i++) {
+    digitalWrite(I2C_SCL_PIN, LOW);
+    delayMicroseconds(5);
+    digitalWrite(I2C_SCL_PIN, HIGH);
+    delayMicroseconds(5);
   }
-  if ( Wire.endTransmission(true))
-  {
-    printf("The I2C transmission fails. - I2C Write\r\n");
-    return -1;
+  pinMode(I2C_SDA_PIN, OUTPUT_OPEN_DRAIN);                    // STOP : SDA rises while SCL is high
+  digitalWrite(I2C_SDA_PIN, LOW);
+  delayMicroseconds(5);
+  digitalWrite(I2C_SDA_PIN, HIGH);
+  delayMicroseconds(5);
+  if (digitalRead(I2C_SDA_PIN) == LOW)
+    printf("I2C_Bus_Recover(function): SDA is still held low!!!!\r\n");
+  Wire.begin(I2C_SDA_PIN, I2C_SCL_PIN, I2C_Clock);
+  Wire.setTimeOut(I2C_Timeout_MS);
+}
+
+static esp_err_t I2C_Transfer(uint8_t Driver_addr, uint8_t Reg_addr, const uint8_t *Write_data, uint8_t *Read_data, uint32_t Length)
+{
+  if (!I2C_Lock())
+    return ESP_ERR_TIMEOUT;
+  esp_err_t Result = ESP_FAIL;
+  for (int Attempt = 0; Attempt < 2; Attempt++) {
+    Wire.beginTransmission(Driver_addr);
+    Wire.write(Reg_addr);
+    if (Write_data)
+      Wire.write(Write_data, Length);
+    Result = I2C_Error(Wire.endTransmission(Write_data != NULL));   // Reads continue with a repeated start
+    if (Result == ESP_OK && Read_data) {
+      if (Wire.requestFrom(Driver_addr, (size_t)Length, true) != Length)
+        Result = ESP_ERR_INVALID_RESPONSE;
+      else {
+        for (uint32_t i = 0; i < Length; i++) {
+          Read_data[i] = Wire.read();
+        }
+      }
+    }
+    if (Result == ESP_OK || Result == ESP_ERR_NOT_FOUND || Result == ESP_ERR_INVALID_SIZE)
+      break;                                                  // Done, or the device is absent : no retry
+    if (Attempt == 0 && (Result == ESP_ERR_TIMEOUT || digitalRead(I2C_SDA_PIN) == LOW))
+      I2C_Bus_Recover();                                      // SDA stuck, otherwise the retry alone
+  }
+  I2C_Device_Stats *Device = I2C_Device(Driver_addr);
+  if (Device) {
+    Device->Transactions++;
+    if (Result != ESP_OK) {
+      Device->Errors++;
+      Device->Last_Error = Result;
+    }
+  }
+  I2C_Unlock();
+  return Result;
+}
+
+esp_err_t I2C_Read(uint8_t Driver_addr, uint8_t Reg_addr, uint8_t *Reg_data, uint32_t Length)
+{
+  esp_err_t Result = I2C_Transfer(Driver_addr, Reg_addr, NULL, Reg_data, Length);
+  if (Result != ESP_OK)
+    printf("The I2C transmission fails. - I2C Read 0x%02X : %s\r\n", Driver_addr, esp_err_to_name(Result));
+  return Result;
+}
+esp_err_t I2C_Write(uint8_t Driver_addr, uint8_t Reg_addr, const uint8_t *Reg_data, uint32_t Length)
+{
+  esp_err_t Result = I2C_Transfer(Driver_addr, Reg_addr, Reg_data, NULL, Length);
+  if (Result != ESP_OK)
+    printf("The I2C transmission fails. - I2C Write 0x%02X : %s\r\n", Driver_addr, esp_err_to_name(Result));
+  return Result;
+}
+
+void I2C_Print_Stats(void)
+{
+  I2C_Device_Stats Devices[I2C_Device_MAX];
+  uint32_t Recoveries = 0;
+  if (I2C_Lock()) {
+    memcpy(Devices, I2C_Devices, sizeof(Devices));
+    Recoveries = I2C_Recoveries;
+    I2C_Unlock();
+  }
+  else
+    memset(Devices, 0, sizeof(Devices));
+  printf("I2C : %lu Hz, %lu bus recoveries\r\n", (unsigned long)I2C_Clock, (unsigned long)Recoveries);
+  printf("Addr  Transactions  Errors  Last error\r\n");
+  for (int i = 0; i < I2C_Device_MAX && Devices[i].Address; i++) {
+    printf("0x%02X  %-12lu  %-6lu  %s\r\n", Devices[i].Address, (unsigned long)Devices[i].Transactions, (unsigned long)Devices[i].Errors,
+           Devices[i].Errors ? esp_err_to_name(Devices[i].Last_Error) : "-");
   }
-  return 0;
-}
\ No newline at end of file
+}
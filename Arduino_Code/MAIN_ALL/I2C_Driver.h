@@ -1,10 +1,27 @@
 #pragma once
 #include <Wire.h> 
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 
 #define I2C_SCL_PIN       41
 #define I2C_SDA_PIN       42
 
+/*************************************************************  I2C bus service  *************************************************************/
+// Every transaction of the TCA9554 (relays) and the PCF85063 (RTC) goes through I2C_Read() / I2C_Write(), which hold a
+// recursive bus mutex for the whole register write + read. A sequence that must not be split (read-modify-write) takes
+// I2C_Lock() around it. A timeout or bus error clocks SCL until a stuck slave releases SDA, then the transaction is retried once.
+#define I2C_Clock_Hz          400000    // Fast mode, the limit of both the TCA9554 and the PCF85063 (unit: Hz)
+#define I2C_Timeout_MS        20        // Wire transaction timeout (unit: ms)
+#define I2C_Lock_Timeout_MS   100       // Longest wait for the bus mutex before a transaction fails (unit: ms)
+#define I2C_Device_MAX        4         // Addresses with their own counters, see I2C_Print_Stats()
+
 void I2C_Init(void);
 
-bool I2C_Read(uint8_t Driver_addr, uint8_t Reg_addr, uint8_t *Reg_data, uint32_t Length);
-bool I2C_Write(uint8_t Driver_addr, uint8_t Reg_addr, const uint8_t *Reg_data, uint32_t Length);
\ No newline at end of file
+esp_err_t I2C_Read(uint8_t Driver_addr, uint8_t Reg_addr, uint8_t *Reg_data, uint32_t Length);         // ESP_OK, ESP_ERR_NOT_FOUND (address NACK), ESP_ERR_TIMEOUT, ESP_FAIL
+esp_err_t I2C_Write(uint8_t Driver_addr, uint8_t Reg_addr, const uint8_t *Reg_data, uint32_t Length);
+bool I2C_Lock(void);                      // Recursive, false : the bus was not free within I2C_Lock_Timeout_MS
+void I2C_Unlock(void);
+bool I2C_Set_Clock(uint32_t Hz);          // Also used again after a bus recovery
+uint32_t I2C_Get_Clock(void);
+void I2C_Print_Stats(void);               // Clock, bus recoveries, transactions and errors per device
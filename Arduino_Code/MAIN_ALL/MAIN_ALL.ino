@@ -6,15 +6,26 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 
-#include "I2C_Driver.h"           // I2C_Init()
+#include "I2C_Driver.h"           // I2C_Init(), I2C_Print_Stats()
 
 #include "WS_GPIO.h"              // GPIO_Init(), Relay_Init(), RGB_Light()
 #include "WS_RTC.h"               // RTC_Init()
 #include "WS_ETH.h"               // ETH_Init(), ETH.macAddress()
 #include "WS_Bluetooth.h"         // Bluetooth_Init()
+#include "WS_WIFI.h"              // Web_Init()
+#include "WS_Log.h"               // Log_Init()
+#include "WS_Pool.h"              // Pool_Print_Stats()
+#include "WS_Tasks.h"             // Task_Print_Stats()
+#include "WS_Console.h"           // Console_Init()
+#include "WS_Bench.h"             // Bench_Init()
+#include "WS_Relay_Store.h"       // Relay_Store_Writes()
+#include "WS_SD_Log.h"            // SD_Log_Init()
 
 #include "common.h"
 
+#define Boot_LED_Blue_MS    2000    // Blue LED after boot, then green blinking (unit: ms)
+static uint32_t Boot_LED_Start = 0;
+
 
 
 
@@ -24,6 +35,19 @@ void printHeapStats()
     Serial.printf("Free heap: %u\n", heap_caps_get_free_size(MALLOC_CAP_8BIT));
     Serial.printf("Largest free block: %u bytes\n", heap_caps_get_largest_free_block(MALLOC_CAP_8BIT));
     Serial.printf("Min ever free heap: %u\n", ESP.getMinFreeHeap());
+    Serial.printf("BLE command queue peak: %u of %u, dropped: %lu\n", BLE_Cmd_Queue_Peak(), BLE_Cmd_Pool_Size, (unsigned long)BLE_Cmd_Dropped());
+    Serial.printf("Relay state NVS writes: %lu\n", (unsigned long)Relay_Store_Writes());
+    Serial.printf("SD log records dropped: %lu\n", (unsigned long)SD_Log_Dropped());
+    Pool_Print_Stats();
+}
+
+static void Console_Heap(const char *Args)
+{
+  printHeapStats();
+}
+static void Console_I2C(const char *Args)
+{
+  I2C_Print_Stats();
 }
 
 static const char* ResetReasonHuman(esp_reset_reason_t r)
@@ -50,32 +74,62 @@ static const char* ResetReasonHuman(esp_reset_reason_t r)
   }
 }
 
+void printEthMAC() 
+{
+   uint8_t mac[6];
+   ETH.macAddress(mac);
+   Serial.printf("ETH MAC: %02X:%02X:%02X:%02X:%02X:%02X\n", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+}
+
+// The radio and network stacks take seconds to come up, the relays must not wait for them.
+// ETH / web server and BLE start in parallel in their own tasks, commands from DIN, RTC and the console work meanwhile.
+static void BootNetworkTask(void *parameter)
+{
+  Serial.printf("INIT ETH\n");
+  ETH_Init();                     // SNTP starts once ETH has an address
+  printEthMAC();
+
+  Serial.printf("INIT WEB\n");
+  Web_Init();
+  Serial.printf("NETWORK UP AT %lu ms\n", (unsigned long)millis());
+  Task_Finish(Task_Boot_Network);
+}
+static void BootBLETask(void *parameter)
+{
+  Serial.printf("INIT BLUETOOTH\n");
+  Bluetooth_Init();
+  Serial.printf("BLUETOOTH UP AT %lu ms\n", (unsigned long)millis());
+  Task_Finish(Task_Boot_BLE);
+}
+
 void RunInits()
 {
+  Serial.printf("INIT LOG\n");
+  Log_Init();                     // Deferred log output, WS_LOG() only queues before this
+
+  Console_Init();
+  Console_Add_Command("heap", Console_Heap, "free heap, largest block and queue peaks");
+  Console_Add_Command("i2c", Console_I2C, "bus clock, recoveries and transactions per device");
+  Bench_Init();                   // "bench" console command, Bench_Enable 0 leaves it out
+
   Serial.printf("INIT GPIO\n");
   GPIO_Init();
 
   Serial.printf("INIT I2C\n");
-  I2C_Init();
+  I2C_Init();                     // 400 kHz, bus mutex
+
+  Serial.printf("INIT RELAY\n");
+  Relay_Init();                   // Right after the bus : the last relay state is kept and RelayTask accepts commands
+  Serial.printf("RELAY READY AT %lu ms\n", (unsigned long)millis());
 
   Serial.printf("INIT RTC\n");
   RTC_Init();
 
-  Serial.printf("INIT ETH\n");
-  ETH_Init();
+  Serial.printf("INIT SD LOG\n");
+  SD_Log_Init();                  // Boot record now, SDLogTask mounts the card in the background
 
-  Serial.printf("INIT RELAY\n");
-  Relay_Init();
-
-  Serial.printf("INIT BLUETOOTH\n");
-  Bluetooth_Init();
-}
-
-void printEthMAC() 
-{
-   uint8_t mac[6];
-   ETH.macAddress(mac);
-   Serial.printf("ETH MAC: %02X:%02X:%02X:%02X:%02X:%02X\n", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+  Task_Start(Task_Boot_Network, BootNetworkTask);
+  Task_Start(Task_Boot_BLE, BootBLETask);
 }
 
 void printFreeRTOSInfo()
@@ -133,24 +187,23 @@ void setup()
   // !! SB CDC On Boot needs to be enabled  to see ppriting statements !!
 
   // ---- Serial: safe order, no early calls ----
-  Serial.begin(115200);
-  delay(3000);   // give USB CDC time, but do not depend on it
+  Serial.begin(115200);             // No delay : boot output before the host opened the USB CDC port is lost, the relays do not wait for it
 
    esp_reset_reason_t rr = esp_reset_reason();
   Serial.printf("RESET CAUSE: %s (code=%d)\n", ResetReasonHuman(rr), (int)rr);
 
   RunInits();
-  Buzzer_Open_Time(500, 0);
- 
+  Buzzer_Open_Time(500, 0);       // Queued, IndicatorTask plays it
+
   Serial.printf("Setting LED to blue\n");
-  RGB_Light(0, 0, 255);   // stays blue
-  delay(2000);   // 2 seconds of blue you can actually see
+  RGB_Light(0, 0, 255);           // Stays blue for Boot_LED_Blue_MS, loop() does the waiting instead of delay(2000)
+  Boot_LED_Start = millis();
 
   Serial.printf("INITIAL BOOT OK!\n");
 
   printFreeRTOSInfo();
-  printEthMAC();
   printHeapStats();
+  Task_Print_Stats();
 
   Serial.printf("FINAL BOOT OK!\n");
   Serial.printf("Setting LED to blinking green\n");
@@ -166,6 +219,8 @@ void loop()
   static bool on = false;
 
   uint32_t now = millis();
+  if (now - Boot_LED_Start < Boot_LED_Blue_MS)
+    return;
   if (now - last >= 500)
   {
     last = now;
@@ -0,0 +1,142 @@
+#include "WS_Auth.h"
+#include <Arduino.h>
+
+static mbedtls_sha256_context Auth_Inner;           // After the ipad block, read only once Auth_Init() returned
+static mbedtls_sha256_context Auth_Outer;           // After the opad block
+static bool Auth_Ready = false;
+
+typedef struct {
+  uint32_t Epoch;
+  uint32_t Tag;                                     // v1 : channel, v2 : version and sequence
+  bool Used;
+  uint8_t MAC[4];                                   // Prefix is enough, the MAC is a function of the signed bytes
+} Auth_Replay_Entry;
+static Auth_Replay_Entry Auth_Replay_Cache[Auth_Replay_Cache_Size];
+static portMUX_TYPE Auth_Replay_Lock = portMUX_INITIALIZER_UNLOCKED;
+
+bool Auth_Init(const uint8_t *Key, size_t Key_Length)
+{
+  uint8_t Block[64] = {0};
+  uint8_t Pad[64];
+  if (Key_Length > sizeof(Block))
+    mbedtls_sha256(Key, Key_Length, Block, 0);      // RFC 2104 : longer keys are hashed first
+  else
+    memcpy(Block, Key, Key_Length);
+
+  mbedtls_sha256_init(&Auth_Inner);
+  mbedtls_sha256_init(&Auth_Outer);
+  for (int i = 0; i < 64; i++) {
+    Pad[i] = Block[i] ^ 0x36;
+  }
+  bool Ok = mbedtls_sha256_starts(&Auth_Inner, 0) == 0 && mbedtls_sha256_update(&Auth_Inner, Pad, sizeof(Pad)) == 0;
+  for (int i = 0; i < 64; i++) {
+    Pad[i] = Block[i] ^ 0x5C;
+  }
+  Ok = Ok && mbedtls_sha256_starts(&Auth_Outer, 0) == 0 && mbedtls_sha256_update(&Auth_Outer, Pad, sizeof(Pad)) == 0;
+  memset(Block, 0, sizeof(Block));
+  memset(Pad, 0, sizeof(Pad));
+  if (!Ok) {
+    printf("Auth_Init(function): SHA-256 failed!!!!\r\n");
+    return false;
+  }
+  Auth_Ready = true;
+  printf("Auth : HMAC key prepared, SHA-256 %s\r\n", Auth_Hardware_SHA ? "hardware accelerated" : "in software");
+  return true;
+}
+
+bool Auth_Is_Ready(void)
+{
+  return Auth_Ready;
+}
+
+void Auth_HMAC(const uint8_t *Message, size_t Length, uint8_t *MAC)
+{
+  uint8_t Inner_Hash[32];
+  mbedtls_sha256_context Work;
+  mbedtls_sha256_init(&Work);
+  mbedtls_sha256_clone(&Work, &Auth_Inner);
+  mbedtls_sha256_update(&Work, Message, Length);
+  mbedtls_sha256_finish(&Work, Inner_Hash);
+  mbedtls_sha256_clone(&Work, &Auth_Outer);
+  mbedtls_sha256_update(&Work, Inner_Hash, sizeof(Inner_Hash));
+  mbedtls_sha256_finish(&Work, MAC);
+  mbedtls_sha256_free(&Work);
+}
+
+bool Auth_Equal(const uint8_t *A, const uint8_t *B, size_t Length)
+{
+  volatile uint8_t Diff = 0;                        // Every byte is compared, the time does not depend on where they differ
+  for (size_t i = 0; i < Length; i++) {
+    Diff |= A[i] ^ B[i];
+  }
+  return Diff == 0;
+}
+
+// Remembers an accepted command, false if it was accepted before
+static bool Auth_Replay_Insert(uint32_t Tag, uint32_t Epoch, const uint8_t *MAC, uint32_t Now)
+{
+  bool Fresh = true;
+  int Free = -1, Oldest = 0;
+  portENTER_CRITICAL(&Auth_Replay_Lock);
+  for (int i = 0; i < Auth_Replay_Cache_Size; i++) {
+    Auth_Replay_Entry *Entry = &Auth_Replay_Cache[i];
+    uint32_t Age = Now > Entry->Epoch ? Now - Entry->Epoch : Entry->Epoch - Now;
+    if (Entry->Used && Age > Auth_Window_S)
+      Entry->Used = false;                          // Outside the window, Auth_Expired rejects it anyway
+    if (!Entry->Used) {
+      if (Free < 0)
+        Free = i;
+      continue;
+    }
+    if (Entry->Tag == Tag && Entry->Epoch == Epoch && !memcmp(Entry->MAC, MAC, sizeof(Entry->MAC))) {
+      Fresh = false;
+      break;
+    }
+    if (Entry->Epoch < Auth_Replay_Cache[Oldest].Epoch || !Auth_Replay_Cache[Oldest].Used)
+      Oldest = i;
+  }
+  if (Fresh) {
+    int Slot = Free >= 0 ? Free : Oldest;           // Full : the oldest command is forgotten first
+    Auth_Replay_Entry *Entry = &Auth_Replay_Cache[Slot];
+    Entry->Epoch = Epoch;
+    Entry->Tag = Tag;
+    memcpy(Entry->MAC, MAC, sizeof(Entry->MAC));
+    Entry->Used = true;
+  }
+  portEXIT_CRITICAL(&Auth_Replay_Lock);
+  return Fresh;
+}
+
+Auth_Result Auth_Verify(const uint8_t *Message, size_t Length, uint32_t Epoch, const uint8_t *MAC, uint32_t Now, uint32_t Tag)
+{
+  if (!Auth_Ready)
+    return Auth_Not_Ready;
+  uint32_t Diff = (Now > Epoch) ? (Now - Epoch) : (Epoch - Now);
+  if (Diff > Auth_Window_S)
+    return Auth_Expired;
+
+  uint8_t Full_MAC[32];
+  Auth_HMAC(Message, Length, Full_MAC);
+  if (!Auth_Equal(Full_MAC, MAC, Auth_MAC_Length))
+    return Auth_Bad_MAC;
+  if (!Auth_Replay_Insert(Tag, Epoch, MAC, Now))
+    return Auth_Replay;
+  return Auth_OK;
+}
+Auth_Result Auth_Check(uint8_t Channel, uint32_t Epoch, const uint8_t *MAC, uint32_t Now)
+{
+  uint8_t Message[5] = {Channel, (uint8_t)(Epoch >> 24), (uint8_t)(Epoch >> 16), (uint8_t)(Epoch >> 8), (uint8_t)Epoch};
+  return Auth_Verify(Message, sizeof(Message), Epoch, MAC, Now, Channel);
+}
+
+const char *Auth_Result_Name(Auth_Result Result)
+{
+  switch (Result) {
+    case Auth_OK:           return "OK";
+    case Auth_Not_Ready:    return "key not prepared";
+    case Auth_Expired:      return "epoch outside the window";
+    case Auth_Bad_MAC:      return "HMAC mismatch";
+    case Auth_Replay:       return "replayed command";
+    default:                return "unknown";
+  }
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "sdkconfig.h"
+#include "mbedtls/sha256.h"
+
+/*************************************************************  Authenticated commands  *************************************************************/
+// v1 : HMAC-SHA256 over [Channel, Epoch (big endian)] with the shared secret, the first Auth_MAC_Length bytes are sent.
+// v2 : HMAC-SHA256 over the first Auth_V2_Signed bytes of the batch frame below.
+// The ipad / opad states of the key are hashed once in Auth_Init(), a command costs two SHA-256 blocks instead of four.
+// Example : key "key-fsa-relay", channel 1, epoch 1739956784 (0x67B5A230)
+//           message 01 67 B5 A2 30  ->  MAC 9D B5 AC AD 53 6B 7A 15 B5 3C 39 22
+#define Auth_MAC_Length           12      // Truncated HMAC of a command
+#define Auth_Window_S             120     // Accepted difference between the command epoch and the system UTC (unit: s)
+#define Auth_Replay_Cache_Size    32      // Accepted commands remembered inside the window, the oldest one is evicted first
+
+// v2 batch frame, 21 bytes (42 as ASCII hex) :
+//   [0] Auth_V2_Version   [1] Set mask   [2] Clear mask   [3..4] Sequence   [5..8] Epoch   [9..20] MAC
+//   Masks : bit0 = CH1, every channel in one relay batch. Sequence and epoch big endian, the sequence tells
+//   commands of the same second apart. A channel must not be in both masks.
+#define Auth_V2_Version           0x02
+#define Auth_V2_Length            21
+#define Auth_V2_Signed            9       // Bytes covered by the MAC
+
+#if CONFIG_MBEDTLS_HARDWARE_SHA
+  #define Auth_Hardware_SHA       1       // mbedtls SHA-256 runs on the ESP32-S3 SHA accelerator
+#else
+  #define Auth_Hardware_SHA       0
+  #warning "CONFIG_MBEDTLS_HARDWARE_SHA is off, the BLE command HMAC runs in software"
+#endif
+
+typedef enum {
+  Auth_OK = 0,
+  Auth_Not_Ready,             // Auth_Init() was not called
+  Auth_Expired,               // Epoch outside +- Auth_Window_S
+  Auth_Bad_MAC,
+  Auth_Replay,                // Same command accepted before inside the window
+} Auth_Result;
+
+bool Auth_Init(const uint8_t *Key, size_t Key_Length);
+bool Auth_Is_Ready(void);                                                          // Auth_Init() succeeded
+void Auth_HMAC(const uint8_t *Message, size_t Length, uint8_t *MAC);              // Full 32 byte HMAC-SHA256 with the precomputed key
+bool Auth_Equal(const uint8_t *A, const uint8_t *B, size_t Length);               // Constant time
+Auth_Result Auth_Verify(const uint8_t *Message, size_t Length, uint32_t Epoch, const uint8_t *MAC, uint32_t Now, uint32_t Tag);   // Window, MAC and replay cache of (Tag, Epoch, MAC)
+Auth_Result Auth_Check(uint8_t Channel, uint32_t Epoch, const uint8_t *MAC, uint32_t Now);   // v1 command, an accepted command is remembered
+const char *Auth_Result_Name(Auth_Result Result);
@@ -0,0 +1,261 @@
+#include "WS_Bench.h"
+#include "WS_Console.h"
+
+#if Bench_Enable
+
+#include "WS_Relay.h"
+#include "WS_Auth.h"
+#include "WS_MQTT.h"
+#include "WS_Modbus.h"
+#include "WS_RTC.h"
+
+typedef bool (*Bench_Op)(void *Arg, uint32_t Iteration);   // false : the operation failed
+
+typedef struct {
+  const char *Name;
+  uint32_t Clock;                         // I2C clock of the run, 0 : not an I2C benchmark
+  uint32_t Count;
+  uint32_t Failures;
+  uint32_t Min;
+  uint32_t Max;
+  uint64_t Sum;
+  uint64_t Elapsed;                       // Whole run, includes the timing overhead (unit: us)
+} Bench_Result;
+
+static void Bench_Start(Bench_Result *Result, const char *Name, uint32_t Clock)
+{
+  memset(Result, 0, sizeof(*Result));
+  Result->Name = Name;
+  Result->Clock = Clock;
+  Result->Min = UINT32_MAX;
+}
+static void Bench_Add(Bench_Result *Result, uint32_t Iterations, Bench_Op Op, void *Arg)   // Further iterations of a started result
+{
+  int64_t Start = esp_timer_get_time();
+  for (uint32_t i = 0; i < Iterations; i++) {
+    int64_t Begin = esp_timer_get_time();
+    bool Ok = Op(Arg, Result->Count);
+    uint32_t Time = (uint32_t)(esp_timer_get_time() - Begin);
+    Result->Count++;
+    Result->Sum += Time;
+    if (!Ok)
+      Result->Failures++;
+    if (Time < Result->Min)
+      Result->Min = Time;
+    if (Time > Result->Max)
+      Result->Max = Time;
+  }
+  Result->Elapsed += esp_timer_get_time() - Start;
+}
+static void Bench_Run(Bench_Result *Result, const char *Name, uint32_t Clock, uint32_t Iterations, Bench_Op Op, void *Arg)
+{
+  Bench_Start(Result, Name, Clock);
+  Bench_Add(Result, Iterations, Op, Arg);
+}
+static void Bench_Print(const Bench_Result *Result)
+{
+  if (!Result->Count)
+    return;
+  double Ops = Result->Elapsed ? Result->Count * 1000000.0 / Result->Elapsed : 0;
+  printf("{\"bench\":\"%s\",\"clock\":%lu,\"n\":%lu,\"ops_s\":%.0f,\"min_us\":%lu,\"avg_us\":%.1f,\"max_us\":%lu,\"fail\":%lu}\r\n",
+         Result->Name, (unsigned long)Result->Clock, (unsigned long)Result->Count, Ops, (unsigned long)Result->Min,
+         (double)Result->Sum / Result->Count, (unsigned long)Result->Max, (unsigned long)Result->Failures);
+}
+static void Bench_Skip(const char *Name, const char *Reason)
+{
+  printf("{\"bench\":\"%s\",\"skipped\":\"%s\"}\r\n", Name, Reason);
+}
+
+/********************************************************  TCA9554  ********************************************************/
+static const uint32_t Bench_Clocks[] = Bench_I2C_Clocks;
+#define Bench_Clock_Count     (sizeof(Bench_Clocks) / sizeof(Bench_Clocks[0]))
+
+typedef struct {
+  Bench_Result *Result;
+  Bench_Op Op;
+  uint32_t Clock;
+  uint32_t Iterations;                    // Of this chunk
+} Bench_EXIO_Job;
+
+static bool Bench_EXIOS_Op(void *Arg, uint32_t Iteration)
+{
+  return Set_EXIOS(Read_EXIOS_Shadow());                    // Same state again : a full write, no relay moves
+}
+static bool Bench_EXIO_Op(void *Arg, uint32_t Iteration)
+{
+  return Set_EXIO(EXIO_PIN1, Read_EXIOS_Shadow() & 0x01);
+}
+static bool Bench_EXIO_Read_Op(void *Arg, uint32_t Iteration)
+{
+  return TCA9554PWR_Resync();                               // Register read back
+}
+static void Bench_EXIO_Run(void *Arg)                       // One chunk in RelayTask, with the bus locked
+{
+  Bench_EXIO_Job *Job = (Bench_EXIO_Job *)Arg;
+  if (!I2C_Lock()) {                                        // The RTC waits, it must not run at a bench clock
+    Job->Result->Failures += Job->Iterations;
+    return;
+  }
+  uint32_t Clock = I2C_Get_Clock();
+  I2C_Set_Clock(Job->Clock);
+  Bench_Add(Job->Result, Job->Iterations, Job->Op, NULL);
+  I2C_Set_Clock(Clock);
+  I2C_Unlock();
+}
+// Bench_EXIO_Chunk operations per Relay_Run_Job(), RelayTask executes the queued commands between two chunks
+static void Bench_EXIO(uint32_t Iterations)
+{
+  static const struct {
+    const char *Name;
+    Bench_Op Op;
+  } Ops[] = {{"exios", Bench_EXIOS_Op}, {"exio", Bench_EXIO_Op}, {"exio_read", Bench_EXIO_Read_Op}};
+  Bench_Result Result;
+  Bench_EXIO_Job Job;
+  for (size_t i = 0; i < Bench_Clock_Count; i++) {
+    for (size_t j = 0; j < sizeof(Ops) / sizeof(Ops[0]); j++) {
+      Bench_Start(&Result, Ops[j].Name, Bench_Clocks[i]);
+      Job.Result = &Result;
+      Job.Op = Ops[j].Op;
+      Job.Clock = Bench_Clocks[i];
+      for (uint32_t Done = 0; Done < Iterations; Done += Job.Iterations) {
+        Job.Iterations = Iterations - Done < Bench_EXIO_Chunk ? Iterations - Done : Bench_EXIO_Chunk;
+        if (!Relay_Run_Job(Bench_EXIO_Run, &Job)) {
+          Bench_Skip("exio", "RelayTask not running");
+          return;
+        }
+      }
+      Bench_Print(&Result);
+    }
+  }
+}
+
+/********************************************************  HMAC  ********************************************************/
+typedef struct {
+  const uint8_t *Message;
+  size_t Length;
+  uint8_t MAC[32];
+} Bench_HMAC_Arg;
+
+static bool Bench_HMAC_Op(void *Arg, uint32_t Iteration)    // What Auth_Verify() does per command, without window and replay cache
+{
+  Bench_HMAC_Arg *H = (Bench_HMAC_Arg *)Arg;
+  uint8_t MAC[32];
+  Auth_HMAC(H->Message, H->Length, MAC);
+  return Auth_Equal(MAC, H->MAC, Auth_MAC_Length);
+}
+static void Bench_HMAC(uint32_t Iterations)
+{
+  static const uint8_t V1[5] = {0x01, 0x67, 0xB5, 0xA2, 0x30};
+  static const uint8_t V2[Auth_V2_Signed] = {Auth_V2_Version, 0x0F, 0xF0, 0x00, 0x01, 0x67, 0xB5, 0xA2, 0x30};
+  Bench_Result Result;
+  Bench_HMAC_Arg Arg;
+  if (!Auth_Is_Ready()) {
+    Bench_Skip("hmac", "key not prepared");
+    return;
+  }
+  Arg.Message = V1;
+  Arg.Length = sizeof(V1);
+  Auth_HMAC(V1, sizeof(V1), Arg.MAC);
+  Bench_Run(&Result, "hmac_v1", 0, Iterations, Bench_HMAC_Op, &Arg);
+  Bench_Print(&Result);
+  Arg.Message = V2;
+  Arg.Length = sizeof(V2);
+  Auth_HMAC(V2, sizeof(V2), Arg.MAC);
+  Bench_Run(&Result, "hmac_v2", 0, Iterations, Bench_HMAC_Op, &Arg);
+  Bench_Print(&Result);
+}
+
+/********************************************************  MQTT  ********************************************************/
+static bool Bench_MQTT_Parse_Op(void *Arg, uint32_t Iteration)
+{
+  const char *Payload = (const char *)Arg;
+  Relay_Mask_t Open, Closs;
+  uint32_t Trace;
+  return MQTT_Parse_Command((const byte *)Payload, strlen(Payload), &Open, &Closs, &Trace);
+}
+static bool Bench_MQTT_Serialize_Op(void *Arg, uint32_t Iteration)
+{
+  char Text[MSG_BUFFER_SIZE];                               // Not msg[], MQTTTask may be publishing from it
+  return MQTT_Serialize_State(Text, sizeof(Text), (Relay_Mask_t)Iteration, Relay_Channels.All, (uint8_t)Iteration, 0xFF) > 0;
+}
+static void Bench_MQTT(uint32_t Iterations)
+{
+  static char Payload[] = "{\"data\":{\"CH1\":1,\"CH3\":0,\"CH8\":1,\"ALL\":0}}";
+  Bench_Result Result;
+  Bench_Run(&Result, "mqtt_parse", 0, Iterations, Bench_MQTT_Parse_Op, Payload);
+  Bench_Print(&Result);
+  Bench_Run(&Result, "mqtt_serialize", 0, Iterations, Bench_MQTT_Serialize_Op, NULL);
+  Bench_Print(&Result);
+}
+
+/********************************************************  Modbus  ********************************************************/
+static bool Bench_Modbus_Op(void *Arg, uint32_t Iteration)  // CRC check and the lookup of the legacy frames, as RS485Task does
+{
+  const uint8_t *Frame = (const uint8_t *)Arg;
+  return Modbus_CRC_Valid(Frame, Modbus_Frame_Length) && Relay_Channels.Find_RS485_Frame(Frame) >= 0;
+}
+static void Bench_Modbus(uint32_t Iterations)
+{
+  static uint8_t Frame[Modbus_Frame_Length];
+  Bench_Result Result;
+  memcpy(Frame, Relay_Channels.CH[Relay_Number_MAX - 1].RS485_Frame.Byte, sizeof(Frame));   // Last channel : the longest lookup
+  Bench_Run(&Result, "modbus_frame", 0, Iterations, Bench_Modbus_Op, Frame);
+  Bench_Print(&Result);
+}
+
+/********************************************************  RTC  ********************************************************/
+static bool Bench_RTC_Op(void *Arg, uint32_t Iteration)
+{
+  const Timing_RTC *Events = (const Timing_RTC *)Arg;
+  const Timing_RTC *Event = &Events[Iteration % 4];
+  return TimerEvent_Next_Fire(Event, Time_System_Valid_Epoch + Iteration * 3671) || Event->repetition_State == Repetition_NONE;
+}
+static void Bench_RTC(uint32_t Iterations)
+{
+  static Timing_RTC Events[4];                              // One event of every repetition, not part of the schedule
+  datetime_t Time = {2021, 1, 31, 0, 12, 30, 15};           // Sunday 12:30:15
+  for (int i = 0; i < 4; i++) {
+    Events[i].Enable_Flag = true;
+    Events[i].Time = Time;
+    Events[i].repetition_State = (Repetition_event)i;
+  }
+  Bench_Result Result;
+  Bench_Run(&Result, "rtc_next_fire", 0, Iterations, Bench_RTC_Op, Events);
+  Bench_Print(&Result);
+}
+
+/********************************************************  Console  ********************************************************/
+static void Console_Bench(const char *Args)
+{
+  char Name[16] = "all";
+  unsigned long Iterations = Bench_Iterations;
+  sscanf(Args, "%15s %lu", Name, &Iterations);
+  if (!Iterations || Iterations > Bench_Iterations_MAX) {
+    printf("Note : bench iterations are 1 ~ %d !\r\n", Bench_Iterations_MAX);
+    return;
+  }
+  bool All = !strcmp(Name, "all");
+  bool Found = All;
+  printf("{\"bench\":\"start\",\"n\":%lu,\"cpu_mhz\":%lu}\r\n", Iterations, (unsigned long)getCpuFrequencyMhz());
+  if (All || !strcmp(Name, "exio"))   { Bench_EXIO(Iterations);   Found = true; }
+  if (All || !strcmp(Name, "hmac"))   { Bench_HMAC(Iterations);   Found = true; }
+  if (All || !strcmp(Name, "mqtt"))   { Bench_MQTT(Iterations);   Found = true; }
+  if (All || !strcmp(Name, "modbus")) { Bench_Modbus(Iterations); Found = true; }
+  if (All || !strcmp(Name, "rtc"))    { Bench_RTC(Iterations);    Found = true; }
+  if (!Found)
+    printf("Note : Unknown benchmark %s, try exio hmac mqtt modbus rtc all !\r\n", Name);
+  printf("{\"bench\":\"end\"}\r\n");
+}
+
+void Bench_Init(void)
+{
+  Console_Add_Command("bench", Console_Bench, "[exio|hmac|mqtt|modbus|rtc|all] [iterations], JSON lines");
+}
+
+#else
+
+void Bench_Init(void)
+{
+}
+
+#endif
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <Arduino.h>
+#include <stdint.h>
+
+/*************************************************************  Benchmark  *************************************************************/
+// Serial console command "bench [exio|hmac|mqtt|modbus|rtc|all] [iterations]", results as one JSON object per line :
+//   {"bench":"exios","clock":400000,"n":200,"ops_s":2361,"min_us":412,"avg_us":423.5,"max_us":618,"fail":0}
+// exio : TCA9554 round trips at every Bench_I2C_Clocks rate. They run inside RelayTask (Relay_Run_Job()) in chunks of
+//        Bench_EXIO_Chunk, so relay commands are not held up for the whole benchmark. They write back
+//        the current output state, the relays do not move. The bus clock is restored afterwards.
+// The other benchmarks use copies of the data, no command is executed and no state changes.
+#ifndef Bench_Enable
+  #define Bench_Enable            1       // 0 : the command and its code are left out of the build
+#endif
+#define Bench_Iterations          200     // Default iterations of every benchmark
+#define Bench_Iterations_MAX      100000
+#define Bench_EXIO_Chunk          20      // exio operations per RelayTask job, relay commands run between two chunks
+#define Bench_I2C_Clocks          {100000, 400000}    // Wire clock rates of the exio benchmark (unit: Hz), TCA9554 max 400 kHz
+
+void Bench_Init(void);                    // Registers the console command
@@ -6,6 +6,18 @@
 BLEServer* pServer;                                                             // Used to represent a BLE server
 BLECharacteristic* pTxCharacteristic;
 BLECharacteristic* pRxCharacteristic;
+BLECharacteristic* pStateCharacteristic;
+static BLE2902* pStateCCCD;                                                     // Client subscription of the state characteristic
+static TaskHandle_t BLE_Task_Handle = NULL;
+
+typedef struct {
+  uint8_t Length;
+  uint8_t Data[BLE_Cmd_Payload_MAX];
+} BLE_Cmd_Slot;
+POOL_DEFINE(Pool_BLE, sizeof(BLE_Cmd_Slot), BLE_Cmd_Pool_Size);                // Preallocated, onWrite() never touches the heap
+static QueueHandle_t BLE_Cmd_Queue = NULL;                                      // Slots waiting for BLECmdTask
+static volatile uint8_t BLE_Cmd_Peak = 0;
+static volatile uint32_t BLE_Cmd_Drops = 0;
 
 const uint8_t SECRET_KEY[] = "key-fsa-relay";
 const size_t SECRET_LEN = sizeof(SECRET_KEY) - 1;
@@ -34,17 +46,17 @@ static uint32_t sysUtcSecondsNow()
     return (uint32_t)time(nullptr);
 }
 
-// inLen must be 17 (binary) or 34 (ASCII hex). Output is always 17 bytes in out17
-static bool normalizeAuthPayload(const uint8_t* in, size_t inLen, uint8_t* out17)
+// inLen must be binLen (binary) or 2 * binLen (ASCII hex). Output is always binLen bytes in out
+static bool normalizeAuthPayload(const uint8_t* in, size_t inLen, uint8_t* out, size_t binLen)
 {
   // Case A: raw binary
-  if (inLen == 17) {
-    memcpy(out17, in, 17);
+  if (inLen == binLen) {
+    memcpy(out, in, binLen);
     return true;
   }
 
   // Case B: ASCII hex (UTF-8)
-  if (inLen == 34)
+  if (inLen == binLen * 2)
   {
     auto hexNibble = [](uint8_t c) -> int {
       if (c >= '0' && c <= '9') return c - '0';
@@ -53,11 +65,11 @@ static bool normalizeAuthPayload(const uint8_t* in, size_t inLen, uint8_t* out17
       return -1;
     };
 
-    for (int i = 0; i < 17; i++) {
+    for (size_t i = 0; i < binLen; i++) {
       int hi = hexNibble(in[i * 2]);
       int lo = hexNibble(in[i * 2 + 1]);
       if (hi < 0 || lo < 0) return false;
-      out17[i] = (uint8_t)((hi << 4) | lo);
+      out[i] = (uint8_t)((hi << 4) | lo);
     }
 
     return true;
@@ -72,25 +84,26 @@ static void handleBle2Byte(const uint8_t* b)
 {
   // 2-byte BLE command: [opcode, selector]
   // opcode 0x06 = RS485 bridge command
-  // selector (buf[1]) selects a pre-defined Modbus RTU frame in Send_Data[][]
-  // When Extension_Enable is true, forwards the selected frame over RS485
+  // selector (buf[1]) : low nibble = expansion channel 1..8 (toggle), 9 all on, 10 all off
+  //                     high nibble = expansion board index (0 = first board, as before)
+  // When Extension_Enable is true, the Modbus master builds the frame and sends it over RS485
   // Used to control external (off-board) relay channels only
 
-  Serial.printf("PATH: 2 byte command, Bytes = 0x%02X 0x%02X, Extension_Enable = %s \n", b[0], b[1], Extension_Enable ? "TRUE" : "FALSE");
+  WS_LOG(BLE, LOG_DEBUG, "PATH: 2 byte command, Bytes = 0x%02X 0x%02X, Extension_Enable = %s \n", b[0], b[1], Extension_Enable ? "TRUE" : "FALSE");
 
   if (!Extension_Enable)
   {
-    Serial.printf("REJECT: Extension disabled\n");
+    WS_LOG(BLE, LOG_WARN, "REJECT: Extension disabled\n");
     return;
   }
 
   if (b[0] != 0x06)
   {
-    Serial.printf("REJECT: opcode != 0x06 (got 0x%02X)\n", b[0]);
+    WS_LOG(BLE, LOG_WARN, "REJECT: opcode != 0x06 (got 0x%02X)\n", b[0]);
     return;
   }
 
-  Serial.printf("ACCEPT: RS485 command (selector=0x%02X)\n", b[1]);
+  WS_LOG(BLE, LOG_INFO, "ACCEPT: RS485 command (selector=0x%02X)\n", b[1]);
 
   RS485_Analysis((uint8_t*)b);
 }
@@ -119,38 +132,38 @@ static void handleBleRtc14(const uint8_t* b)
   // [12] Repetition mode
   // [13] 0xFF end
 
-  Serial.printf("PATH: 14 byte RTC event, RTC_Event_Enable = %s\n", RTC_Event_Enable ? "TRUE" : "FALSE");
+  WS_LOG(BLE, LOG_DEBUG, "PATH: 14 byte RTC event, RTC_Event_Enable = %s\n", RTC_Event_Enable ? "TRUE" : "FALSE");
 
   if (!RTC_Event_Enable)
   {
-    Serial.printf("REJECT: RTC events disabled\n");
+    WS_LOG(BLE, LOG_WARN, "REJECT: RTC events disabled\n");
     return;
   }
 
-  Serial.printf("ACCEPT: RTC event packet\n");
+  WS_LOG(BLE, LOG_INFO, "ACCEPT: RTC event packet\n");
 
   BLE_Set_RTC_Event((uint8_t*)b);
 }
 
-static void handleBleAuth17or34(const uint8_t* raw, size_t rawLen, const uint8_t* SECRET_KEY, size_t SECRET_LEN)
+static void handleBleAuth17or34(const uint8_t* raw, size_t rawLen)
 {
   uint8_t bin[17];
 
-  Serial.printf("STACK HWM at entry: %u\n", uxTaskGetStackHighWaterMark(NULL));
+  WS_LOG(BLE, LOG_DEBUG, "STACK HWM at entry: %u\n", uxTaskGetStackHighWaterMark(NULL));
 
-  if (!normalizeAuthPayload(raw, rawLen, bin))
+  if (!normalizeAuthPayload(raw, rawLen, bin, sizeof(bin)))
   {
-    Serial.printf("AUTH FAIL: normalizeAuthPayload failed\n");
+    WS_LOG(BLE, LOG_WARN, "AUTH FAIL: normalizeAuthPayload failed\n");
     return;
   }
 
   if (rawLen == 34)
   {
-    Serial.printf("AUTH: decoded ASCII hex (34) to binary (17) \n");
+    WS_LOG(BLE, LOG_DEBUG, "AUTH: decoded ASCII hex (34) to binary (17) \n");
   }
   else
   {
-    Serial.printf("AUTH: raw binary (17) \n");
+    WS_LOG(BLE, LOG_DEBUG, "AUTH: raw binary (17) \n");
   }
 
   /*
@@ -166,101 +179,92 @@ static void handleBleAuth17or34(const uint8_t* raw, size_t rawLen, const uint8_t
     ((uint32_t)bin[3] << 8)  |
      (uint32_t)bin[4];
 
-  Serial.printf("RX: Byte[0] Channel = %u, Byte[1..4] epoch = %u (0x%02X 0x%02X 0x%02X 0x%02X), Byte[5..16] HMAC = 0x%02X 0x%02X 0x%02X 0x%02X 0x%02X 0x%02X 0x%02X 0x%02X 0x%02X 0x%02X 0x%02X 0x%02X\n", 
+  WS_LOG(BLE, LOG_DEBUG, "RX: Byte[0] Channel = %u, Byte[1..4] epoch = %u (0x%02X 0x%02X 0x%02X 0x%02X)\n",
                 (unsigned)channel, (unsigned)epoch,
-                (unsigned)bin[1], (unsigned)bin[2], (unsigned)bin[3], (unsigned)bin[4],
-                (unsigned)bin[5], (unsigned)bin[6], (unsigned)bin[7], (unsigned)bin[8],
-                (unsigned)bin[9], (unsigned)bin[10], (unsigned)bin[11], (unsigned)bin[12],
-                (unsigned)bin[13], (unsigned)bin[14], (unsigned)bin[15], (unsigned)bin[16]);
+                (unsigned)bin[1], (unsigned)bin[2], (unsigned)bin[3], (unsigned)bin[4]);
+  WS_LOG_HEX(BLE, LOG_DEBUG, "RX: Byte[5..16] HMAC = ", bin + 5, 12);
 
   if (!systemUtcIsValid())
   {
-    Serial.printf("AUTH FAIL: system UTC invalid (still 1970)\n");
+    WS_LOG(BLE, LOG_WARN, "AUTH FAIL: system UTC invalid (still 1970)\n");
     return;
   }
 
   const uint32_t now = sysUtcSecondsNow();
-  const uint32_t diff = (now > epoch) ? (now - epoch) : (epoch - now);
 
-  Serial.printf("System UTC now = %u, Epoch delta = %u sec\n", (unsigned)now, (unsigned)diff);
+  WS_LOG(BLE, LOG_DEBUG, "System UTC now = %u, Epoch = %u\n", (unsigned)now, (unsigned)epoch);
 
-  if (diff > 120)
+  // Window, truncated HMAC (precomputed key, constant time compare) and replay cache in one place
+  const Auth_Result result = Auth_Check(channel, epoch, bin + 5, now);
+  if (result != Auth_OK)
   {
-    Serial.printf("AUTH FAIL: epoch outside plus minus 120 sec\n");
+    WS_LOG(BLE, LOG_WARN, "AUTH FAIL: %s\n", Auth_Result_Name(result));
+    SD_Log_Write(SD_Log_Auth_Failure, Bluetooth_Mode, result, epoch);
     return;
   }
 
-  uint8_t msg[5];
-  msg[0] = channel;
-  memcpy(msg + 1, bin + 1, 4);
+  WS_LOG(BLE, LOG_INFO, "AUTH OK\n");
 
-  Serial.printf("STACK before HMAC: %u\n", (unsigned)uxTaskGetStackHighWaterMark(NULL));
+  uint8_t cmd = (uint8_t)(channel + '0');
 
-  // -------------------------------------------
-  uint8_t fullMac[32];
+  WS_LOG(BLE, LOG_INFO, "Dispatch relay: channel=%u ascii=0x%02X\n", (unsigned)channel, (unsigned)cmd);
 
-  const mbedtls_md_info_t* info = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
+  Relay_Analysis(&cmd, Bluetooth_Mode);
+}
 
-  if (info == nullptr)
+
+static void handleBleAuthBatch21or42(const uint8_t* raw, size_t rawLen)
+{
+  // v2 batch frame (see WS_Auth.h) : set and clear masks for every channel under one HMAC,
+  // a scene switches in one write and one relay batch instead of one packet per channel
+  static_assert(Relay_Number_MAX <= 8, "The v2 BLE frame carries 8 bit channel masks");
+  uint8_t bin[Auth_V2_Length];
+
+  if (!normalizeAuthPayload(raw, rawLen, bin, sizeof(bin)))
+  {
+    WS_LOG(BLE, LOG_WARN, "AUTH FAIL: normalizeAuthPayload failed\n");
+    return;
+  }
+  if (bin[0] != Auth_V2_Version)
   {
-    Serial.printf("AUTH FAIL: SHA256 md_info NULL\n");
+    WS_LOG(BLE, LOG_WARN, "REJECT: unknown frame version 0x%02X\n", bin[0]);
     return;
   }
 
-  int rc = mbedtls_md_hmac(info, SECRET_KEY, SECRET_LEN, msg, sizeof(msg), fullMac);
+  const uint8_t setMask = bin[1];
+  const uint8_t clearMask = bin[2];
+  const uint16_t sequence = ((uint16_t)bin[3] << 8) | bin[4];
+  const uint32_t epoch =
+    ((uint32_t)bin[5] << 24) |
+    ((uint32_t)bin[6] << 16) |
+    ((uint32_t)bin[7] << 8)  |
+     (uint32_t)bin[8];
 
-  Serial.printf("STACK after HMAC: %u\n", (unsigned)uxTaskGetStackHighWaterMark(NULL));
+  WS_LOG(BLE, LOG_DEBUG, "RX v2: set = 0x%02X, clear = 0x%02X, sequence = %u, epoch = %u\n",
+                (unsigned)setMask, (unsigned)clearMask, (unsigned)sequence, (unsigned)epoch);
 
-  if (rc != 0)
+  if (!systemUtcIsValid())
   {
-    Serial.printf("AUTH FAIL: md_hmac rc=%d\n", rc);
-    char errbuf[64];
-    mbedtls_strerror(rc, errbuf, sizeof(errbuf));
-    Serial.printf("AUTH FAIL: md_hmac rc=%d (%s)\n", rc, errbuf);
+    WS_LOG(BLE, LOG_WARN, "AUTH FAIL: system UTC invalid (still 1970)\n");
     return;
   }
 
-  // The HMAC was not successfully computed.
-  // HMAC computed successfully (rc == 0) — does NOT imply authentication is valid
-  // 
-  // Example:
-  //
-  // Given:
-  //   SECRET_KEY = "key-fsa-relay"
-  //   channel = 1
-  //   epoch = 1739990000
-  //   msg = [0x01 0x67 0xB5 0xA2 0x30]
-  //
-  //   Epoch 1739990000 in hex: 0x67B5A230
-  //   So channel with epoch is: 01 67 B5 A2 30
-  //
-  // mbedtls_md_hmac(...) may return rc == 0 and produce:
-  //
-  //   fullMac = 9A 4F 12 7C 55 8D 21 90 AB 44 66 7F ...
-  //
-  // If incoming packet contains:
-  //   01 67 B5 A2 30 AA AA AA AA AA AA AA AA AA AA AA AA
-  //
-  // rc is STILL 0 (HMAC computed successfully),
-  // but memcmp(fullMac, bin+5, 12) will FAIL.
-  //
-  // rc == 0 means "HMAC calculated"
-  // It does NOT mean "authentication valid"
-
-  // Compare first 12 bytes of computed HMAC with received MAC (bin[5..16])
-  if (memcmp(fullMac, bin + 5, 12) != 0)
+  const Auth_Result result = Auth_Verify(bin, Auth_V2_Signed, epoch, bin + Auth_V2_Signed, sysUtcSecondsNow(), ((uint32_t)Auth_V2_Version << 16) | sequence);
+  if (result != Auth_OK)
   {
-     Serial.printf("AUTH FAIL: HMAC mismatch\n");
-     return;
+    WS_LOG(BLE, LOG_WARN, "AUTH FAIL: %s\n", Auth_Result_Name(result));
+    SD_Log_Write(SD_Log_Auth_Failure, Bluetooth_Mode, result, epoch);
+    return;
+  }
+  if ((setMask & clearMask) || ((setMask | clearMask) & ~Relay_Channels.All))
+  {
+    WS_LOG(BLE, LOG_WARN, "REJECT: masks overlap or address missing channels\n");
+    return;
   }
 
-  Serial.printf("AUTH OK\n");
-
-  uint8_t cmd = (uint8_t)(channel + '0');
-
-  Serial.printf("Dispatch relay: channel=%u ascii=0x%02X\n", (unsigned)channel, (unsigned)cmd);
+  WS_LOG(BLE, LOG_INFO, "AUTH OK, dispatch relay batch: set=0x%02X clear=0x%02X\n", (unsigned)setMask, (unsigned)clearMask);
 
-  Relay_Analysis(&cmd, Bluetooth_Mode);
+  Relay_Immediate_Masks(setMask, clearMask, Bluetooth_Mode);
 }
 
 
@@ -270,16 +274,18 @@ class MyServerCallbacks : public BLEServerCallbacks
 {
     //By overriding the onConnect() and onDisconnect() functions
     
-    // When the Device is connected, "Device connected" is printed.
-    void onConnect(BLEServer* pServer)
+    // When the Device is connected, "Device connected" is printed and the preferred connection interval is requested.
+    void onConnect(BLEServer* pServer, esp_ble_gatts_cb_param_t* param)
     {                                        
       Serial.printf("Device connected\n"); 
+      pServer->updateConnParams(param->connect.remote_bda, BLE_Conn_Interval_Min, BLE_Conn_Interval_Max, BLE_Conn_Latency, BLE_Conn_Timeout);
     }
 
-    // "Device disconnected" will be printed when the device is disconnected
+    // "Device disconnected" will be printed when the device is disconnected, advertising resumes for the next client
     void onDisconnect(BLEServer* pServer)
     {                                       
       Serial.printf("Device disconnected\n");
+      BLEDevice::startAdvertising();
     }
 };
 
@@ -287,37 +293,71 @@ class MyServerCallbacks : public BLEServerCallbacks
 class MyRXCallback : public BLECharacteristicCallbacks
 {
   public:
-  /*
-     onWrite()
-     ├── buzzer pulse
-     ├─ get raw pointer + length
-      ├─ ASCII debug dump (bounded)
-      ├─ dispatch by length:
-      │     2   → handleBle2Byte
-      │     14  → handleBleRtc14
-      │     17/34 → handleBleAuth17or34
-      │     else → reject
-  */
+  // Runs in the BLE host task : only copies the write into a pool slot, BLECmdTask does the rest
   void onWrite(BLECharacteristic* pCharacteristic) override
   {
-    Buzzer_Open_Time(300, 0);
-    Buzzer_Open_Time(300, 150);
-
     // ---- RAW BLE PAYLOAD (binary safe, no String, no getValue) ----
-    const size_t rxLen = pCharacteristic->getLength();
-    const uint8_t* rxData = pCharacteristic->getData();
+    BLE_Cmd_Post(pCharacteristic->getData(), pCharacteristic->getLength());
+  }
+};
 
-    Serial.printf("\nBLE on, Write fired, len=%u \n", pCharacteristic->getLength());
-  
-    // Print as ASCII safely (length-controlled)
-    size_t n = rxLen;
-    if (n > 64) n = 64;   // clamp to safe size
-    char tmp[65];
-    memcpy(tmp, rxData, n);
-    tmp[n] = '\0';
-    Serial.printf("ASCII: %s \n", tmp);
+bool BLE_Cmd_Post(const uint8_t* Data, size_t Length)
+{
+  if (!Data || Length == 0)
+    return false;
+  if (Length > BLE_Cmd_Payload_MAX) {
+    WS_LOG(BLE, LOG_WARN, "REJECT: unsupported payload length\n");
+    return false;
+  }
+  BLE_Cmd_Slot* Slot = BLE_Cmd_Queue ? (BLE_Cmd_Slot*)Pool_Alloc(&Pool_BLE) : NULL;
+  if (!Slot) {
+    BLE_Cmd_Drops++;
+    WS_LOG(BLE, LOG_WARN, "BLE command pool full, write dropped\n");
+    return false;
+  }
+  Slot->Length = Length;
+  memcpy(Slot->Data, Data, Length);
+  xQueueSend(BLE_Cmd_Queue, &Slot, 0);                                          // Cannot fail, the queue holds every slot
+  UBaseType_t Depth = uxQueueMessagesWaiting(BLE_Cmd_Queue);
+  if (Depth > BLE_Cmd_Peak)
+    BLE_Cmd_Peak = Depth;
+  return true;
+}
+uint8_t BLE_Cmd_Queue_Peak(void)
+{
+  return BLE_Cmd_Peak;
+}
+uint32_t BLE_Cmd_Dropped(void)
+{
+  return BLE_Cmd_Drops;
+}
+
+/*
+   BLECmdTask
+   ├── buzzer pulse
+   ├─ hex debug dump (deferred log, bounded)
+   ├─ dispatch by length:
+   │     2   → handleBle2Byte
+   │     14  → handleBleRtc14
+   │     17/34 → handleBleAuth17or34
+   │     21/42 → handleBleAuthBatch21or42
+   │     else → reject
+   └─ slot back to the pool
+*/
+void BLECmdTask(void *parameter)
+{
+  BLE_Cmd_Slot* Slot;
+  while(1){
+    if (xQueueReceive(BLE_Cmd_Queue, &Slot, portMAX_DELAY) != pdTRUE)
+      continue;
+    const uint8_t* rxData = Slot->Data;
+    const size_t rxLen = Slot->Length;
+
+    Buzzer_Open_Time(300, 0);
+    Buzzer_Open_Time(300, 150);
 
-    if (!rxData || rxLen == 0) return;
+    WS_LOG(BLE, LOG_DEBUG, "\nBLE on, Write fired, len=%u \n", (unsigned)rxLen);
+    WS_LOG_HEX(BLE, LOG_DEBUG, "RX: ", rxData, rxLen);         // Copied into the log ring, bounded
 
     // ================= DISPATCH =================
     if (rxLen == 2)
@@ -330,14 +370,20 @@ class MyRXCallback : public BLECharacteristicCallbacks
     }
     else if (rxLen == 17 || rxLen == 34)
     {
-      handleBleAuth17or34(rxData, rxLen, SECRET_KEY, SECRET_LEN);
+      handleBleAuth17or34(rxData, rxLen);
+    }
+    else if (rxLen == Auth_V2_Length || rxLen == Auth_V2_Length * 2)
+    {
+      handleBleAuthBatch21or42(rxData, rxLen);
     }
     else
     {
-      Serial.printf("REJECT: unsupported payload length\n");
+      WS_LOG(BLE, LOG_WARN, "REJECT: unsupported payload length\n");
     }
+    Pool_Free(&Pool_BLE, Slot);
   }
-};
+  vTaskDelete(NULL);
+}
 
 void BLE_Set_RTC_Event(uint8_t* valueBytes)
 {
@@ -375,13 +421,62 @@ void Bluetooth_SendData(char* Data)
   if (n == 256) return;   // unterminated or too long → reject
 
   pTxCharacteristic->setValue((uint8_t*)Data, n);
+  if (pServer && pServer->getConnectedCount())
+    pTxCharacteristic->notify();
+}
+
+/********************************************************  State streaming  ********************************************************/
+// Listeners run in RelayTask / DINTask and must not block, they only wake BLETask
+static void BLE_Relay_Changed(Relay_Mask_t PinState)
+{
+  if (BLE_Task_Handle)
+    xTaskNotifyGive(BLE_Task_Handle);
+}
+static void BLE_DIN_Changed(uint8_t Data)
+{
+  if (BLE_Task_Handle)
+    xTaskNotifyGive(BLE_Task_Handle);
+}
+
+void BLETask(void *parameter)
+{
+  uint8_t Frame[BLE_State_Frame_Length] = {BLE_State_Frame_Type, 0, 0, 0};
+  uint8_t Sequence = 0;
+  while(1){
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);                                    // Changes that came in while sending are merged into one frame
+    uint8_t Relay = (uint8_t)Relay_Get_PinState();
+    uint8_t DIN = DIN_Data;
+    if (Sequence && Frame[1] == Relay && Frame[2] == DIN)
+      continue;                                                                 // Nothing new for the client
+    Frame[1] = Relay;
+    Frame[2] = DIN;
+    Frame[3] = ++Sequence;
+    pStateCharacteristic->setValue(Frame, sizeof(Frame));                       // Also what a plain GATT read returns
+    if (!pServer->getConnectedCount())
+      continue;
+    if (pStateCCCD->getIndications())
+      pStateCharacteristic->indicate();
+    else if (pStateCCCD->getNotifications())
+      pStateCharacteristic->notify();
+  }
+  vTaskDelete(NULL);
 }
 
 void Bluetooth_Init()
 {
+  Auth_Init(SECRET_KEY, SECRET_LEN);           // ipad / opad of the key are hashed once here, not per command
+
+  BLE_Cmd_Queue = xQueueCreate(BLE_Cmd_Pool_Size, sizeof(BLE_Cmd_Slot*));
+  if (!BLE_Cmd_Queue) {
+    printf("Bluetooth_Init(function): BLE command queue creation failed!!!!\r\n");
+    return;
+  }
+  Task_Start(Task_BLE_Cmd, BLECmdTask);
+
   Serial.println("Before BLE init:");
   Serial.printf("Free heap: %u\n", ESP.getFreeHeap());
   BLEDevice::init("ESP32-8-CHANNEL-RELAY");  // Initialize Bluetooth and start broadcasting                           
+  BLEDevice::setMTU(BLE_MTU);
   Serial.println("After BLE init:");
   Serial.printf("Free heap: %u\n", ESP.getFreeHeap());
   Serial.println("\n");
@@ -390,10 +485,20 @@ void Bluetooth_Init()
   pServer->setCallbacks(new MyServerCallbacks());                               
   BLEService* pService = pServer->createService(SERVICE_UUID);
 
-  pTxCharacteristic = pService->createCharacteristic(TX_CHARACTERISTIC_UUID, BLECharacteristic::PROPERTY_READ);
+  pTxCharacteristic = pService->createCharacteristic(TX_CHARACTERISTIC_UUID, BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_NOTIFY);
   BLEDescriptor* txDesc = new BLEDescriptor(BLEUUID((uint16_t)0x2901));
   txDesc->setValue("Relay Status Output");
   pTxCharacteristic->addDescriptor(txDesc);
+  pTxCharacteristic->addDescriptor(new BLE2902());
+
+  pStateCharacteristic = pService->createCharacteristic(
+                                    STATE_CHARACTERISTIC_UUID,
+                                    BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_NOTIFY | BLECharacteristic::PROPERTY_INDICATE);
+  BLEDescriptor* stateDesc = new BLEDescriptor(BLEUUID((uint16_t)0x2901));
+  stateDesc->setValue("Relay / DIN State Frame");
+  pStateCharacteristic->addDescriptor(stateDesc);
+  pStateCCCD = new BLE2902();
+  pStateCharacteristic->addDescriptor(pStateCCCD);
   
   pRxCharacteristic = pService->createCharacteristic(
                                     RX_CHARACTERISTIC_UUID,
@@ -414,8 +519,13 @@ void Bluetooth_Init()
   BLEAdvertising *pAdvertising = BLEDevice::getAdvertising();                   
   pAdvertising->addServiceUUID(SERVICE_UUID);                                   
   pAdvertising->setScanResponse(true);                                          
-  pAdvertising->setMinPreferred(0x06);                                          
-  pAdvertising->setMinPreferred(0x12);                                          
+  pAdvertising->setMinPreferred(BLE_Conn_Interval_Min);                         // Connection interval hint in the scan response
+  pAdvertising->setMaxPreferred(BLE_Conn_Interval_Max);                                          
   BLEDevice::startAdvertising();                                                
   pAdvertising->start();
+
+  Task_Start(Task_BLE_State, BLETask, &BLE_Task_Handle);
+  Relay_Add_Listener(BLE_Relay_Changed);
+  DIN_Add_Listener(BLE_DIN_Changed);
+  xTaskNotifyGive(BLE_Task_Handle);                                             // First frame, so a read right after connecting is valid
 }
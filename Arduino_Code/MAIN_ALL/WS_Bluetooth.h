@@ -4,22 +4,51 @@
 #include <BLEDevice.h>
 #include <BLEUtils.h>
 #include <BLEServer.h>
+#include <BLE2902.h>
 
 #include "WS_GPIO.h"
 #include "WS_Serial.h"
 #include "WS_Information.h"
 #include "WS_Relay.h"
+#include "WS_DIN.h"
 #include "WS_MQTT.h"
 #include "WS_RTC.h"
+#include "WS_Log.h"
+#include "WS_Auth.h"
+#include "WS_Pool.h"
+#include "WS_Tasks.h"
+#include "WS_SD_Log.h"
 
 #define SERVICE_UUID "4fafc201-1fb5-459e-8fcc-c5c9c331914b"                     // UUID of the server
 #define RX_CHARACTERISTIC_UUID  "beb5483e-36e1-4688-b7f5-ea07361b26a8"          // UUID of the characteristic Tx
 #define TX_CHARACTERISTIC_UUID  "beb5484a-36e1-4688-b7f5-ea07361b26a8"          // UUID of the characteristic Rx
+#define STATE_CHARACTERISTIC_UUID "beb5484b-36e1-4688-b7f5-ea07361b26a8"        // UUID of the state characteristic (read / notify / indicate)
 
-#define Bluetooth_Mode    2
+/*************************************************************  State streaming  *************************************************************/
+// Every relay or DIN change is pushed to a subscribed client as one compact frame, no GATT polling needed :
+//   [0] BLE_State_Frame_Type   [1] Relay mask   [2] DIN mask   [3] Sequence (wraps, tells a lost update apart)
+// Masks : bit0 = CH1. The frame is notified, or indicated when the client enabled indications in the CCCD.
+#define BLE_State_Frame_Type      0x01
+#define BLE_State_Frame_Length    4
 
+#define BLE_MTU                   185     // Requested ATT MTU, the client negotiates it down if it has to
+#define BLE_Conn_Interval_Min     0x06    // Preferred connection interval (unit: 1.25 ms), 7.5 ms
+#define BLE_Conn_Interval_Max     0x12    // 22.5 ms
+#define BLE_Conn_Latency          0       // Connection events the peripheral may skip
+#define BLE_Conn_Timeout          400     // Supervision timeout (unit: 10 ms), 4 s
+
+/*************************************************************  Command worker  *************************************************************/
+// onWrite() copies a write into a Pool_BLE slot and queues it, BLECmdTask verifies and executes it,
+// so the HMAC, the buzzer and the relay write never run in the BLE host task.
+#define BLE_Cmd_Pool_Size         8       // Writes that can wait for BLECmdTask, a write beyond that is dropped
+#define BLE_Cmd_Payload_MAX       64      // Longest accepted write, the longest command is 42 bytes
+
+bool BLE_Cmd_Post(const uint8_t* Data, size_t Length);   // Called from onWrite(), never blocks
+uint8_t BLE_Cmd_Queue_Peak(void);                        // Deepest queue seen since boot
+uint32_t BLE_Cmd_Dropped(void);                          // Writes lost because every slot was in use
+void BLECmdTask(void *parameter);
 
 void Bluetooth_SendData(char * Data);   
 void Bluetooth_Init();
-void BLETask(void *parameter);
+void BLETask(void *parameter);                  // Pushes the state frame after every change
 void BLE_Set_RTC_Event(uint8_t* valueBytes);
\ No newline at end of file
@@ -2,12 +2,40 @@
 
 static bool driver_installed = false;
 
+#if CAN_Debug_Level
+  #define CAN_Debug(Level, ...)   do { if (CAN_Debug_Level >= (Level)) printf(__VA_ARGS__); } while (0)
+#else
+  #define CAN_Debug(Level, ...)   do { } while (0)
+#endif
+
+struct CAN_TX_Job {
+  uint32_t Identifier;
+  uint16_t Length;
+  uint8_t Flags;
+  CAN_TX_Callback Callback;
+  void *Arg;
+  uint8_t Data[CAN_TX_Payload_MAX];
+};
+static QueueHandle_t CAN_TX_Queue = NULL;
+
+// Single acceptance filter over the identifier only, RTR and data bytes are don't care.
+// Standard frames : ID in bits 31 ~ 21        Extended frames : ID in bits 31 ~ 3        (mask bit 1 : don't care)
+static twai_filter_config_t CAN_Filter_Config(uint32_t ID, uint32_t ID_Mask, bool Extended)
+{
+  twai_filter_config_t Filter;
+  uint8_t Shift = Extended ? 3 : 21;
+  Filter.acceptance_code = ID << Shift;
+  Filter.acceptance_mask = ~(ID_Mask << Shift);
+  Filter.single_filter = true;
+  return Filter;
+}
+
 void CAN_Init(void)
 {                                // Initializing serial port
   // Initialize configuration structures using macro initializers
   twai_general_config_t g_config = TWAI_GENERAL_CONFIG_DEFAULT((gpio_num_t)TXD1, (gpio_num_t)RXD1, TWAI_MODE_NORMAL);
   twai_timing_config_t t_config = TWAI_TIMING_CONFIG_250KBITS();  //Look in the api-reference for other speed sets.
-  twai_filter_config_t f_config = TWAI_FILTER_CONFIG_ACCEPT_ALL();
+  twai_filter_config_t f_config = CAN_Filter_Config(CAN_Command_ID, CAN_Command_ID_Mask, CAN_Command_Extended);
 
   // Install TWAI driver
   if (twai_driver_install(&g_config, &t_config, &f_config) == ESP_OK) {
@@ -25,8 +53,8 @@ void CAN_Init(void)
     return;
   }
 
-  // Reconfigure alerts to detect TX alerts and Bus-Off errors
-  uint32_t alerts_to_enable = TWAI_ALERT_RX_DATA | TWAI_ALERT_ERR_PASS | TWAI_ALERT_BUS_ERROR | TWAI_ALERT_RX_QUEUE_FULL | TWAI_ALERT_TX_IDLE | TWAI_ALERT_TX_SUCCESS | TWAI_ALERT_TX_FAILED;
+  // Reconfigure alerts to detect RX data, TX failures and Bus-Off errors. CANTask only wakes up for these.
+  uint32_t alerts_to_enable = TWAI_ALERT_RX_DATA | TWAI_ALERT_ERR_PASS | TWAI_ALERT_BUS_ERROR | TWAI_ALERT_RX_QUEUE_FULL | TWAI_ALERT_TX_FAILED | TWAI_ALERT_BUS_OFF | TWAI_ALERT_BUS_RECOVERED;
   if (twai_reconfigure_alerts(alerts_to_enable, NULL) == ESP_OK) {
     printf("CAN Alerts reconfigured\r\n");
   } else {
@@ -36,140 +64,168 @@ void CAN_Init(void)
 
   // TWAI driver is now successfully installed and started
   driver_installed = true;
+  CAN_TX_Queue = xQueueCreate(CAN_TX_Queue_Length, sizeof(CAN_TX_Job));
 
-  xTaskCreatePinnedToCore(
-    CANTask,    
-    "CANTask",   
-    4096,                
-    NULL,                 
-    3,                   
-    NULL,                 
-    0                   
-  );
+  Task_Start(Task_CAN, CANTask);
+  Task_Start(Task_CAN_TX, CANTxTask);
 }
 
-static void send_message_Test(void) {
-  // Send message
-  // Configure message to transmit
-  twai_message_t message;
-  message.identifier = 0x0F6;
-  message.data_length_code = 4;
-  for (int i = 0; i < 4; i++) {
-    message.data[i] = i;
+bool CAN_Send(uint32_t CAN_ID, const uint8_t* Data, uint16_t Length, uint8_t Flags, CAN_TX_Callback Callback, void *Arg)
+{
+  if (CAN_TX_Queue == NULL || Length > CAN_TX_Payload_MAX) {
+    printf("CAN_Send(function): %s!!!!\r\n", CAN_TX_Queue == NULL ? "The CAN driver is not running" : "Payload too long");
+    return false;
   }
+  if (CAN_ID > 0x7FF)
+    Flags |= CAN_TX_Extended;
+  CAN_TX_Job Job;
+  Job.Identifier = CAN_ID;
+  Job.Length = Length;
+  Job.Flags = Flags;
+  Job.Callback = Callback;
+  Job.Arg = Arg;
+  memcpy(Job.Data, Data, Length);
+  if (xQueueSend(CAN_TX_Queue, &Job, 0) != pdTRUE) {          // Never wait for the bus in the caller
+    printf("CAN_Send(function): The CAN TX queue is full!!!!\r\n");
+    return false;
+  }
+  return true;
+}
 
-  // Queue message for transmission
-  if (twai_transmit(&message, pdMS_TO_TICKS(1000)) == ESP_OK) {
-    printf("Message queued for transmission\n");
-  } else {
-    printf("Failed to queue message for transmission\n");
+static void send_message_Test(void) {
+  uint8_t Data[4];
+  for (int i = 0; i < 4; i++) {
+    Data[i] = i;
   }
+  send_message(0x0F6, Data, 4, 0);
 }
 // Standard frames ID: 0x000 to 0x7FF
 // Extended frames ID: 0x00000000  to 0x1FFFFFFF
 // Frame_type : 1：Extended frames   0：Standard frames
-void send_message(uint32_t CAN_ID, uint8_t* Data, uint8_t Data_length, bool Frame_type) {
-  // Send message
-  // Configure message to transmit
-  twai_message_t message;
-  message.identifier = CAN_ID;
-  message.rtr = 0;                              // Disable remote frame
-  if(CAN_ID > 0x7FF){
-    if(!Frame_type)
-      printf("The frame type is set incorrectly and data will eventually be sent as an extended frame!!!!\r\n");
-    message.extd = 1;
+bool send_message(uint32_t CAN_ID, uint8_t* Data, uint8_t Data_length, bool Frame_type) {
+  if (CAN_ID > 0x7FF && !Frame_type)
+    printf("The frame type is set incorrectly and data will eventually be sent as an extended frame!!!!\r\n");
+  return CAN_Send(CAN_ID, Data, Data_length, Frame_type ? CAN_TX_Extended : 0);
+}
+
+static bool CAN_TX_Frame(twai_message_t *Message)
+{
+  if (twai_transmit(Message, pdMS_TO_TICKS(CAN_TX_Frame_Timeout_MS)) != ESP_OK)
+    return false;
+  CAN_Debug(2, "CAN TX %lx [%d]\r\n", (unsigned long)Message->identifier, Message->data_length_code);
+  return true;
+}
+static bool CAN_TX_Raw(const CAN_TX_Job *Job, twai_message_t *Message)
+{
+  uint16_t Offset = 0;
+  do {                                                          // Zero length payloads still send one empty frame
+    uint8_t Length = (Job->Length - Offset > 8) ? 8 : Job->Length - Offset;
+    Message->data_length_code = Length;
+    memcpy(Message->data, Job->Data + Offset, Length);
+    if (!CAN_TX_Frame(Message))
+      return false;
+    Offset += Length;
+  } while (Offset < Job->Length);
+  return true;
+}
+static bool CAN_TX_ISO_TP(const CAN_TX_Job *Job, twai_message_t *Message)
+{
+  Message->data_length_code = 8;
+  if (Job->Length <= 7) {                                       // Single frame
+    Message->data[0] = Job->Length;
+    memcpy(Message->data + 1, Job->Data, Job->Length);
+    Message->data_length_code = 1 + Job->Length;
+    return CAN_TX_Frame(Message);
   }
-  else
-    message.extd = Frame_type;
-  if(Data_length > 8){
-    uint16_t Frame_count = (Data_length / 8);
-    for (int i = 0; i < Frame_count; i++) {
-      message.data_length_code = 8;
-      for (int j = 0; j < 8; j++) {
-        message.data[j] = Data[j + (i * 8)];
-      }
-      // Queue message for transmission
-      if (twai_transmit(&message, pdMS_TO_TICKS(1000)) == ESP_OK) {
-        printf("Message queued for transmission\n");
-      } else {
-        printf("Failed to queue message for transmission\n");
-      }
-    }
-    if(Data_length % 8){
-      uint8_t Data_length_Now = Data_length % 8;
-      message.data_length_code = Data_length_Now;
-      for (int k = 0; k < Data_length_Now; k++) {
-        message.data[k] = Data[k + (Data_length - Data_length_Now)];
-      }
-      // Queue message for transmission
-      if (twai_transmit(&message, pdMS_TO_TICKS(1000)) == ESP_OK) {
-        printf("Message queued for transmission\n");
-      } else {
-        printf("Failed to queue message for transmission\n");
-      }
-    }
-  }
-  else{
-    message.data_length_code = Data_length;
-    for (int i = 0; i < Data_length; i++) {
-      message.data[i] = Data[i];
-    }
-    // Queue message for transmission
-    if (twai_transmit(&message, pdMS_TO_TICKS(1000)) == ESP_OK) {
-      printf("Message queued for transmission\n");
-    } else {
-      printf("Failed to queue message for transmission\n");
-    }
+  Message->data[0] = 0x10 | (Job->Length >> 8);                 // First frame, 12 bit length
+  Message->data[1] = Job->Length & 0xFF;
+  memcpy(Message->data + 2, Job->Data, 6);
+  if (!CAN_TX_Frame(Message))
+    return false;
+  uint16_t Offset = 6;
+  uint8_t Sequence = 1;
+  while (Offset < Job->Length) {                                // Consecutive frames
+    uint8_t Length = (Job->Length - Offset > 7) ? 7 : Job->Length - Offset;
+    vTaskDelay(pdMS_TO_TICKS(CAN_ISOTP_STmin_MS));
+    Message->data[0] = 0x20 | (Sequence++ & 0x0F);
+    memcpy(Message->data + 1, Job->Data + Offset, Length);
+    Message->data_length_code = 1 + Length;
+    if (!CAN_TX_Frame(Message))
+      return false;
+    Offset += Length;
   }
+  return true;
 }
 
-
+static Relay_Mask_t CAN_Get_Mask(const uint8_t *Data)      // Little endian, sizeof(Relay_Mask_t) bytes
+{
+  uint32_t Mask = 0;
+  for (size_t i = 0; i < sizeof(Relay_Mask_t); i++)
+    Mask |= (uint32_t)Data[i] << (i * 8);
+  return (Relay_Mask_t)(Mask & Relay_Channels.All);
+}
+static uint8_t CAN_State_Payload(uint8_t *Data)               // [CAN_Cmd_Query | 0x80, Relay, DIN]
+{
+  uint32_t Relay = Relay_Get_PinState();
+  Data[0] = CAN_Cmd_Query | 0x80;
+  for (size_t i = 0; i < sizeof(Relay_Mask_t); i++)
+    Data[1 + i] = (uint8_t)(Relay >> (i * 8));
+  Data[1 + sizeof(Relay_Mask_t)] = DIN_Data;
+  return 2 + sizeof(Relay_Mask_t);
+}
+static void CAN_Send_State(void)
+{
+  uint8_t Data[8];
+  CAN_Send(CAN_Status_ID, Data, CAN_State_Payload(Data), 0);
+}
 
 static void handle_rx_message(twai_message_t &message) {
-  // Process received message
-  if (message.extd) {
-    printf("Message is in Extended Format\r\n");
-  } else {
-    printf("Message is in Standard Format\r\n");
+  // The filter can be wider than one identifier (CAN_Command_ID_Mask), only the exact matches are commands
+  uint8_t Length = message.data_length_code;
+  if (message.rtr || (bool)message.extd != (bool)CAN_Command_Extended || ((message.identifier ^ CAN_Command_ID) & CAN_Command_ID_Mask) || !Length) {
+    printf("Note : Non-instruction data was received - CAN ID %lx !\r\n", (unsigned long)message.identifier);
+    return;
   }
-  printf("ID: %lx\nByte:", message.identifier);
-  if (!(message.rtr)) {
-    if (message.data_length_code > 0) {
-      printf(" Data: ");
-      for (int i = 0; i < message.data_length_code; i++) {
-        printf("%02x ", message.data[i]);
-      }
-      printf("\r\n");
-      // printf("Send back the received data!\r\n");
-      // send_message(message.identifier,  message.data, message.data_length_code, message.extd);
-    } else {
-      printf(" No data available\r\n");
-    }
-  } else {
-    printf("This is a Remote Transmission Request (RTR) frame.\r\n");
+  const uint8_t *Data = message.data;
+  switch (Data[0]) {
+    case CAN_Cmd_Masks:
+      if (Length < 1 + 2 * sizeof(Relay_Mask_t))
+        break;
+      Relay_Immediate_Masks(CAN_Get_Mask(Data + 1), CAN_Get_Mask(Data + 1 + sizeof(Relay_Mask_t)), CAN_Mode);
+      return;
+    case CAN_Cmd_Toggle:
+      if (Length < 1 + sizeof(Relay_Mask_t))
+        break;
+      Relay_Immediate_Toggle(CAN_Get_Mask(Data + 1), CAN_Mode);
+      return;
+    case CAN_Cmd_Write:
+      if (Length < 1 + sizeof(Relay_Mask_t))
+        break;
+      Relay_Immediate_CHxs(CAN_Get_Mask(Data + 1), CAN_Mode);
+      return;
+    case CAN_Cmd_Query:
+      CAN_Send_State();
+      return;
   }
+  printf("Note : Non-instruction data was received - CAN command 0x%02X, %d bytes !\r\n", Data[0], Length);
 }
 
-unsigned long previousMillis = 0;  // will store last time a message was send
 #if Communication_failure_Enable
   static unsigned long previous_bus_error_time = 0; // To store the last time a BUS_ERROR was printed
 #endif
 void CAN_Loop(void)
 {
   if(driver_installed){
-    // Check if an alert happened
+    // Sleep until the controller reports something, there is no polling interval
     uint32_t alerts_triggered;
-    twai_read_alerts(&alerts_triggered, pdMS_TO_TICKS(POLLING_RATE_MS));
-    twai_status_info_t twaistatus;
-    twai_get_status_info(&twaistatus);
+    if (twai_read_alerts(&alerts_triggered, portMAX_DELAY) != ESP_OK)
+      return;
 
     // Handle alerts
     if (alerts_triggered & TWAI_ALERT_ERR_PASS) {
       printf("Alert: TWAI controller has become error passive.\r\n");
     }
     if (alerts_triggered & TWAI_ALERT_BUS_ERROR) {
-      // printf("Alert: A (Bit, Stuff, CRC, Form, ACK) error has occurred on the bus.\r\n");
-      // printf("Bus error count: %ld\n", twaistatus.bus_error_count);
       #if Communication_failure_Enable
         unsigned long currentMillis = millis();
         // Only print the message if more than 2 seconds have passed since the last time it was printed
@@ -179,21 +235,29 @@ void CAN_Loop(void)
         }
       #endif
     }
-    if (alerts_triggered & TWAI_ALERT_RX_QUEUE_FULL) {
-      printf("Alert: The RX queue is full causing a received frame to be lost.\r\n");
-      printf("RX buffered: %ld\t", twaistatus.msgs_to_rx);
-      printf("RX missed: %ld\t", twaistatus.rx_missed_count);
-      printf("RX overrun %ld\n", twaistatus.rx_overrun_count);
+    if (alerts_triggered & (TWAI_ALERT_RX_QUEUE_FULL | TWAI_ALERT_TX_FAILED)) {
+      twai_status_info_t twaistatus;
+      twai_get_status_info(&twaistatus);
+      if (alerts_triggered & TWAI_ALERT_RX_QUEUE_FULL) {
+        printf("Alert: The RX queue is full causing a received frame to be lost.\r\n");
+        printf("RX buffered: %ld\t", twaistatus.msgs_to_rx);
+        printf("RX missed: %ld\t", twaistatus.rx_missed_count);
+        printf("RX overrun %ld\n", twaistatus.rx_overrun_count);
+      }
+      if (alerts_triggered & TWAI_ALERT_TX_FAILED) {
+        printf("Alert: The Transmission failed.\r\n");
+        printf("TX buffered: %ld\t", twaistatus.msgs_to_tx);
+        printf("TX error: %ld\t", twaistatus.tx_error_counter);
+        printf("TX failed: %ld\n", twaistatus.tx_failed_count);
+      }
     }
-    if (alerts_triggered & TWAI_ALERT_TX_FAILED) {
-      printf("Alert: The Transmission failed.\r\n");
-      printf("TX buffered: %ld\t", twaistatus.msgs_to_tx);
-      printf("TX error: %ld\t", twaistatus.tx_error_counter);
-      printf("TX failed: %ld\n", twaistatus.tx_failed_count);
+    if (alerts_triggered & TWAI_ALERT_BUS_OFF) {
+      printf("Alert: Bus-Off, starting the recovery.\r\n");
+      twai_initiate_recovery();
     }
-    if (alerts_triggered & TWAI_ALERT_TX_SUCCESS) {
-      printf("Alert: The Transmission was successful.\r\n");
-      printf("TX buffered: %ld\t \r\n", twaistatus.msgs_to_tx);
+    if (alerts_triggered & TWAI_ALERT_BUS_RECOVERED) {
+      printf("Alert: Bus recovered.\r\n");
+      twai_start();
     }
 
     // Receive messages if any are available
@@ -212,8 +276,53 @@ void CANTask(void *parameter) {
   // uint8_t Data[27]={0x80, 0x2A, 0xC3, 0x58, 0x17, 0x11, 0x4D, 0x3F, 0x3B, 0xCE, 0x0F, 0xFF, 0x79, 0x20, 0xB4, 0x40, 0x5D, 0x29, 0x05, 0x49, 0xE6, 0x12, 0x57, 0x0E, 0x6D, 0xC9, 0xAE};
   // send_message(0x079,Data,27);
   while(1){
-    CAN_Loop();
-    vTaskDelay(pdMS_TO_TICKS(50));
+    CAN_Loop();                                             // Blocks in twai_read_alerts()
   }
   vTaskDelete(NULL);
-}
\ No newline at end of file
+}
+
+#if CAN_State_Broadcast_MS
+static void CAN_Broadcast_State(void)
+{
+  // Only the newest state matters : skip the period when the controller queue is full instead of piling up
+  twai_message_t message = {};
+  message.identifier = CAN_Status_ID;
+  message.extd = CAN_Status_ID > 0x7FF;
+  message.data_length_code = CAN_State_Payload(message.data);
+  twai_transmit(&message, 0);
+}
+#endif
+void CANTxTask(void *parameter)
+{
+  CAN_TX_Job Job;                                           // Static size, CAN_TX_Payload_MAX on the task stack
+  twai_message_t message = {};
+  #if CAN_State_Broadcast_MS
+    TickType_t Broadcast_Next = xTaskGetTickCount();
+  #endif
+  while(1){
+    TickType_t Wait = portMAX_DELAY;
+    #if CAN_State_Broadcast_MS
+      TickType_t Now = xTaskGetTickCount();
+      if ((int32_t)(Now - Broadcast_Next) >= 0) {
+        CAN_Broadcast_State();
+        Broadcast_Next += pdMS_TO_TICKS(CAN_State_Broadcast_MS);
+        if ((int32_t)(Now - Broadcast_Next) >= 0)             // Fell behind (bus-off, long ISO-TP payload) : no burst to catch up
+          Broadcast_Next = Now + pdMS_TO_TICKS(CAN_State_Broadcast_MS);
+      }
+      Wait = Broadcast_Next - Now;
+    #endif
+    if (xQueueReceive(CAN_TX_Queue, &Job, Wait) != pdTRUE)
+      continue;
+    message.identifier = Job.Identifier;
+    message.extd = (Job.Flags & CAN_TX_Extended) ? 1 : 0;
+    message.rtr = 0;                                        // Disable remote frame
+    bool Success = (Job.Flags & CAN_TX_ISOTP) ? CAN_TX_ISO_TP(&Job, &message) : CAN_TX_Raw(&Job, &message);
+    if (!Success)
+      printf("CANTxTask(function): Payload for CAN ID %lx given up, the bus is not accepting frames!!!!\r\n", (unsigned long)Job.Identifier);
+    else
+      CAN_Debug(1, "CAN TX %lx : %d bytes queued\r\n", (unsigned long)Job.Identifier, Job.Length);
+    if (Job.Callback)
+      Job.Callback(Success, Job.Arg);
+  }
+  vTaskDelete(NULL);
+}
@@ -1,12 +1,48 @@
 #pragma once
 
 #include "driver/twai.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
 #include "WS_GPIO.h"
+#include "WS_Relay.h"
+#include "WS_DIN.h"
+#include "WS_Tasks.h"
 
 // Interval:
 #define TRANSMIT_RATE_MS      1000
-// Interval:
-#define POLLING_RATE_MS       1000
+
+/*************************************************************  Command protocol  *************************************************************/
+// The acceptance filter of the controller only lets the command identifiers through, CANTask never sees the rest of the bus.
+// Frame on CAN_Command_ID, masks little endian with sizeof(Relay_Mask_t) bytes (one byte on the 8 channel board) :
+//   [CAN_Cmd_Masks,  Open, Closs]     Open / Closs mask, the other channels are retained
+//   [CAN_Cmd_Toggle, Toggle]          Every channel in the mask changes state
+//   [CAN_Cmd_Write,  State]           All channels at once
+//   [CAN_Cmd_Query]                   Answered on CAN_Status_ID with [CAN_Cmd_Query | 0x80, Relay, DIN]
+#define CAN_Command_ID          0x200     // Identifier of the relay commands
+#define CAN_Command_ID_Mask     0x7FF     // Identifier bits that have to match (0x7F0 : accept 0x200 ~ 0x20F)
+#define CAN_Command_Extended    0         // 1 : the command identifiers are 29 bit extended frames
+#define CAN_Status_ID           0x280     // Identifier of the answers
+
+#define CAN_Cmd_Masks           0x01
+#define CAN_Cmd_Toggle          0x02
+#define CAN_Cmd_Write           0x03
+#define CAN_Cmd_Query           0x04
+
+/*************************************************************  Transmit  *************************************************************/
+// send_message() / CAN_Send() only copy the payload into a queue, CANTxTask hands the frames to the controller.
+// Payloads above 8 bytes are split into raw 8 byte frames, or segmented as ISO-TP (ISO 15765-2) with CAN_TX_ISOTP.
+// The ISO-TP sender does not wait for flow control frames : the consecutive frames go out CAN_ISOTP_STmin_MS apart.
+#define CAN_TX_Queue_Length     16        // Payloads waiting for CANTxTask
+#define CAN_TX_Payload_MAX      128       // Largest payload of one send_message() / CAN_Send() (ISO-TP allows 4095)
+#define CAN_TX_Frame_Timeout_MS 100       // Longest wait for room in the controller queue before a payload is given up
+#define CAN_ISOTP_STmin_MS      1         // Separation time between two ISO-TP consecutive frames
+#define CAN_State_Broadcast_MS  0         // Relay / DIN state frame on CAN_Status_ID every N ms (10 : 100 Hz), 0 : disabled
+#define CAN_Debug_Level         0         // 0 : errors only   1 : one line per payload   2 : one line per frame
+
+#define CAN_TX_Extended         0x01      // CAN_Send() flags : 29 bit identifier
+#define CAN_TX_ISOTP            0x02      //                    ISO-TP segmentation
+
+typedef void (*CAN_TX_Callback)(bool Success, void *Arg);   // Runs in CANTxTask once every frame of the payload is queued in the controller, must not block
 
 #define Communication_failure_Enable    0         // If the CAN bus is faulty for a long time, determine whether to forcibly exit
 
@@ -18,5 +54,7 @@
 void CAN_Init(void);
 void CAN_Loop(void);
 void CANTask(void *parameter);
+void CANTxTask(void *parameter);
 
-void send_message(uint32_t CAN_ID, uint8_t* Data, uint8_t Data_length);
\ No newline at end of file
+bool CAN_Send(uint32_t CAN_ID, const uint8_t* Data, uint16_t Length, uint8_t Flags, CAN_TX_Callback Callback = NULL, void *Arg = NULL);
+bool send_message(uint32_t CAN_ID, uint8_t* Data, uint8_t Data_length, bool Frame_type);   // Raw frames, returns false when the TX queue is full
\ No newline at end of file
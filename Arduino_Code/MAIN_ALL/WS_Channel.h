@@ -0,0 +1,84 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <type_traits>
+#include "WS_Modbus.h"
+
+/*************************************************************  Channel table  *************************************************************/
+// Everything that used to be copy-pasted per channel (dispatch, log text, Modbus frames, JSON keys)
+// is generated at compile time from the channel count, so the same code serves 8, 16 or 32 channel boards.
+
+template <uint8_t N>
+using Relay_Mask_Type = typename std::conditional<(N <= 8), uint8_t,
+                        typename std::conditional<(N <= 16), uint16_t, uint32_t>::type>::type;
+
+typedef struct {
+  uint8_t Pin;                              // EXIO pin of the channel
+  char Instruction;                         // Single byte toggle instruction ('1' ~ '8'), 0 when the channel has none
+  char Name[5];                             // "CH1" ~ "CH32", also the JSON key
+  Modbus_Frame RS485_Frame;                 // RS485 frame that toggles this channel
+} Relay_Channel;
+
+template <uint8_t N>
+struct Relay_Channel_Table {
+  static_assert(N >= 1 && N <= 32, "Relay_Channel_Table supports 1 ~ 32 channels");
+  typedef Relay_Mask_Type<N> Mask;
+
+  static constexpr uint8_t Number = N;
+  static constexpr Mask All = (Mask)(N == 32 ? 0xFFFFFFFFu : ((1u << N) - 1));
+
+  Relay_Channel CH[N];
+  Modbus_Frame RS485_Frame_ALL_ON;
+  Modbus_Frame RS485_Frame_ALL_OFF;
+
+  constexpr Relay_Channel_Table() : CH(), RS485_Frame_ALL_ON(), RS485_Frame_ALL_OFF()
+  {
+    for (uint8_t i = 0; i < N; i++) {
+      CH[i].Pin = i + 1;
+      CH[i].Instruction = (i < 8) ? (char)('1' + i) : 0;
+      CH[i].Name[0] = 'C';
+      CH[i].Name[1] = 'H';
+      if(i + 1 < 10){
+        CH[i].Name[2] = (char)('1' + i);
+        CH[i].Name[3] = 0;
+      }
+      else{
+        CH[i].Name[2] = (char)('0' + (i + 1) / 10);
+        CH[i].Name[3] = (char)('0' + (i + 1) % 10);
+      }
+      CH[i].Name[4] = 0;
+      CH[i].RS485_Frame = Modbus_Make_Frame(Modbus_Local_ID, Modbus_Write_Coil, i + 1, Modbus_Coil_Toggle);
+    }
+    RS485_Frame_ALL_ON = Modbus_Make_Frame(Modbus_Local_ID, Modbus_Write_Coil, Modbus_Coil_All, Modbus_Coil_All_ON);
+    RS485_Frame_ALL_OFF = Modbus_Make_Frame(Modbus_Local_ID, Modbus_Write_Coil, Modbus_Coil_All, Modbus_Coil_OFF);
+  }
+
+  constexpr int Find_Instruction(uint8_t Instruction) const     // Channel index of a toggle instruction, -1 if none
+  {
+    for (uint8_t i = 0; i < N; i++) {
+      if(CH[i].Instruction && CH[i].Instruction == (char)Instruction)
+        return i;
+    }
+    return -1;
+  }
+  constexpr int Find_Name(const char *Key, size_t Length) const // Channel index of a "CHx" key (not terminated), -1 if none
+  {
+    for (uint8_t i = 0; i < N; i++) {
+      size_t j = 0;
+      while(j < Length && CH[i].Name[j] && CH[i].Name[j] == Key[j])
+        j++;
+      if(j == Length && !CH[i].Name[j])
+        return i;
+    }
+    return -1;
+  }
+  constexpr int Find_RS485_Frame(const uint8_t *Frame) const    // Channel index of a received toggle frame, -1 if none
+  {
+    for (uint8_t i = 0; i < N; i++) {
+      if(Modbus_Frame_Equal(CH[i].RS485_Frame, Frame))
+        return i;
+    }
+    return -1;
+  }
+};
@@ -0,0 +1,125 @@
+#include "WS_Console.h"
+
+typedef struct {
+  const char *Name;
+  Console_Handler Handler;
+  const char *Help;
+} Console_Command;
+
+static Console_Command Console_Commands[Console_Command_MAX];
+static uint8_t Console_Command_Count = 0;
+static portMUX_TYPE Console_Lock = portMUX_INITIALIZER_UNLOCKED;
+
+bool Console_Add_Command(const char *Name, Console_Handler Handler, const char *Help)
+{
+  bool Result = 0;
+  portENTER_CRITICAL(&Console_Lock);
+  if (Console_Command_Count < Console_Command_MAX) {
+    Console_Commands[Console_Command_Count].Name = Name;
+    Console_Commands[Console_Command_Count].Handler = Handler;
+    Console_Commands[Console_Command_Count].Help = Help;
+    Console_Command_Count++;
+    Result = 1;
+  }
+  portEXIT_CRITICAL(&Console_Lock);
+  if (!Result)
+    printf("Console_Add_Command(function): No free command slot for %s!!!!\r\n", Name);
+  return Result;
+}
+
+/********************************************************  Built in commands  ********************************************************/
+static void Console_Help(const char *Args)
+{
+  for (uint8_t i = 0; i < Console_Command_Count; i++) {
+    printf("  %-10s %s\r\n", Console_Commands[i].Name, Console_Commands[i].Help);
+  }
+}
+static void Console_Tasks(const char *Args)
+{
+  Task_Print_Stats();
+}
+static void Console_Pools(const char *Args)
+{
+  Pool_Print_Stats();
+}
+static void Console_Trace(const char *Args)
+{
+  Trace_Report Report;
+  char Text[Trace_Item_Size];
+  Trace_Get_Report(&Report);
+  for (int i = 0, n; (n = Trace_Format(&Report, i, Text, sizeof(Text))) >= 0; i++) {
+    printf("%s", Text);
+  }
+  printf("\r\n");
+  if (!strcmp(Args, "reset")) {
+    Trace_Reset();
+    printf("Note : The latency trace has been reset !\r\n");
+  }
+}
+
+/********************************************************  Line input  ********************************************************/
+static void Console_Execute(char *Line)
+{
+  while (*Line == ' ' || *Line == '\t')
+    Line++;
+  char *End = Line + strlen(Line);
+  while (End > Line && (End[-1] == ' ' || End[-1] == '\t'))
+    *--End = '\0';
+  if (!*Line)
+    return;
+  char *Args = Line;
+  while (*Args && *Args != ' ' && *Args != '\t')
+    Args++;
+  if (*Args) {
+    *Args++ = '\0';
+    while (*Args == ' ' || *Args == '\t')
+      Args++;
+  }
+  for (uint8_t i = 0; i < Console_Command_Count; i++) {
+    if (!strcmp(Console_Commands[i].Name, Line)) {
+      Console_Commands[i].Handler(Args);
+      return;
+    }
+  }
+  printf("Note : Unknown console command %s, try help !\r\n", Line);
+}
+
+void Console_Init(void)
+{
+  static bool Initialized = false;
+  if (Initialized)
+    return;
+  Initialized = true;
+  Console_Add_Command("help", Console_Help, "list the commands");
+  Console_Add_Command("tasks", Console_Tasks, "core, priority and stack of every task");
+  Console_Add_Command("pools", Console_Pools, "fixed-block pool usage");
+  Console_Add_Command("trace", Console_Trace, "relay command latency [reset]");
+  Task_Start(Task_Console, ConsoleTask);
+}
+
+void ConsoleTask(void *parameter)
+{
+  static char Line[Console_Line_MAX];
+  size_t Length = 0;
+  bool Overflow = false;
+  while(1){
+    while (Serial.available() > 0) {
+      int c = Serial.read();
+      if (c == '\r' || c == '\n') {
+        Line[Length] = '\0';
+        if (Overflow)
+          printf("Note : The console line is longer than %d characters and has been ignored !\r\n", Console_Line_MAX - 1);
+        else
+          Console_Execute(Line);
+        Length = 0;
+        Overflow = false;
+      }
+      else if (Length < Console_Line_MAX - 1)
+        Line[Length++] = (char)c;
+      else
+        Overflow = true;
+    }
+    vTaskDelay(pdMS_TO_TICKS(Console_Poll_MS));
+  }
+  vTaskDelete(NULL);
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <Arduino.h>
+#include <stdint.h>
+#include "WS_Tasks.h"
+#include "WS_Trace.h"
+#include "WS_Pool.h"
+
+/*************************************************************  Serial console  *************************************************************/
+// Line based commands on the USB serial port : "<command> [arguments]\n". Modules add their commands with
+// Console_Add_Command(), the handler runs in ConsoleTask and gets the text after the command name.
+#define Console_Command_MAX       16      // Commands that can be registered
+#define Console_Line_MAX          128     // Longest command line, longer lines are rejected
+#define Console_Poll_MS           50      // ConsoleTask checks the serial input this often (unit: ms)
+
+typedef void (*Console_Handler)(const char *Args);   // Args : text after the command, white space trimmed, never NULL
+
+bool Console_Add_Command(const char *Name, Console_Handler Handler, const char *Help);   // Name and Help must be static
+void Console_Init(void);                  // Built in : help, tasks, pools, trace [reset]
+void ConsoleTask(void *parameter);
@@ -1,151 +1,160 @@
 #include "WS_DIN.h"
+#include "soc/gpio_reg.h"
+#include <atomic>
 
 bool DIN_Flag[8] = {0};                   // DIN current status flag
 uint8_t DIN_Data = 0;
 bool Relay_Immediate_Enable = Relay_Immediate_Default;
 
-bool DIN_Read_CH1(void){
-  DIN_Flag[0] = digitalRead(DIN_PIN_CH1);
-  if(DIN_Flag[0]){
-    DIN_Data |= (1 << 0); 
-    return 1;
-  }
-  else{
-    DIN_Data &= (~(1 << 0)); 
-    return 0;
-  }
-}
-bool DIN_Read_CH2(void){
-  DIN_Flag[1] = digitalRead(DIN_PIN_CH2);
-  if(DIN_Flag[1]){
-    DIN_Data |= (1 << 1); 
-    return 1;
-  }
-  else{
-    DIN_Data &= (~(1 << 1)); 
-    return 0;
-  }
-}
-bool DIN_Read_CH3(void){
-  DIN_Flag[2] = digitalRead(DIN_PIN_CH3);
-  if(DIN_Flag[2]){
-    DIN_Data |= (1 << 2); 
-    return 1;
-  }
-  else{
-    DIN_Data &= (~(1 << 2)); 
-    return 0;
-  }
-}
-bool DIN_Read_CH4(void){
-  DIN_Flag[3] = digitalRead(DIN_PIN_CH4);
-  if(DIN_Flag[3]){
-    DIN_Data |= (1 << 3); 
-    return 1;
-  }
-  else{
-    DIN_Data &= (~(1 << 3)); 
-    return 0;
-  }
+static_assert(DIN_PIN_CH2 == DIN_PIN_CH1 + 1 && DIN_PIN_CH3 == DIN_PIN_CH1 + 2 && DIN_PIN_CH4 == DIN_PIN_CH1 + 3 &&
+              DIN_PIN_CH5 == DIN_PIN_CH1 + 4 && DIN_PIN_CH6 == DIN_PIN_CH1 + 5 && DIN_PIN_CH7 == DIN_PIN_CH1 + 6 &&
+              DIN_PIN_CH8 == DIN_PIN_CH1 + 7, "DIN_Read_CHxs() reads the inputs as one contiguous field of GPIO_IN_REG");
+static const uint8_t DIN_Pin[8] = {DIN_PIN_CH1, DIN_PIN_CH2, DIN_PIN_CH3, DIN_PIN_CH4, DIN_PIN_CH5, DIN_PIN_CH6, DIN_PIN_CH7, DIN_PIN_CH8};
+static uint16_t DIN_Debounce_Time[8] = {DIN_Debounce_MS, DIN_Debounce_MS, DIN_Debounce_MS, DIN_Debounce_MS,
+                                        DIN_Debounce_MS, DIN_Debounce_MS, DIN_Debounce_MS, DIN_Debounce_MS};
+
+typedef struct {
+  int64_t Time;                           // esp_timer_get_time() of the edge (unit: us)
+  uint8_t Port;                           // Level of all eight inputs at the edge
+  uint8_t CHx;                            // Channel that raised the interrupt (0 ~ 7)
+} DIN_Event;
+static QueueHandle_t DIN_Event_Queue = NULL;
+static volatile bool DIN_Event_Lost = false;
+
+uint8_t IRAM_ATTR DIN_Read_CHxs(){        // One port register read instead of eight digitalRead()
+  return (uint8_t)(REG_READ(GPIO_IN_REG) >> DIN_PIN_CH1);
 }
-bool DIN_Read_CH5(void){
-  DIN_Flag[4] = digitalRead(DIN_PIN_CH5);
-  if(DIN_Flag[4]){
-    DIN_Data |= (1 << 4); 
-    return 1;
-  }
-  else{
-    DIN_Data &= (~(1 << 4)); 
-    return 0;
-  }
+
+static void IRAM_ATTR DIN_ISR(void *arg)
+{
+  BaseType_t Woken = pdFALSE;
+  DIN_Event Event = {esp_timer_get_time(), DIN_Read_CHxs(), (uint8_t)(uintptr_t)arg};
+  if(xQueueSendFromISR(DIN_Event_Queue, &Event, &Woken) != pdTRUE)
+    DIN_Event_Lost = true;                // DINTask falls back to reading the port
+  portYIELD_FROM_ISR(Woken);
 }
-bool DIN_Read_CH6(void){
-  DIN_Flag[5] = digitalRead(DIN_PIN_CH6);
-  if(DIN_Flag[5]){
-    DIN_Data |= (1 << 5); 
-    return 1;
-  }
-  else{
-    DIN_Data &= (~(1 << 5)); 
-    return 0;
+
+void DIN_Set_Debounce(uint8_t CHx, uint16_t Time)
+{
+  if(!CHx || CHx > 8){
+    printf("DIN_Set_Debounce(function): Incoming parameter error!!!!\r\n");
+    return;
   }
+  DIN_Debounce_Time[CHx - 1] = Time;
 }
-bool DIN_Read_CH7(void){
-  DIN_Flag[6] = digitalRead(DIN_PIN_CH7);
-  if(DIN_Flag[6]){
-    DIN_Data |= (1 << 6); 
-    return 1;
-  }
-  else{
-    DIN_Data &= (~(1 << 6)); 
-    return 0;
-  }
+
+static DIN_Listener DIN_Listeners[DIN_Listener_MAX];
+static std::atomic<uint8_t> DIN_Listener_Count(0);
+static portMUX_TYPE DIN_Listener_Lock = portMUX_INITIALIZER_UNLOCKED;
+
+bool DIN_Add_Listener(DIN_Listener Listener)
+{
+  bool Result = 0;
+  portENTER_CRITICAL(&DIN_Listener_Lock);
+  uint8_t Count = DIN_Listener_Count.load(std::memory_order_relaxed);
+  if(Count < DIN_Listener_MAX){
+    DIN_Listeners[Count] = Listener;
+    DIN_Listener_Count.store(Count + 1, std::memory_order_release);
+    Result = 1;
+  }
+  portEXIT_CRITICAL(&DIN_Listener_Lock);
+  if(!Result)
+    printf("DIN_Add_Listener(function): No free listener slot!!!!\r\n");
+  return Result;
 }
-bool DIN_Read_CH8(void){
-  DIN_Flag[7] = digitalRead(DIN_PIN_CH8);
-  if(DIN_Flag[7]){
-    DIN_Data |= (1 << 7); 
-    return 1;
-  }
-  else{
-    DIN_Data &= (~(1 << 7)); 
-    return 0;
+
+static void DIN_Update(uint8_t Data)
+{
+  if(Data == DIN_Data)
+    return;
+  DIN_Data = Data;
+  for (int i = 0; i < 8; i++) {
+    DIN_Flag[i] = (DIN_Data >> i) & 0x01;
+  }
+  uint8_t Count = DIN_Listener_Count.load(std::memory_order_acquire);
+  for (uint8_t i = 0; i < Count; i++) {
+    DIN_Listeners[i](DIN_Data);
+  }
+  if(Relay_Immediate_Enable){
+    if(DIN_Inverse_Enable)
+      Relay_Immediate_CHxs(~DIN_Data , DIN_Mode);
+    else
+      Relay_Immediate_CHxs(DIN_Data , DIN_Mode);
   }
 }
-uint8_t DIN_Read_CHxs(){
-  DIN_Read_CH1();
-  DIN_Read_CH2();
-  DIN_Read_CH3();
-  DIN_Read_CH4();
-  DIN_Read_CH5();
-  DIN_Read_CH6();
-  DIN_Read_CH7();
-  DIN_Read_CH8();
-  return DIN_Data;
-}
 
-static uint8_t DIN_Data_Old = 0;
+// A channel follows its first edge immediately and then ignores further edges for its debounce time.
+// When that time is over the level is read again, so a release that happened while bouncing is not lost.
 void DINTask(void *parameter) {
+  int64_t Lock_Until[8] = {0};            // Edges of channel i are ignored until this time (unit: us)
+  uint8_t Locked = 0;                     // Channels inside their debounce time
+  DIN_Event Event;
+
+  uint8_t Idle = DIN_Inverse_Enable ? 0xFF : 0x00;
+  DIN_Data = Idle;
+  DIN_Update(DIN_Read_CHxs());            // Inputs that are already active at boot switch their relay once
   while(1){
-    if(Relay_Immediate_Enable){
-      DIN_Read_CHxs();
-      if(DIN_Data_Old != DIN_Data){
-        if(DIN_Inverse_Enable)
-          Relay_Immediate_CHxs(~DIN_Data , DIN_Mode);
-        else
-          Relay_Immediate_CHxs(DIN_Data , DIN_Mode);
-        DIN_Data_Old = DIN_Data;
+    TickType_t Wait = portMAX_DELAY;      // Nothing pending : sleep until the next edge
+    if(Locked){
+      int64_t Next = INT64_MAX;
+      for (int i = 0; i < 8; i++) {
+        if(((Locked >> i) & 0x01) && Lock_Until[i] < Next)
+          Next = Lock_Until[i];
       }
+      int64_t Remain = Next - esp_timer_get_time();
+      Wait = Remain > 0 ? pdMS_TO_TICKS((Remain + 999) / 1000) : 0;
+      if(Remain > 0 && !Wait)
+        Wait = 1;
     }
-    vTaskDelay(pdMS_TO_TICKS(20));
+    uint8_t Data = DIN_Data;
+    uint8_t Start = 0;                    // Channels whose level changed and start a debounce time now
+    while(xQueueReceive(DIN_Event_Queue, &Event, Wait) == pdTRUE){
+      uint8_t Bit = 1 << Event.CHx;
+      if(!(Locked & Bit) && !(Start & Bit) && ((Event.Port ^ Data) & Bit)){
+        Data = (Data & ~Bit) | (Event.Port & Bit);
+        Start |= Bit;
+        Lock_Until[Event.CHx] = Event.Time + (int64_t)DIN_Debounce_Time[Event.CHx] * 1000;
+      }
+      Wait = 0;                           // Collect the edges that are already queued, then act on them together
+    }
+
+    int64_t Now = esp_timer_get_time();
+    uint8_t Expired = 0;
+    for (int i = 0; i < 8; i++) {
+      if(((Locked >> i) & 0x01) && Now >= Lock_Until[i])
+        Expired |= (1 << i);
+    }
+    uint8_t Check = Expired;
+    if(DIN_Event_Lost){                   // The queue overflowed, resynchronize every channel that is not bouncing
+      DIN_Event_Lost = false;
+      Check |= ~(Locked | Start);
+    }
+    if(Check){
+      uint8_t Port = DIN_Read_CHxs();
+      uint8_t Changed = (Port ^ Data) & Check;
+      Data = (Data & ~Check) | (Port & Check);
+      for (int i = 0; i < 8; i++) {
+        if((Changed >> i) & 0x01){
+          Start |= (1 << i);
+          Lock_Until[i] = Now + (int64_t)DIN_Debounce_Time[i] * 1000;
+        }
+      }
+    }
+    Locked = (Locked & ~Expired) | Start;
+    DIN_Update(Data);
   }
   vTaskDelete(NULL);
 }
 
 void DIN_Init(void)
 {
-  pinMode(DIN_PIN_CH1, INPUT_PULLUP);
-  pinMode(DIN_PIN_CH2, INPUT_PULLUP);
-  pinMode(DIN_PIN_CH3, INPUT_PULLUP);
-  pinMode(DIN_PIN_CH4, INPUT_PULLUP);
-  pinMode(DIN_PIN_CH5, INPUT_PULLUP);
-  pinMode(DIN_PIN_CH6, INPUT_PULLUP);
-  pinMode(DIN_PIN_CH7, INPUT_PULLUP);
-  pinMode(DIN_PIN_CH8, INPUT_PULLUP);
-
-  DIN_Read_CHxs();
-  if(DIN_Inverse_Enable)
-    DIN_Data_Old = 0xFF;
-  else
-    DIN_Data_Old = 0x00;
+  DIN_Event_Queue = xQueueCreate(DIN_Event_Queue_Length, sizeof(DIN_Event));
+  for (int i = 0; i < 8; i++) {
+    pinMode(DIN_Pin[i], INPUT_PULLUP);
+  }
 
-  xTaskCreatePinnedToCore(
-    DINTask,    
-    "DINTask",   
-    4096,                
-    NULL,                 
-    4,                   
-    NULL,                 
-    0                   
-  );
+  Task_Start(Task_DIN, DINTask);
+  for (int i = 0; i < 8; i++) {
+    attachInterruptArg(DIN_Pin[i], DIN_ISR, (void *)(uintptr_t)i, CHANGE);
+  }
 }
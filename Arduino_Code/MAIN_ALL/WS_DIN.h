@@ -2,6 +2,7 @@
 
 #include "WS_GPIO.h"
 #include "WS_Relay.h"
+#include "WS_Tasks.h"
 /*************************************************************  I/O  *************************************************************/
 #define DIN_PIN_CH1      4      // DIN CH1 GPIO
 #define DIN_PIN_CH2      5      // DIN CH2  GPIO
@@ -15,4 +16,15 @@
 #define Relay_Immediate_Default   1       // Enable the input control relay
 #define DIN_Inverse_Enable        1       // Input is reversed from control
 
+#define DIN_Debounce_MS           10      // Default debounce time of every channel (unit: ms)
+#define DIN_Event_Queue_Length    32      // Edge events that can wait for DINTask
+#define DIN_Listener_MAX          4       // Modules that can be told about input changes
+
+typedef void (*DIN_Listener)(uint8_t Data);   // Runs in DINTask after every debounced change, must not block
+
+extern uint8_t DIN_Data;                  // DIN current status, bit0 = CH1
+
 void DIN_Init(void);
+uint8_t DIN_Read_CHxs(void);
+void DIN_Set_Debounce(uint8_t CHx, uint16_t Time);   // Debounce time of one channel (unit: ms)
+bool DIN_Add_Listener(DIN_Listener Listener);
@@ -1,5 +1,6 @@
 #include <time.h>
 #include <sys/time.h>
+#include <esp_sntp.h>
 
 #include "WS_ETH.h"
 
@@ -33,6 +34,12 @@ void printSystemTime()
 
 void printRTCTime()
 {
+  datetime_t datetime = {0};
+  if (!PCF85063_Read_Time(&datetime))
+  {
+    Serial.printf("RTC time not available\n");
+    return;
+  }
   Serial.printf(
     "RTC: %04d-%02d-%02d %02d:%02d:%02d\n",
     datetime.year,
@@ -146,15 +153,15 @@ void diagnosis()
 Acquisition_time()
 
 Purpose:
-  Create a valid system UTC clock using the ESP32 native SNTP subsystem,
-  then mirror that time into the external RTC (PCF85063) if SNTP succeeds
-  within a fixed timeout window.
+  Start the ESP32 native SNTP client. Every SNTP sync mirrors the system UTC
+  into the external RTC (PCF85063).
 
 Design rules:
   - SNTP is initialized once via configTime(); timezone configuration is applied on each call.
-  - The ESP32 system clock is the *only* source of truth.
-  - The RTC is a mirror, never an authority.
-  - No retry storms and no implicit SNTP re-initialization beyond the initial configTime() call.
+  - The ESP32 system clock is the *only* source of truth once SNTP has set it.
+  - The RTC is a mirror, never an authority. Until SNTP answers, the time service
+    (Time_Get()) counts from the reading taken at boot, the system clock is not set from it.
+  - Never blocks: it runs in the network event handler, SNTP answers asynchronously.
 
 What this function actually does:
 
@@ -164,132 +171,43 @@ What this function actually does:
 
   2. Starts SNTP only once:
         configTime(0,0,servers)
-        SNTP runs asynchronously, but this function blocks while polling the system clock.
+        with Time_Sync_Notification() as the sync notification callback.
 
-  3. Polls the system clock:
-        time(nullptr)
+  3. Returns whether the system clock is already valid (epoch > 1609459200).
 
-     Until either:
-        A) time becomes sane (epoch > 1609459200)
-        B) timeout expires (20 seconds)
-
-  4. If SNTP responds in time:
+  4. Whenever SNTP sets the clock (first answer and every periodic resync):
         - System clock becomes real UTC
-        - RTC is written from system UTC
-        - Function returns TRUE
-
-  5. If SNTP is slow or blocked:
-        - System time stays near 0 / 1970
-        - Loop times out
-        - RTC is NOT written
-        - Function returns FALSE
-
-Determinism properties:
-
-  Deterministic control flow with externally contingent outcome:
-
-    Input:
-      - Network availability
-      - UDP/123 reachability
-      - DNS resolution
-      - SNTP server responsiveness
-
-    Output:
-      - TRUE  → system UTC became valid within the timeout and RTC was synchronized
-      - FALSE → system UTC did not become valid within the timeout (SNTP may still succeed later)
-
-  No partial success is acted upon; only system time validity within the timeout is accepted.
-  No unbounded retries are performed by this function; polling is limited to a fixed timeout.
-  No silent failure.
-  No guessing.
-
-What happens if SNTP is slow:
+        - RTCTask writes the RTC from system UTC (RTC_Sync_From_System(), no I2C in the lwIP callback)
 
-  Case 1: SNTP replies within 20 seconds
-      → now > 1609459200
-      → system UTC created
-      → RTC written
-      → SUCCESS
-
-  Case 2: SNTP replies after 20 seconds
-      → function already returned FALSE
-      → system clock may update later
-      → but RTC will NOT be written
-      → caller must re-call Acquisition_time() if desired
-
-  Case 3: SNTP never replies (UDP blocked / DNS broken)
-      → system epoch remains small
-      → function returns FALSE
-      → RTC remains unchanged
-      → hard failure is visible in logs
-
-Why this is correct:
-
-  - Prevents race conditions
-  - Prevents RTC corruption with invalid time
-  - Makes NTP failure explicit instead of implicit
-  - Keeps time acquisition behavior explicit and bounded by a fixed timeout.
+  If SNTP never replies (UDP blocked / DNS broken) the RTC remains unchanged and
+  the time keeps counting from the RTC reading.
 
 This function does NOT:
-  - Retry forever
-  - Mask network problems
-  - Use RTC as fallback
-  - Guess time
-  - Accept partial initialization
+  - Poll or retry
+  - Write the RTC from a time that SNTP did not deliver
+  - Set the system clock from the RTC
 */
+static void Time_Sync_Notification(struct timeval *tv)
+{
+  RTC_Sync_From_System();
+  Serial.printf("[NTP] System UTC set (epoch=%ld)\n", (long)tv->tv_sec);
+}
 bool Acquisition_time(void)
 {
     static bool sntp_initialized = false;
 
-    Serial.printf("[NTP] Using native SNTP\n");
-
     setenv("TZ", "UTC0", 1);
     tzset();
 
     // Initialize SNTP only once
     if (!sntp_initialized) {
+        Serial.printf("[NTP] Using native SNTP\n");
+        sntp_set_time_sync_notification_cb(Time_Sync_Notification);
         configTime(0, 0, "pool.ntp.org", "time.nist.gov");
         sntp_initialized = true;
     }
 
-    const uint32_t timeoutMs = 20000;
-    uint32_t start = millis();
-
-    while (millis() - start < timeoutMs)
-    {
-        time_t now = time(nullptr);
-        Serial.printf("[NTP] system epoch=%ld\n", (long)now);
-
-        // Epoch sanity check: > 2021-01-01
-        if (now > 1609459200)
-        {
-            Serial.printf("[NTP] SUCCESS, system UTC created\n");
-
-            // Write RTC from system UTC
-            struct tm utc;
-            gmtime_r(&now, &utc);
-
-            datetime_t t = {0};
-            t.year   = utc.tm_year + 1900;
-            t.month  = utc.tm_mon + 1;
-            t.day    = utc.tm_mday;
-            t.dotw   = utc.tm_wday;
-            t.hour   = utc.tm_hour;
-            t.minute = utc.tm_min;
-            t.second = utc.tm_sec;
-
-            PCF85063_Set_All(t);
-            datetime = t;
-
-            Serial.printf("[RTC] Updated from system UTC\n");
-            return true;
-        }
-
-        delay(500);
-    }
-
-    Serial.printf("[NTP] FAILURE: SNTP never set system time\n");
-    return false;
+    return time(nullptr) > Time_System_Valid_Epoch;
 }
 
 void testClient(const char *host, uint16_t port)
@@ -343,8 +261,7 @@ void onEvent(arduino_event_id_t event, arduino_event_info_t info)
       Serial.printf("[ETH GOT IP] %d.%d.%d.%d  epoch=%ld\n",
                      ETH_ip[0], ETH_ip[1], ETH_ip[2], ETH_ip[3],
                     (long)time(nullptr));
-      Acquisition_time();
-      printRTCTime();
+      Acquisition_time();                 // Returns at once, the RTC is written when SNTP answers
       printSystemTime();
       break;                    
     case ARDUINO_EVENT_ETH_LOST_IP:
@@ -363,6 +280,7 @@ void onEvent(arduino_event_id_t event, arduino_event_info_t info)
 void ETH_Init(void)
 {
   Serial.printf("Ethernet Start\n");
+  Network_Init();                 // ETH becomes the default route for MQTT and the web server once it has an address
   Network.onEvent(onEvent);
   SPI.begin(ETH_SPI_SCK, ETH_SPI_MISO, ETH_SPI_MOSI);
   ETH.begin(ETH_PHY_TYPE, ETH_PHY_ADDR, ETH_PHY_CS, ETH_PHY_IRQ, ETH_PHY_RST, SPI);
@@ -5,6 +5,7 @@
 #include "WS_PCF85063.h"
 #include "WS_GPIO.h"
 #include "WS_RTC.h"
+#include "WS_Network.h"
 
 extern volatile bool g_need_ntp;
 void ETH_LoopTick();
@@ -1,5 +1,7 @@
 #include "WS_GPIO.h"
 
+static QueueHandle_t Indicator_Queue = NULL;
+
 /*************************************************************  I/O Init  *************************************************************/
 void GPIO_Init() {
   pinMode(GPIO_PIN_RGB, OUTPUT);     // Initialize the control GPIO of RGB
@@ -8,99 +10,30 @@ void GPIO_Init() {
   ledcAttach(GPIO_PIN_Buzzer, Frequency, Resolution);   
   Set_Dutyfactor(0);                //0~100  
 
-  // DISABLE RGB TASK ONLY
-  // NOTE:
-  // RGBTask is intentionally NOT created.
-  // Vendor RGBTask forcibly overwrites LED state every 50ms and turns it OFF
-  // when its internal queue is empty, making direct RGB_Light() control impossible.
-  // Relay and buzzer require GPIO_Init(), but RGB is controlled manually to avoid vendor task interference.
-  /*
-  xTaskCreatePinnedToCore(
-    RGBTask,    
-    "RelayFailTask",   
-    4096,                
-    NULL,                 
-    2,                   
-    NULL,                 
-    0                   
-  );
-  */
-
-  xTaskCreatePinnedToCore(
-    BuzzerTask,    
-    "RelayFailTask",   
-    4096,                
-    NULL,                 
-    2,                   
-    NULL,                 
-    0                   
-  );
+  // RGB_Light() stays free for direct control : IndicatorTask only drives the LED while an RGB_Open_Time() pattern runs,
+  // unlike the vendor RGBTask, which turned the LED off every 50 ms when it had nothing to show.
+  Indicator_Queue = xQueueCreate(Indicator_Queue_Length, sizeof(Indicator_Pattern));
+  if(!Indicator_Queue){
+    printf("GPIO_Init(function): indicator queue creation failed!!!!\r\n");
+    return;
+  }
+  Task_Start(Task_Indicator, IndicatorTask);
 }
 
 /*************************************************************  RGB  *************************************************************/
 void RGB_Light(uint8_t red_val, uint8_t green_val, uint8_t blue_val) {
   neopixelWrite(GPIO_PIN_RGB, green_val, red_val, blue_val);  // RGB color adjustment
 }
-RGB_Indicate RGB_indicate[RGB_Indicate_Number];
-static uint8_t RGB_indicate_Num = 0;
 void RGB_Open_Time(uint8_t red_val, uint8_t green_val, uint8_t blue_val, uint16_t Time, uint16_t flicker_time) {
-
-  if(RGB_indicate_Num + 1 >= RGB_Indicate_Number)
-  {
+  Indicator_Pattern Pattern;
+  Pattern.Output = Indicator_RGB;
+  Pattern.Red = red_val;
+  Pattern.Green = green_val;
+  Pattern.Blue = blue_val;
+  Pattern.Time = Time;
+  Pattern.Flicker = flicker_time;
+  if(!Indicator_Play(&Pattern))
     printf("Note : The RGB indicates that the cache is full and has been ignored\r\n");
-  }
-  else{
-    RGB_indicate[RGB_indicate_Num].Red = red_val;
-    RGB_indicate[RGB_indicate_Num].Green = green_val;
-    RGB_indicate[RGB_indicate_Num].Blue = blue_val;
-    RGB_indicate[RGB_indicate_Num].RGB_Time = Time;
-    if(flicker_time<51)
-      flicker_time = 0;                                         // If the blinking interval is less than 50ms, the blinking is ignored
-    RGB_indicate[RGB_indicate_Num].RGB_Flicker = flicker_time;
-    RGB_indicate_Num ++;
-  }
-}
-void RGBTask(void *parameter) {
-  bool RGB_Flag = 0;
-  while(1){
-    if(RGB_indicate[0].RGB_Time)
-    {
-      RGB_Flag = 1;
-      RGB_Light(RGB_indicate[0].Red, RGB_indicate[0].Green, RGB_indicate[0].Blue); 
-      if(RGB_indicate[0].RGB_Flicker){
-        vTaskDelay(pdMS_TO_TICKS(RGB_indicate[0].RGB_Flicker));
-        RGB_Light(0, 0, 0);  
-        vTaskDelay(pdMS_TO_TICKS(RGB_indicate[0].RGB_Flicker));
-      }
-      if(RGB_indicate[0].RGB_Time > (RGB_indicate[0].RGB_Flicker * 2 +50))
-        RGB_indicate[0].RGB_Time = RGB_indicate[0].RGB_Time -(RGB_indicate[0].RGB_Flicker * 2 +50);
-      else
-        RGB_indicate[0].RGB_Time = 0;
-    }
-    else if(RGB_Flag && !RGB_indicate[0].RGB_Time){
-      RGB_Light(0, 0, 0);  
-      RGB_Flag = 0;
-      RGB_indicate[0].Red = 0;
-      RGB_indicate[0].Green = 0;
-      RGB_indicate[0].Blue = 0;
-      RGB_indicate[0].RGB_Time = 0;
-      RGB_indicate[0].RGB_Flicker = 0;
-      if(RGB_indicate_Num > 0){
-        for (int i = 1; i < RGB_Indicate_Number; i++) {
-          RGB_indicate[i-1] = RGB_indicate[i];  
-        }
-        RGB_indicate[RGB_Indicate_Number -1].Red = 0;
-        RGB_indicate[RGB_Indicate_Number -1].Green = 0;
-        RGB_indicate[RGB_Indicate_Number -1].Blue = 0;
-        RGB_indicate[RGB_Indicate_Number -1].RGB_Time = 0;
-        RGB_indicate[RGB_Indicate_Number -1].RGB_Flicker = 0;
-        RGB_indicate_Num --;
-        vTaskDelay(pdMS_TO_TICKS(RGB_Indicating_interval));
-      }
-    }
-    vTaskDelay(pdMS_TO_TICKS(50));
-  }
-  vTaskDelete(NULL);
 }
 
 
@@ -121,54 +54,115 @@ void Buzzer_Closs(void)
 {
   Set_Dutyfactor(0);
 }
-Buzzer_Indicate Buzzer_indicate[Buzzer_Indicate_Number];
-static uint8_t Buzzer_indicate_Num = 0;
 void Buzzer_Open_Time(uint16_t Time, uint16_t flicker_time) 
 {
-  if(Buzzer_indicate_Num + 1 >= Buzzer_Indicate_Number)
-  {
+  Indicator_Pattern Pattern;
+  Pattern.Output = Indicator_Buzzer;
+  Pattern.Time = Time;
+  Pattern.Flicker = flicker_time;
+  if(!Indicator_Play(&Pattern))
     printf("Note : The buzzer indicates that the cache is full and has been ignored\r\n");
+}
+
+/**********************************************************  Indicators  **********************************************************/
+typedef struct {
+  Indicator_Pattern Pending[Buzzer_Indicate_Number > RGB_Indicate_Number ? Buzzer_Indicate_Number : RGB_Indicate_Number];
+  uint8_t Capacity;
+  uint8_t Head;
+  uint8_t Count;
+  Indicator_Pattern Active;
+  bool Playing;
+  bool On;
+  uint32_t End_Time;                    // millis() at which the running pattern ends
+  uint32_t Edge_Time;                   // Next toggle of a blinking pattern, or the end of the gap after a pattern
+  uint16_t Gap;                         // Pause after every pattern (unit: ms)
+} Indicator_Channel;
+
+bool Indicator_Play(const Indicator_Pattern *Pattern)
+{
+  if(!Pattern->Time)
+    return true;                                                // Nothing to play
+  if(!Indicator_Queue)
+    return false;
+  return xQueueSend(Indicator_Queue, Pattern, 0) == pdTRUE;
+}
+static void Indicator_Drive(uint8_t Output, const Indicator_Pattern *Pattern, bool On)
+{
+  if(Output == Indicator_RGB){
+    if(On)
+      RGB_Light(Pattern->Red, Pattern->Green, Pattern->Blue);
+    else
+      RGB_Light(0, 0, 0);
   }
-  else{
-    Buzzer_indicate[Buzzer_indicate_Num].Buzzer_Time = Time;
-    if(flicker_time<51)
-      flicker_time = 0;                                         // If the blinking interval is less than 50ms, the blinking is ignored
-    Buzzer_indicate[Buzzer_indicate_Num].Buzzer_Flicker = flicker_time;
-    Buzzer_indicate_Num ++;
+  else if(On)
+    Buzzer_Open();
+  else
+    Buzzer_Closs();
+}
+// Starts, toggles or ends the pattern of one output, returns the ms until it needs the next call (portMAX_DELAY : idle)
+static uint32_t Indicator_Step(uint8_t Output, Indicator_Channel *Channel, uint32_t Now)
+{
+  if(Channel->Playing){
+    if((int32_t)(Now - Channel->End_Time) >= 0){
+      Channel->Playing = false;
+      Indicator_Drive(Output, &Channel->Active, false);
+      Channel->Edge_Time = Now + Channel->Gap;
+    }
+    else if(Channel->Active.Flicker && (int32_t)(Now - Channel->Edge_Time) >= 0){
+      Channel->On = !Channel->On;
+      Indicator_Drive(Output, &Channel->Active, Channel->On);
+      Channel->Edge_Time += Channel->Active.Flicker;
+    }
+  }
+  if(!Channel->Playing && Channel->Count && (int32_t)(Now - Channel->Edge_Time) >= 0){
+    Channel->Active = Channel->Pending[Channel->Head];
+    Channel->Head = (Channel->Head + 1) % Channel->Capacity;
+    Channel->Count--;
+    if(Channel->Active.Flicker < Indicator_Flicker_MIN)
+      Channel->Active.Flicker = 0;                              // If the blinking interval is less than 50ms, the blinking is ignored
+    Channel->Playing = true;
+    Channel->On = true;
+    Indicator_Drive(Output, &Channel->Active, true);
+    Channel->End_Time = Now + Channel->Active.Time;
+    Channel->Edge_Time = Now + Channel->Active.Flicker;
   }
+  if(Channel->Playing){
+    uint32_t Next = Channel->Active.Flicker && (int32_t)(Channel->Edge_Time - Channel->End_Time) < 0 ? Channel->Edge_Time : Channel->End_Time;
+    return (int32_t)(Next - Now) > 0 ? Next - Now : 0;
+  }
+  if(Channel->Count)
+    return (int32_t)(Channel->Edge_Time - Now) > 0 ? Channel->Edge_Time - Now : 0;
+  return portMAX_DELAY;
 }
-void BuzzerTask(void *parameter) {
-  bool Buzzer_Flag = 0;
+void IndicatorTask(void *parameter) {
+  static Indicator_Channel Channels[Indicator_Number];
+  Channels[Indicator_Buzzer].Capacity = Buzzer_Indicate_Number;
+  Channels[Indicator_Buzzer].Gap = 0;
+  Channels[Indicator_RGB].Capacity = RGB_Indicate_Number;
+  Channels[Indicator_RGB].Gap = RGB_Indicating_interval;
+  uint32_t Wait_MS = portMAX_DELAY;
+  Indicator_Pattern Pattern;
   while(1){
-    if(Buzzer_indicate[0].Buzzer_Time)
-    {
-      Buzzer_Flag = 1;
-      Buzzer_Open(); 
-      if(Buzzer_indicate[0].Buzzer_Flicker){
-        vTaskDelay(pdMS_TO_TICKS(Buzzer_indicate[0].Buzzer_Flicker));
-        Buzzer_Closs();  
-        vTaskDelay(pdMS_TO_TICKS(Buzzer_indicate[0].Buzzer_Flicker));
+    TickType_t Wait = Wait_MS == portMAX_DELAY ? portMAX_DELAY : pdMS_TO_TICKS(Wait_MS);
+    while(xQueueReceive(Indicator_Queue, &Pattern, Wait) == pdTRUE){
+      Wait = 0;                                                 // Take every queued pattern before stepping the outputs
+      Indicator_Channel *Channel = Pattern.Output < Indicator_Number ? &Channels[Pattern.Output] : NULL;
+      if(!Channel)
+        continue;
+      if(Channel->Count >= Channel->Capacity){
+        printf("Note : The %s indicates that the cache is full and has been ignored\r\n", Pattern.Output == Indicator_RGB ? "RGB" : "buzzer");
+        continue;
       }
-      if(Buzzer_indicate[0].Buzzer_Time > (Buzzer_indicate[0].Buzzer_Flicker * 2 +50))
-        Buzzer_indicate[0].Buzzer_Time = Buzzer_indicate[0].Buzzer_Time -(Buzzer_indicate[0].Buzzer_Flicker * 2 +50);
-      else
-        Buzzer_indicate[0].Buzzer_Time = 0;
+      Channel->Pending[(Channel->Head + Channel->Count) % Channel->Capacity] = Pattern;
+      Channel->Count++;
     }
-    else if(Buzzer_Flag && !Buzzer_indicate[0].Buzzer_Time){
-      Buzzer_Closs();  
-      Buzzer_Flag = 0;
-      Buzzer_indicate[0].Buzzer_Time = 0;
-      Buzzer_indicate[0].Buzzer_Flicker = 0;
-      if(Buzzer_indicate_Num > 0){
-        for (int i = 1; i < Buzzer_indicate_Num; i++) {
-          Buzzer_indicate[i-1] = Buzzer_indicate[i];  
-        }
-        Buzzer_indicate[Buzzer_indicate_Num - 1].Buzzer_Time = 0;
-        Buzzer_indicate[Buzzer_indicate_Num - 1].Buzzer_Flicker = 0;
-        Buzzer_indicate_Num --;
-      }
+    uint32_t Now = millis();
+    Wait_MS = portMAX_DELAY;
+    for (int i = 0; i < Indicator_Number; i++) {
+      uint32_t Next = Indicator_Step(i, &Channels[i], Now);
+      if(Next < Wait_MS)
+        Wait_MS = Next;
     }
-    vTaskDelay(pdMS_TO_TICKS(50));
   }
   vTaskDelete(NULL);
-}
\ No newline at end of file
+}
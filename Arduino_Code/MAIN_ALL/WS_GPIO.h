@@ -1,6 +1,7 @@
 #pragma once
 
 #include <HardwareSerial.h>     // Reference the ESP32 built-in serial port library
+#include "WS_Tasks.h"
 
 /*************************************************************  I/O  *************************************************************/
 #define TXD1              17    //The TXD of UART1 corresponds to GPIO   RS485/CAN
@@ -16,29 +17,39 @@
 #define Dutyfactor_MAX  255
 
 
-#define RGB_Indicate_Number  10         // Number of saved RGB indicator signals
-#define RGB_Indicating_interval 500     // Time interval of each indication signal(unit: ms)
+/*********************************************************  Indicators  *********************************************************/
+// Buzzer and RGB patterns are queued to IndicatorTask, which sleeps on the queue until the next edge of a running
+// pattern, or indefinitely when nothing is playing. Every output plays its own patterns in order.
+#define Indicator_Queue_Length    10      // Patterns waiting to be picked up by IndicatorTask
+#define RGB_Indicate_Number       10      // Number of saved RGB indicator signals
+#define RGB_Indicating_interval   500     // Time interval of each indication signal(unit: ms)
+#define Buzzer_Indicate_Number    10      // Number of saved buzzer indicator signals
+#define Indicator_Flicker_MIN     51      // A shorter blinking interval is ignored, the output stays on (unit: ms)
+
+typedef enum {
+  Indicator_Buzzer = 0,
+  Indicator_RGB = 1,
+  Indicator_Number,
+} Indicator_Output;
+
 typedef struct { 
+  uint8_t Output = Indicator_Buzzer;    // Indicator_Output
   uint8_t Red = 0;
   uint8_t Green = 0;
   uint8_t Blue = 0;
-  uint16_t RGB_Time = 0;                // RGB lighting duration
-  uint16_t RGB_Flicker = 0;             // RGB flicker interval
-} RGB_Indicate;
+  uint16_t Time = 0;                    // Duration of the pattern
+  uint16_t Flicker = 0;                 // On / off interval, 0 : on for the whole duration
+} Indicator_Pattern;
 
-#define Buzzer_Indicate_Number  10      // Number of saved RGB indicator signals
-typedef struct { 
-  uint16_t Buzzer_Time = 0;             // Buzzer duration
-  uint16_t Buzzer_Flicker = 0;          // Buzzer interval duration
-} Buzzer_Indicate;
 /*************************************************************  I/O  *************************************************************/
 void GPIO_Init();
 void RGB_Light(uint8_t red_val, uint8_t green_val, uint8_t blue_val);
 void RGB_Open_Time(uint8_t red_val, uint8_t green_val, uint8_t blue_val, uint16_t Time, uint16_t flicker_time);
-void RGBTask(void *parameter);
 
 void Set_Dutyfactor(uint16_t dutyfactor);
 void Buzzer_Open(void);
 void Buzzer_Closs(void);
 void Buzzer_Open_Time(uint16_t Time, uint16_t flicker_time); 
-void BuzzerTask(void *parameter);
+
+bool Indicator_Play(const Indicator_Pattern *Pattern);    // Never blocks, false : the queue is full
+void IndicatorTask(void *parameter);
@@ -0,0 +1,144 @@
+#include "WS_JSON.h"
+
+void JSON_Skip_Space(JSON_Parser *P)
+{
+  while(P->Pos < P->Length && (P->Text[P->Pos] == ' ' || P->Text[P->Pos] == '\t' || P->Text[P->Pos] == '\r' || P->Text[P->Pos] == '\n'))
+    P->Pos++;
+}
+bool JSON_Expect(JSON_Parser *P, char c)
+{
+  JSON_Skip_Space(P);
+  if(P->Pos >= P->Length || P->Text[P->Pos] != c)
+    return false;
+  P->Pos++;
+  return true;
+}
+bool JSON_Parse_Key(JSON_Parser *P, const char **Key, unsigned int *Key_Length)
+{
+  if(!JSON_Expect(P, '"'))
+    return false;
+  *Key = (const char *)P->Text + P->Pos;
+  while(P->Pos < P->Length && P->Text[P->Pos] != '"')
+    P->Pos++;
+  if(P->Pos >= P->Length)
+    return false;
+  *Key_Length = (const char *)P->Text + P->Pos - *Key;
+  P->Pos++;
+  return JSON_Expect(P, ':');
+}
+bool JSON_Parse_Value(JSON_Parser *P, int *Value)
+{
+  JSON_Skip_Space(P);
+  bool Quoted = (P->Pos < P->Length && P->Text[P->Pos] == '"');
+  if(Quoted)
+    P->Pos++;
+  if(P->Length - P->Pos >= 4 && !memcmp(P->Text + P->Pos, "true", 4)){
+    *Value = 1;
+    P->Pos += 4;
+  }
+  else if(P->Length - P->Pos >= 5 && !memcmp(P->Text + P->Pos, "false", 5)){
+    *Value = 0;
+    P->Pos += 5;
+  }
+  else{
+    if(P->Pos >= P->Length || P->Text[P->Pos] < '0' || P->Text[P->Pos] > '9')
+      return false;
+    *Value = 0;
+    while(P->Pos < P->Length && P->Text[P->Pos] >= '0' && P->Text[P->Pos] <= '9' && *Value < 10)
+      *Value = *Value * 10 + (P->Text[P->Pos++] - '0');
+  }
+  return !Quoted || JSON_Expect(P, '"');
+}
+bool JSON_Parse_Uint(JSON_Parser *P, uint32_t *Value)
+{
+  JSON_Skip_Space(P);
+  bool Quoted = (P->Pos < P->Length && P->Text[P->Pos] == '"');
+  if(Quoted)
+    P->Pos++;
+  if(P->Pos >= P->Length || P->Text[P->Pos] < '0' || P->Text[P->Pos] > '9')
+    return false;
+  uint64_t Number = 0;
+  while(P->Pos < P->Length && P->Text[P->Pos] >= '0' && P->Text[P->Pos] <= '9'){
+    Number = Number * 10 + (P->Text[P->Pos++] - '0');
+    if(Number > UINT32_MAX)
+      return false;
+  }
+  *Value = (uint32_t)Number;
+  return !Quoted || JSON_Expect(P, '"');
+}
+bool JSON_Skip_Value(JSON_Parser *P)
+{
+  int Depth = 0;
+  bool In_String = false;
+  JSON_Skip_Space(P);
+  for (; P->Pos < P->Length; P->Pos++) {
+    uint8_t c = P->Text[P->Pos];
+    if(In_String){
+      if(c == '\\')
+        P->Pos++;
+      else if(c == '"'){
+        In_String = false;
+        if(!Depth){
+          P->Pos++;
+          return true;
+        }
+      }
+    }
+    else if(c == '"')
+      In_String = true;
+    else if(c == '{' || c == '[')
+      Depth++;
+    else if(c == '}' || c == ']'){
+      if(!Depth)
+        return true;
+      if(!--Depth){
+        P->Pos++;
+        return true;
+      }
+    }
+    else if(c == ',' && !Depth)
+      return true;
+  }
+  return !Depth && !In_String;
+}
+bool JSON_Key_Is(const char *Key, unsigned int Key_Length, const char *Name)
+{
+  return strlen(Name) == Key_Length && !memcmp(Key, Name, Key_Length);
+}
+
+bool JSON_Parse_Channels(JSON_Parser *P, Relay_Mask_t *Open, Relay_Mask_t *Closs, const char *Source)
+{
+  const char *Key;
+  unsigned int Key_Length;
+  int Value;
+  if(!JSON_Expect(P, '{'))
+    return false;
+  if(JSON_Expect(P, '}'))
+    return true;
+  do {
+    if(!JSON_Parse_Key(P, &Key, &Key_Length))
+      return false;
+    int CHx = Relay_Channels.Find_Name(Key, Key_Length);
+    Relay_Mask_t Mask = 0;
+    if(CHx >= 0)
+      Mask = (Relay_Mask_t)(1UL << CHx);
+    else if(JSON_Key_Is(Key, Key_Length, "ALL"))
+      Mask = Relay_Channels.All;
+    if(Mask && JSON_Parse_Value(P, &Value) && Value <= 1){
+      if(Value){
+        *Open |= Mask;
+        *Closs &= (Relay_Mask_t)~Mask;
+      }
+      else{
+        *Closs |= Mask;
+        *Open &= (Relay_Mask_t)~Mask;
+      }
+    }
+    else{
+      printf("Note : Unknown key or value in 'data' - %.*s - %s!\r\n", Key_Length, Key, Source);
+      if(!JSON_Skip_Value(P))
+        return false;
+    }
+  } while(JSON_Expect(P, ','));
+  return JSON_Expect(P, '}');
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "WS_Relay.h"
+
+// Small in-place reader for the JSON bodies of the relay commands (MQTT payload, /api/relay).
+// The text is parsed where the transport left it, nothing is copied or allocated.
+typedef struct {
+  const uint8_t *Text;
+  unsigned int Length;
+  unsigned int Pos;
+} JSON_Parser;
+
+void JSON_Skip_Space(JSON_Parser *P);
+bool JSON_Expect(JSON_Parser *P, char c);                                           // Skips white space, then consumes c
+bool JSON_Parse_Key(JSON_Parser *P, const char **Key, unsigned int *Key_Length);    // "key" : , escapes are not expected in keys
+bool JSON_Parse_Value(JSON_Parser *P, int *Value);                                  // 0 / 1 / "0" / "1" / true / false
+bool JSON_Parse_Uint(JSON_Parser *P, uint32_t *Value);                              // Unsigned decimal number, may be quoted
+bool JSON_Skip_Value(JSON_Parser *P);                                               // Any value, objects and arrays included
+bool JSON_Key_Is(const char *Key, unsigned int Key_Length, const char *Name);
+
+// {"CH1":1,"CH3":0,"ALL":1} , the keys are applied in order. Unknown keys are reported and skipped.
+bool JSON_Parse_Channels(JSON_Parser *P, Relay_Mask_t *Open, Relay_Mask_t *Closs, const char *Source);
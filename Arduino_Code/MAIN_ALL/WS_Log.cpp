@@ -0,0 +1,155 @@
+#include "WS_Log.h"
+#include <atomic>
+
+static_assert((Log_Ring_Size & (Log_Ring_Size - 1)) == 0, "Log_Ring_Size has to be a power of two");
+
+typedef struct {
+  std::atomic<uint32_t> Sequence;           // Slot handshake of the bounded MPMC ring
+  const char *Format;                       // Format, or the prefix of a hex dump
+  uint8_t Level;
+  uint8_t Argc;                             // Arguments, Log_Hex_Flag : Length bytes in Args
+  uint8_t Length;
+  uint32_t Args[Log_Args_MAX];
+} Log_Record;
+#define Log_Hex_Flag    0xFF
+
+static Log_Record Log_Ring[Log_Ring_Size];
+static std::atomic<uint32_t> Log_Enqueue_Pos(0);
+static std::atomic<uint32_t> Log_Dequeue_Pos(0);
+static std::atomic<uint32_t> Log_Dropped(0);
+static std::atomic<uint32_t> Log_Budget(0);               // Messages of the current second, reset by LogTask
+
+static bool Log_Initialized = false;
+
+static struct Log_Ring_Setup {                             // Before setup() runs, so WS_LOG() works before Log_Init() (printed once LogTask starts)
+  Log_Ring_Setup() {
+    for (uint32_t i = 0; i < Log_Ring_Size; i++) {
+      Log_Ring[i].Sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+} Log_Ring_Setup_Instance;
+
+// Claims a slot, never blocks and takes no lock (tasks and ISR alike)
+static Log_Record *Log_Claim(uint8_t Level, uint32_t *Pos)
+{
+  if (Level > LOG_ERROR && Log_Budget.fetch_add(1, std::memory_order_relaxed) >= Log_Rate_MAX) {
+    Log_Dropped.fetch_add(1, std::memory_order_relaxed);
+    return NULL;
+  }
+  uint32_t Enqueue = Log_Enqueue_Pos.load(std::memory_order_relaxed);
+  while (1) {
+    Log_Record *Record = &Log_Ring[Enqueue & (Log_Ring_Size - 1)];
+    int32_t Diff = (int32_t)(Record->Sequence.load(std::memory_order_acquire) - Enqueue);
+    if (Diff == 0) {
+      if (Log_Enqueue_Pos.compare_exchange_weak(Enqueue, Enqueue + 1, std::memory_order_relaxed)) {
+        *Pos = Enqueue;
+        return Record;
+      }
+    }
+    else if (Diff < 0) {                                      // Full, LogTask is behind
+      Log_Dropped.fetch_add(1, std::memory_order_relaxed);
+      return NULL;
+    }
+    else
+      Enqueue = Log_Enqueue_Pos.load(std::memory_order_relaxed);
+  }
+}
+static void Log_Publish(Log_Record *Record, uint32_t Pos)
+{
+  Record->Sequence.store(Pos + 1, std::memory_order_release);
+}
+
+bool Log_Push(uint8_t Level, const char *Format, const uint32_t *Args, uint8_t Argc)
+{
+  uint32_t Pos;
+  Log_Record *Record = Log_Claim(Level, &Pos);
+  if (!Record)
+    return false;
+  Record->Format = Format;
+  Record->Level = Level;
+  Record->Argc = Argc;
+  memcpy(Record->Args, Args, Argc * sizeof(uint32_t));
+  Log_Publish(Record, Pos);
+  return true;
+}
+bool Log_Hex(uint8_t Level, const char *Prefix, const uint8_t *Data, size_t Length)
+{
+  uint32_t Pos;
+  Log_Record *Record = Log_Claim(Level, &Pos);
+  if (!Record)
+    return false;
+  Record->Format = Prefix;
+  Record->Level = Level;
+  Record->Argc = Log_Hex_Flag;
+  Record->Length = Length > sizeof(Record->Args) ? sizeof(Record->Args) : Length;
+  memcpy(Record->Args, Data, Record->Length);
+  if (Length > sizeof(Record->Args))
+    Record->Length |= 0x80;                                   // Truncated, printed as "..."
+  Log_Publish(Record, Pos);
+  return true;
+}
+
+static bool Log_Pop(char *Text, size_t Size, int *Length)
+{
+  uint32_t Dequeue = Log_Dequeue_Pos.load(std::memory_order_relaxed);
+  Log_Record *Record;
+  while (1) {
+    Record = &Log_Ring[Dequeue & (Log_Ring_Size - 1)];
+    int32_t Diff = (int32_t)(Record->Sequence.load(std::memory_order_acquire) - (Dequeue + 1));
+    if (Diff == 0) {
+      if (Log_Dequeue_Pos.compare_exchange_weak(Dequeue, Dequeue + 1, std::memory_order_relaxed))
+        break;
+    }
+    else if (Diff < 0)                                        // Empty
+      return false;
+    else
+      Dequeue = Log_Dequeue_Pos.load(std::memory_order_relaxed);
+  }
+  int N;
+  if (Record->Argc == Log_Hex_Flag) {
+    const uint8_t *Data = (const uint8_t *)Record->Args;
+    N = snprintf(Text, Size, "%s", Record->Format);
+    for (int i = 0; i < (Record->Length & 0x7F) && N < (int)Size; i++)
+      N += snprintf(Text + N, Size - N, "%02X ", Data[i]);
+    if (N < (int)Size)
+      N += snprintf(Text + N, Size - N, (Record->Length & 0x80) ? "...\r\n" : "\r\n");
+  }
+  else {
+    const uint32_t *A = Record->Args;                         // Unused arguments are passed too, the format ignores them
+    N = snprintf(Text, Size, Record->Format, A[0], A[1], A[2], A[3], A[4], A[5], A[6], A[7], A[8], A[9], A[10], A[11]);
+  }
+  Record->Sequence.store(Dequeue + Log_Ring_Size, std::memory_order_release);
+  *Length = N < (int)Size ? N : (int)Size - 1;
+  return true;
+}
+
+void Log_Init(void)
+{
+  if (Log_Initialized)
+    return;
+  Log_Initialized = true;
+  Task_Start(Task_Log, LogTask);
+}
+
+void LogTask(void *parameter)
+{
+  static char Text[256];
+  TickType_t Second_Start = xTaskGetTickCount();
+  while(1){
+    int Length;
+    while (Log_Pop(Text, sizeof(Text), &Length)) {
+      Serial.write((const uint8_t *)Text, Length);
+    }
+    uint32_t Dropped = Log_Dropped.exchange(0, std::memory_order_relaxed);
+    if (Dropped) {
+      Length = snprintf(Text, sizeof(Text), "Note : %lu log messages were dropped\r\n", (unsigned long)Dropped);
+      Serial.write((const uint8_t *)Text, Length);
+    }
+    if (xTaskGetTickCount() - Second_Start >= pdMS_TO_TICKS(1000)) {
+      Second_Start = xTaskGetTickCount();
+      Log_Budget.store(0, std::memory_order_relaxed);
+    }
+    vTaskDelay(pdMS_TO_TICKS(Log_Flush_MS));
+  }
+  vTaskDelete(NULL);
+}
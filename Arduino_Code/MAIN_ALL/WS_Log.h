@@ -0,0 +1,60 @@
+#pragma once
+
+#include <Arduino.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <type_traits>
+#include "WS_Tasks.h"
+
+/*************************************************************  Deferred log  *************************************************************/
+// WS_LOG() only stores the format pointer and the raw arguments in a lock-free ring, LogTask formats and prints them
+// at low priority, so a slow USB CDC console never stalls the relay command path.
+// Arguments : integers, chars, enums and pointers (%d %u %x %c %p), %s only with string literals or other static text.
+// Text that lives on the stack has to go through WS_LOG_HEX(), which copies the bytes.
+#define LOG_NONE      0
+#define LOG_ERROR     1
+#define LOG_WARN      2
+#define LOG_INFO      3
+#define LOG_DEBUG     4
+
+// Compile-time level of every module, messages above it are not compiled in
+#ifndef LOG_LEVEL_BLE
+  #define LOG_LEVEL_BLE       LOG_INFO
+#endif
+#ifndef LOG_LEVEL_RELAY
+  #define LOG_LEVEL_RELAY     LOG_INFO
+#endif
+#ifndef LOG_LEVEL_RS485
+  #define LOG_LEVEL_RS485     LOG_INFO
+#endif
+
+#define Log_Ring_Size       64      // Messages waiting for LogTask, power of two
+#define Log_Args_MAX        12      // Arguments of one message, also 4 * Log_Args_MAX bytes of WS_LOG_HEX() data
+#define Log_Rate_MAX        200     // Messages per second below LOG_ERROR, the rest is counted as dropped
+#define Log_Flush_MS        20      // LogTask drains the ring this often (unit: ms)
+
+#define WS_LOG(Module, Level, ...)                                 do { if ((Level) <= LOG_LEVEL_##Module) Log_Write((Level), __VA_ARGS__); } while (0)
+#define WS_LOG_HEX(Module, Level, Prefix, Data, Length)            do { if ((Level) <= LOG_LEVEL_##Module) Log_Hex((Level), (Prefix), (Data), (Length)); } while (0)
+
+bool Log_Push(uint8_t Level, const char *Format, const uint32_t *Args, uint8_t Argc);        // false : the ring was full or the rate was exceeded
+bool Log_Hex(uint8_t Level, const char *Prefix, const uint8_t *Data, size_t Length);          // Prefix, then the bytes as "%02X ", Prefix must be static
+void Log_Init(void);
+void LogTask(void *parameter);
+
+template <typename T>
+static inline uint32_t Log_Arg(T Value)
+{
+  static_assert(std::is_integral<T>::value || std::is_enum<T>::value || std::is_pointer<T>::value, "WS_LOG() arguments : integers, enums and pointers only");
+  static_assert(std::is_pointer<T>::value || sizeof(T) <= 4, "WS_LOG() arguments : 64 bit values are not supported");
+  if constexpr (std::is_pointer<T>::value)
+    return (uint32_t)(uintptr_t)Value;
+  else
+    return (uint32_t)Value;
+}
+template <typename... T>
+static inline bool Log_Write(uint8_t Level, const char *Format, T... Args)
+{
+  static_assert(sizeof...(T) <= Log_Args_MAX, "WS_LOG() : too many arguments");
+  const uint32_t Argv[sizeof...(T) + 1] = {Log_Arg(Args)..., 0};
+  return Log_Push(Level, Format, Argv, sizeof...(T));
+}
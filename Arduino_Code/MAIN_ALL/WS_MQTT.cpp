@@ -1,4 +1,9 @@
 #include "WS_MQTT.h"
+#include <stdarg.h>
+#include <unistd.h>
+#include <sys/select.h>
+#include <sys/eventfd.h>
+#include "esp_vfs_eventfd.h"
 
 // Details about devices on the Waveshare cloud
 const char* mqtt_server = MQTT_Server;
@@ -8,175 +13,340 @@ char pub[] = MQTT_Pub;      // MQTT release topic
 char sub[] = MQTT_Sub;      // MQTT subscribe to topics
 
 
-WiFiClient espClient;       //MQTT initializes the contents
+NetworkClient espClient;    // MQTT socket, runs over whichever link WS_Network made the default (ETH or WiFi)
 PubSubClient client(espClient);
 
-StaticJsonDocument<400> sendJson;
-char msg[MSG_BUFFER_SIZE];
-bool WIFI_Connection_Old = 0;
+char msg[MSG_BUFFER_SIZE];                                            // The publish payload is serialized here
+static int MQTT_Wake_FD = -1;                                         // eventfd, MQTTTask sleeps on it together with the MQTT socket
+
+/********************************************************  Command parser  ********************************************************/
+// Parses the payload where PubSubClient left it, nothing is copied or allocated.
+// Format of data sent back by the server : {"data":{"CH1":1,"CH3":0,"ALL":1}}, the keys are applied in order.
+// {"trace":1} asks for the latency report (see WS_Trace.h) on the publish topic, {"trace":2} also resets it.
+// Returns false when the payload has neither a usable "data" object nor "trace", the masks hold what the message asked for
+bool MQTT_Parse_Command(const byte *payload, unsigned int length, Relay_Mask_t *Open, Relay_Mask_t *Closs, uint32_t *Trace)
+{
+  JSON_Parser P = {payload, length, 0};
+  const char *Key;
+  unsigned int Key_Length;
+  bool Found = false;
+  *Open = 0;
+  *Closs = 0;
+  *Trace = 0;
+  if(!JSON_Expect(&P, '{'))
+    return false;
+  do {                                                                  // Find "data" / "trace" among the top level keys
+    if(!JSON_Parse_Key(&P, &Key, &Key_Length))
+      return false;
+    if(JSON_Key_Is(Key, Key_Length, "data")){
+      if(!JSON_Parse_Channels(&P, Open, Closs, "MQTT"))
+        return false;
+      Found = true;
+    }
+    else if(JSON_Key_Is(Key, Key_Length, "trace")){
+      if(!JSON_Parse_Uint(&P, Trace))
+        return false;
+      Found = true;
+    }
+    else if(!JSON_Skip_Value(&P))
+      return false;
+  } while(JSON_Expect(&P, ','));
+  return Found;
+}
+
+static uint32_t MQTT_Trace_Request = 0;                                // "trace" of the last message, answered by MQTTTask after client.loop()
 
 // MQTT subscribes to callback functions for processing received messages
 void callback(char* topic, byte* payload, unsigned int length) {  
-  uint8_t CH_Flag = 0;
-  String inputString;
-  for (int i = 0; i < length; i++) {
-    inputString += (char)payload[i];
-  }
-  printf("%s\r\n",inputString.c_str());                                     // Format of data sent back by the server {"data":{"CH1":1}}
-  int dataBegin = inputString.indexOf("\"data\"");                          // Finds if "data" is present in the string (quotes also)
-  if (dataBegin == -1) {
-    printf("Missing 'data' field in JSON. - MQTT\r\n");                     
-    return;
-  }
-  int CH_Begin = -1;      
-  if (inputString.indexOf("\"CH1\"", dataBegin) != -1){                     
-    CH_Flag = 1;
-    CH_Begin = inputString.indexOf("\"CH1\"", dataBegin);
-  }
-  else if (inputString.indexOf("\"CH2\"", dataBegin) != -1){             
-    CH_Flag = 2;
-    CH_Begin = inputString.indexOf("\"CH2\"", dataBegin);
-  }  
-  else if (inputString.indexOf("\"CH3\"", dataBegin) != -1){             
-    CH_Flag = 3;
-    CH_Begin = inputString.indexOf("\"CH3\"", dataBegin);
-  }  
-  else if (inputString.indexOf("\"CH4\"", dataBegin) != -1){             
-    CH_Flag = 4;
-    CH_Begin = inputString.indexOf("\"CH4\"", dataBegin);
-  }  
-  else if (inputString.indexOf("\"CH5\"", dataBegin) != -1){             
-    CH_Flag = 5;
-    CH_Begin = inputString.indexOf("\"CH5\"", dataBegin);
-  }   
-  else if (inputString.indexOf("\"CH6\"", dataBegin) != -1){             
-    CH_Flag = 6;
-    CH_Begin = inputString.indexOf("\"CH6\"", dataBegin);
-  }   
-  else if (inputString.indexOf("\"CH7\"", dataBegin) != -1){             
-    CH_Flag = 7;
-    CH_Begin = inputString.indexOf("\"CH7\"", dataBegin);
-  }   
-  else if (inputString.indexOf("\"CH8\"", dataBegin) != -1){             
-    CH_Flag = 8;
-    CH_Begin = inputString.indexOf("\"CH8\"", dataBegin);
-  }   
-  else if (inputString.indexOf("\"ALL\"", dataBegin) != -1){             
-    CH_Flag = 9;
-    CH_Begin = inputString.indexOf("\"ALL\"", dataBegin);
-  }   
-  else{
+  Relay_Mask_t Open, Closs;
+  uint32_t Trace;
+  printf("%.*s\r\n", length, (const char *)payload);
+  if(!MQTT_Parse_Command(payload, length, &Open, &Closs, &Trace)){
     printf("Note : Non-instruction data was received - MQTT!\r\n");
-    CH_Flag = 0;
     return;
   }
-  int valueBegin = inputString.indexOf(':', CH_Begin);
-  int valueEnd = inputString.indexOf('}', valueBegin);
-  if (valueBegin != -1 && valueEnd != -1) {
-    if(CH_Flag != 0)
-    {
-      String ValueStr = inputString.substring(valueBegin + 1, valueEnd);
-      int Value = ValueStr.toInt();
-      if(CH_Flag < 9){
-        if(Value == 1 && Relay_Flag[CH_Flag - 1] == 0){
-          uint8_t Data[1]={CH_Flag+48};
-          Relay_Analysis(Data,MQTT_Mode);
-        }
-        else if(Value == 0 && Relay_Flag[CH_Flag - 1] == 1){
-          uint8_t Data[1]={CH_Flag+48};
-          Relay_Analysis(Data,MQTT_Mode);
-        }
-      }
-      else if(CH_Flag == 9){
-        if(Value == 1 && ((Relay_Flag[0] & Relay_Flag[1] & Relay_Flag[2] & Relay_Flag[3] & Relay_Flag[4] & Relay_Flag[5] & Relay_Flag[6] & Relay_Flag[7]) == 0)){
-          uint8_t Data[1]={9+48};
-          Relay_Analysis(Data,MQTT_Mode);
-        }
-        else if(Value == 0 && ((Relay_Flag[0] | Relay_Flag[1] | Relay_Flag[2] | Relay_Flag[3] | Relay_Flag[4] | Relay_Flag[5] | Relay_Flag[6] | Relay_Flag[7] )== 1)){
-          uint8_t Data[1]={0+48};
-          Relay_Analysis(Data,MQTT_Mode);
-        }
-      }
-    }
-  }
+  if(Open || Closs)
+    Relay_Immediate_Masks(Open, Closs, MQTT_Mode);                     // All channels of the message switch in one batch
+  if(Trace)
+    MQTT_Trace_Request = Trace;
 }
 
 
-// Reconnect to the MQTT server
-void reconnect(void) {
-  uint8_t Count = 0;
-  while (!client.connected()) {
-    Count++;    
-    if (client.connect(ID)) {
-      client.subscribe(sub);
-      printf("Waveshare Cloud connection is successful and now you can use all features.\r\n"); 
-    } 
-    else{
-      delay(500);
-      if(Count % 2 == 0 && Count != 0){ 
-        printf("%d\r\n", client.state());     
-        //RGB_Open_Time(50, 0, 50, 1000, 0); 
-      } 
-      if(Count % 10 == 0){                               // 10 attempts failed to connect, cancel the connection, try again
-        client.disconnect();
-        delay(100);
-        client.setServer(mqtt_server, PORT);
-        delay(100);
-        client.setCallback(callback);
-        delay(100);
-      }
-      if(Count > 32){                                   // connection fail
-        Count = 0;
-        printf("warning: Waveshare cloud connection fails. Currently, only Bluetooth control is available !!!\r\n"); 
-      } 
+/********************************************************  State publish  ********************************************************/
+// Only what the broker has not seen yet is published : {"ID":"fc2d8db5","data":{"CH3":1},"DIN":{"DIN3":0}}
+static Relay_Mask_t MQTT_Relay_Sent = 0;       // Relay state of the last successful publish
+static uint8_t MQTT_DIN_Sent = 0;              // DIN state of the last successful publish
+static bool MQTT_State_Sent = false;           // false : the next publish carries every channel (after connecting)
+static bool MQTT_Change_Pending = false;
+static uint32_t MQTT_Change_Time = 0;          // When the oldest unpublished change was seen
+static uint32_t MQTT_Publish_Time = 0;
 
+static int MQTT_Append(char *Text, int Size, int Length, const char *Format, ...)
+{
+  if(Length < 0 || Length >= Size)
+    return -1;
+  va_list Args;
+  va_start(Args, Format);
+  int n = vsnprintf(Text + Length, Size - Length, Format, Args);
+  va_end(Args);
+  return (n < 0 || Length + n >= Size) ? -1 : Length + n;
+}
+int MQTT_Serialize_State(char *Text, int Size, Relay_Mask_t Relay, Relay_Mask_t Relay_Changed, uint8_t DIN, uint8_t DIN_Changed)
+{
+  int Length = MQTT_Append(Text, Size, 0, "{\"ID\":\"%s\"", ID);
+  if(Relay_Changed){
+    char Separator = '{';
+    Length = MQTT_Append(Text, Size, Length, ",\"data\":");
+    for (int i = 0; i < Relay_Number_MAX; i++) {
+      if((Relay_Changed >> i) & 0x01){
+        Length = MQTT_Append(Text, Size, Length, "%c\"%s\":%d", Separator, Relay_Channels.CH[i].Name, (int)((Relay >> i) & 0x01));
+        Separator = ',';
+      }
+    }
+    Length = MQTT_Append(Text, Size, Length, "}");
+  }
+  if(DIN_Changed){
+    char Separator = '{';
+    Length = MQTT_Append(Text, Size, Length, ",\"DIN\":");
+    for (int i = 0; i < 8; i++) {
+      if((DIN_Changed >> i) & 0x01){
+        Length = MQTT_Append(Text, Size, Length, "%c\"DIN%d\":%d", Separator, i + 1, (DIN >> i) & 0x01);
+        Separator = ',';
+      }
     }
+    Length = MQTT_Append(Text, Size, Length, "}");
+  }
+  return MQTT_Append(Text, Size, Length, "}");
+}
+static bool MQTT_Publish_State(Relay_Mask_t Relay, Relay_Mask_t Relay_Changed, uint8_t DIN, uint8_t DIN_Changed)
+{
+  int Length = MQTT_Serialize_State(msg, sizeof(msg), Relay, Relay_Changed, DIN, DIN_Changed);
+  if(Length < 0){
+    printf("MQTT_Publish_State(function): msg[] is too small for the state!!!!\r\n");
+    return false;
+  }
+  return client.publish(pub, (const uint8_t *)msg, Length, false);
+}
+// Called from MQTTTask while connected. Bursts (e.g. DIN mirroring four channels in one scan) are collected
+// for MQTT_Publish_Coalesce_MS, and a change that is undone before it was published is never sent.
+// Returns how long MQTTTask may sleep before it has to call again (unit: ms, -1: until the next change).
+static int32_t MQTT_Publish_Changes(void)
+{
+  Relay_Mask_t Relay = Relay_Get_PinState();
+  uint8_t DIN = DIN_Data;
+  Relay_Mask_t Relay_Changed = MQTT_State_Sent ? (Relay_Mask_t)(Relay ^ MQTT_Relay_Sent) : Relay_Channels.All;
+  uint8_t DIN_Changed = MQTT_State_Sent ? (uint8_t)(DIN ^ MQTT_DIN_Sent) : 0xFF;
+  if(!Relay_Changed && !DIN_Changed){
+    MQTT_Change_Pending = false;
+    return -1;
+  }
+  uint32_t Now = millis();
+  if(!MQTT_Change_Pending){
+    MQTT_Change_Pending = true;
+    MQTT_Change_Time = Now;
+  }
+  int32_t Coalesce = MQTT_Publish_Coalesce_MS - (int32_t)(Now - MQTT_Change_Time);
+  int32_t Interval = MQTT_Publish_Interval_MS - (int32_t)(Now - MQTT_Publish_Time);
+  if(Coalesce > 0 || Interval > 0)
+    return Coalesce > Interval ? Coalesce : Interval;
+  MQTT_Publish_Time = Now;
+  if(!MQTT_Publish_State(Relay, Relay_Changed, DIN, DIN_Changed))
+    return MQTT_Publish_Interval_MS;                                    // Try again later, the changes stay pending
+  MQTT_Relay_Sent = Relay;
+  MQTT_DIN_Sent = DIN;
+  MQTT_State_Sent = true;
+  MQTT_Change_Pending = false;
+  return -1;
+}
+// {"ID":"fc2d8db5","trace":[...]} , streamed item by item, the report does not have to fit msg[]
+static bool MQTT_Publish_Trace(bool Reset)
+{
+  Trace_Report Report;
+  char Text[Trace_Item_Size];
+  Trace_Get_Report(&Report);
+  if(Reset)
+    Trace_Reset();
+  unsigned int Length = snprintf(Text, sizeof(Text), "{\"ID\":\"%s\",\"trace\":", ID) + 1;
+  for (int i = 0, n; (n = Trace_Format(&Report, i, Text, sizeof(Text))) >= 0; i++) {
+    Length += n;
+  }
+  if(!client.beginPublish(pub, Length, false))
+    return false;
+  client.write((const uint8_t *)Text, snprintf(Text, sizeof(Text), "{\"ID\":\"%s\",\"trace\":", ID));
+  for (int i = 0, n; (n = Trace_Format(&Report, i, Text, sizeof(Text))) >= 0; i++) {
+    client.write((const uint8_t *)Text, n);
   }
+  client.write((const uint8_t *)"}", 1);
+  return client.endPublish();
 }
 // Send data in JSON format to MQTT server
 void sendJsonData(void) {
-  sendJson["ID"] = ID;
-  String pubres;
-  serializeJson(sendJson, pubres);
-  int str_len = pubres.length() + 1;
-  char char_array[str_len];
-  pubres.toCharArray(char_array, str_len);
-  client.publish(pub, char_array);
+  MQTT_Publish_State(Relay_Get_PinState(), Relay_Channels.All, DIN_Data, 0xFF);
+}
+
+/********************************************************  Connection  ********************************************************/
+// One connection attempt, MQTTTask spaces the attempts out with MQTT_Backoff()
+bool reconnect(void) {
+  if (!client.connect(ID)) {
+    printf("MQTT connection failed, state %d\r\n", client.state());
+    return false;
+  }
+  espClient.setNoDelay(true);                                           // Small command / state packets, no Nagle delay
+  client.subscribe(sub);
+  MQTT_State_Sent = false;                                              // The broker gets the complete state once after every connection
+  printf("Waveshare Cloud connection is successful and now you can use all features.\r\n"); 
+  return true;
+}
+static uint32_t MQTT_Backoff(uint32_t *Backoff_MS)                      // Retry delay with +-25% jitter, so a fleet does not reconnect in lockstep
+{
+  uint32_t Delay = *Backoff_MS * 3 / 4 + esp_random() % (*Backoff_MS / 2 + 1);
+  *Backoff_MS = (*Backoff_MS >= MQTT_Backoff_Max_MS / 2) ? MQTT_Backoff_Max_MS : *Backoff_MS * 2;
+  return Delay;
+}
+
+void MQTT_Notify(void)
+{
+  uint64_t One = 1;
+  if(MQTT_Wake_FD >= 0)
+    write(MQTT_Wake_FD, &One, sizeof(One));
+}
+static void MQTT_Network_Changed(Network_Link Link)
+{
+  MQTT_Notify();
+}
+static void MQTT_Relay_Changed(Relay_Mask_t PinState)
+{
+  MQTT_Notify();
+}
+static void MQTT_DIN_Changed(uint8_t Data)
+{
+  MQTT_Notify();
+}
+
+// Sleeps until the socket is readable, MQTT_Notify() was called or Wait_MS passed (-1: no timeout)
+static void MQTT_Wait(int Socket, int32_t Wait_MS)
+{
+  if(MQTT_Wake_FD < 0){                                                 // No eventfd : fall back to a short poll
+    vTaskDelay(pdMS_TO_TICKS(10));
+    return;
+  }
+  fd_set Read_Set;
+  FD_ZERO(&Read_Set);
+  FD_SET(MQTT_Wake_FD, &Read_Set);
+  int Max_FD = MQTT_Wake_FD;
+  if(Socket >= 0){
+    FD_SET(Socket, &Read_Set);
+    if(Socket > Max_FD)
+      Max_FD = Socket;
+  }
+  struct timeval Timeout = {Wait_MS / 1000, (Wait_MS % 1000) * 1000};
+  if(select(Max_FD + 1, &Read_Set, NULL, NULL, Wait_MS < 0 ? NULL : &Timeout) > 0 && FD_ISSET(MQTT_Wake_FD, &Read_Set)){
+    uint64_t Count;
+    read(MQTT_Wake_FD, &Count, sizeof(Count));
+  }
 }
 
+typedef enum {
+  MQTT_Offline = 0,     // No network, sleep until WS_Network reports a link
+  MQTT_Waiting = 1,     // Network is up, waiting for the next connection attempt
+  MQTT_Online = 2,      // Connected to the broker
+} MQTT_State;
+
 void MQTTTask(void *parameter) {
-  bool WIFI_Connection_Old;
+  MQTT_State State = MQTT_Offline;
+  uint32_t Backoff_MS = MQTT_Backoff_Min_MS;
+  uint32_t Retry_Time = 0;
+  uint32_t Generation = 0;                                              // Link the broker connection was made on
+  client.setServer(mqtt_server, PORT);
+  client.setCallback(callback);
+  client.setKeepAlive(MQTT_Keep_Alive_S);
+  client.setSocketTimeout(MQTT_Socket_Timeout_S);
   while(1){
-    if(WIFI_Connection == 1)
-    { 
-      if(!WIFI_Connection_Old){
-        WIFI_Connection_Old = 1;
-        client.setServer(mqtt_server, PORT);
-        client.setCallback(callback);
-      }
-      if (!client.connected()) {
-        reconnect();
-      }
-      client.loop();
-    }
-    else{
-      WIFI_Connection_Old = 0;
+    int32_t Wait_MS = -1;
+    int Socket = -1;
+    switch(State)
+    {
+      case MQTT_Offline:
+        if(Network_Connected()){
+          State = MQTT_Waiting;
+          Backoff_MS = MQTT_Backoff_Min_MS;
+          Retry_Time = millis();
+          Wait_MS = 0;
+        }
+        break;
+      case MQTT_Waiting:
+        if(!Network_Connected()){
+          State = MQTT_Offline;
+          break;
+        }
+        if((int32_t)(millis() - Retry_Time) >= 0){
+          Generation = Network_Generation();
+          if(reconnect()){
+            State = MQTT_Online;
+            Backoff_MS = MQTT_Backoff_Min_MS;
+            Wait_MS = 0;
+            break;
+          }
+          uint32_t Delay = MQTT_Backoff(&Backoff_MS);
+          printf("MQTT : next connection attempt in %lu ms\r\n", (unsigned long)Delay);
+          Retry_Time = millis() + Delay;
+        }
+        Wait_MS = (int32_t)(Retry_Time - millis());
+        if(Wait_MS < 0)
+          Wait_MS = 0;
+        break;
+      case MQTT_Online:
+        if(Generation != Network_Generation()){                         // Failover : the socket belongs to the old link
+          printf("MQTT : network link changed, reconnecting over %s\r\n", Network_Link_Name(Network_Active()));
+          client.disconnect();
+          State = Network_Connected() ? MQTT_Waiting : MQTT_Offline;
+          Backoff_MS = MQTT_Backoff_Min_MS;
+          Retry_Time = millis();
+          Wait_MS = 0;
+          break;
+        }
+        if(!client.loop()){                                             // loop() reads at most one packet and serves the keep alive
+          printf("MQTT connection lost\r\n");
+          client.disconnect();
+          State = Network_Connected() ? MQTT_Waiting : MQTT_Offline;
+          Retry_Time = millis() + MQTT_Backoff(&Backoff_MS);
+          Wait_MS = 0;
+          break;
+        }
+        if(MQTT_Trace_Request){
+          if(!MQTT_Publish_Trace(MQTT_Trace_Request == 2))
+            printf("MQTT_Publish_Trace(function): the trace report could not be published!!!!\r\n");
+          MQTT_Trace_Request = 0;
+        }
+        Wait_MS = MQTT_Publish_Changes();
+        if(Wait_MS < 0 || Wait_MS > MQTT_Idle_Wake_MS)
+          Wait_MS = MQTT_Idle_Wake_MS;
+        if(espClient.available() > 0)                                   // Already buffered by the client, select() would not see it
+          Wait_MS = 0;
+        Socket = espClient.fd();
+        break;
     }
-    vTaskDelay(pdMS_TO_TICKS(10));
+    if(Wait_MS)
+      MQTT_Wait(Socket, Wait_MS);
   }
   vTaskDelete(NULL);
 }
 void MQTT_Init(void)
 {
-  WIFI_Init();
-  xTaskCreatePinnedToCore(
-    MQTTTask,    
-    "MQTTTask",   
-    4096,                
-    NULL,                 
-    3,                   
-    NULL,                 
-    0                   
-  );
+  Network_Init();
+  WIFI_Init();                                                          // Fallback link, ETH is used whenever it is up
+  const uint16_t Publish_Size = MSG_BUFFER_SIZE + sizeof(pub) + 8;    // Fixed header + topic + payload
+  const uint16_t Command_Size = MQTT_Command_MAX + sizeof(sub) + 8;     // Inbound messages share the buffer, never below the PubSubClient default
+  client.setBufferSize(Publish_Size > Command_Size ? Publish_Size : Command_Size);   // Allocated once here
+  esp_vfs_eventfd_config_t Eventfd_Config = ESP_VFS_EVENTD_CONFIG_DEFAULT();
+  esp_err_t ret = esp_vfs_eventfd_register(&Eventfd_Config);
+  if(ret == ESP_OK || ret == ESP_ERR_INVALID_STATE)                    // ESP_ERR_INVALID_STATE : already registered by another module
+    MQTT_Wake_FD = eventfd(0, 0);
+  if(MQTT_Wake_FD < 0)
+    printf("MQTT_Init(function): eventfd is not available, MQTTTask falls back to polling!!!!\r\n");
+  Network_Add_Listener(MQTT_Network_Changed);
+  Relay_Add_Listener(MQTT_Relay_Changed);
+  DIN_Add_Listener(MQTT_DIN_Changed);
+  Task_Start(Task_MQTT, MQTTTask);
 }
 
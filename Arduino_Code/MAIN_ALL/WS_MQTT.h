@@ -1,6 +1,5 @@
 #pragma once
 
-#include <ArduinoJson.h>
 #include <Arduino.h>
 #include <PubSubClient.h>
 #include <WiFi.h>
@@ -8,15 +7,31 @@
 #include "WS_GPIO.h"
 #include "WS_Information.h"
 #include "WS_Relay.h"
+#include "WS_DIN.h"
+#include "WS_JSON.h"
 #include "WS_WIFI.h"
+#include "WS_Network.h"
+#include "WS_Tasks.h"
 
-#define MSG_BUFFER_SIZE (50)
+#define MSG_BUFFER_SIZE (48 + Relay_Number_MAX * 9 + 8 * 10)   // {"ID":"...","data":{"CHx":1,...},"DIN":{"DINx":1,...}} with every channel
+#define MQTT_Command_MAX            256   // Largest accepted command payload, PubSubClient receives into the publish buffer (unit: bytes)
+#define MQTT_Publish_Coalesce_MS    20    // Changes seen within this time after the first one go out in one publish (unit: ms)
+#define MQTT_Publish_Interval_MS    200   // Minimum time between two state publishes (unit: ms)
+
+#define MQTT_Backoff_Min_MS         500   // First retry after a failed connection (unit: ms)
+#define MQTT_Backoff_Max_MS         60000 // The retry interval doubles up to this value (unit: ms)
+#define MQTT_Keep_Alive_S           15    // MQTT keep alive (unit: s)
+#define MQTT_Socket_Timeout_S       3     // Longest wait for CONNACK during client.connect() (unit: s)
+#define MQTT_Idle_Wake_MS           1000  // Wake up at least this often while connected to serve the keep alive (unit: ms)
 
 
 void WIFI_Init(void);
 void WifiStaTask(void *parameter);
 void callback(char* topic, byte* payload, unsigned int length);   // MQTT subscribes to callback functions for processing received messages
-void reconnect(void);                                                 // Reconnect to the MQTT server
-void sendJsonData(void);                                              // Send data in JSON format to MQTT server
+bool reconnect(void);                                                 // One connection attempt to the MQTT server
+void sendJsonData(void);                                              // Send the complete relay and DIN state in JSON format to MQTT server
 void MQTT_Init(void);
+void MQTT_Notify(void);                                               // Wakes MQTTTask (link or state change)
+bool MQTT_Parse_Command(const byte *payload, unsigned int length, Relay_Mask_t *Open, Relay_Mask_t *Closs, uint32_t *Trace);   // In place, no copy
+int MQTT_Serialize_State(char *Text, int Size, Relay_Mask_t Relay, Relay_Mask_t Relay_Changed, uint8_t DIN, uint8_t DIN_Changed);   // -1 : Text too small
 
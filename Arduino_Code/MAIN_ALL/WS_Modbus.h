@@ -0,0 +1,77 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*************************************************************  Modbus RTU  *************************************************************/
+#define Modbus_Local_ID           0x06      // Slave address of this board on RS485
+#define Modbus_Extension_ID       0x01      // Slave address of the first Modbus RTU Relay expansion board
+
+#define Modbus_Broadcast_ID       0x00      // Writes to this address are executed by every slave, nobody answers
+
+#define Modbus_Read_Coils         0x01      // Function code : read coils
+#define Modbus_Write_Coil         0x05      // Function code : write single coil
+#define Modbus_Write_Coils        0x0F      // Function code : write multiple coils
+#define Modbus_Exception          0x80      // Set in the function code of an exception response
+
+#define Modbus_Illegal_Function   0x01      // Exception codes
+#define Modbus_Illegal_Address    0x02
+#define Modbus_Illegal_Value      0x03
+
+#define Modbus_Coil_All           0x00FF    // Vendor coil address : all channels
+#define Modbus_Coil_Toggle        0x5500    // Vendor coil value : toggle the coil
+#define Modbus_Coil_All_ON        0xFF00    // Coil value : all channels on (this board)
+#define Modbus_Extension_All_ON   0xFFFF    // Coil value for Modbus_Coil_All : all channels on (expansion board)
+#define Modbus_Coil_OFF           0x0000    // Coil value : off
+
+#define Modbus_Frame_Length       8         // Address + function + 4 data bytes + CRC16
+#define Modbus_ADU_MAX            256       // Longest RTU frame
+
+typedef struct {
+  uint8_t Byte[Modbus_Frame_Length];
+} Modbus_Frame;
+
+struct Modbus_CRC_Table {                   // CRC of every byte value, generated by the compiler and kept in flash
+  uint16_t Entry[256];
+  constexpr Modbus_CRC_Table() : Entry()
+  {
+    for (int i = 0; i < 256; i++) {
+      uint16_t CRC = i;
+      for (int j = 0; j < 8; j++)
+        CRC = (CRC & 0x0001) ? (CRC >> 1) ^ 0xA001 : CRC >> 1;
+      Entry[i] = CRC;
+    }
+  }
+};
+inline constexpr Modbus_CRC_Table Modbus_CRC_Lookup;
+
+constexpr uint16_t Modbus_CRC16(const uint8_t *Data, size_t Length)   // CRC16/MODBUS, the low byte is sent first
+{
+  uint16_t CRC = 0xFFFF;
+  for (size_t i = 0; i < Length; i++)
+    CRC = (CRC >> 8) ^ Modbus_CRC_Lookup.Entry[(CRC ^ Data[i]) & 0xFF];
+  return CRC;
+}
+
+constexpr Modbus_Frame Modbus_Make_Frame(uint8_t ID, uint8_t Function, uint16_t Address, uint16_t Value)
+{
+  Modbus_Frame Frame = {{ID, Function, (uint8_t)(Address >> 8), (uint8_t)Address, (uint8_t)(Value >> 8), (uint8_t)Value, 0, 0}};
+  uint16_t CRC = Modbus_CRC16(Frame.Byte, Modbus_Frame_Length - 2);
+  Frame.Byte[6] = (uint8_t)CRC;
+  Frame.Byte[7] = (uint8_t)(CRC >> 8);
+  return Frame;
+}
+
+constexpr bool Modbus_Frame_Equal(const Modbus_Frame &Frame, const uint8_t *Data)
+{
+  for (int i = 0; i < Modbus_Frame_Length; i++) {
+    if(Frame.Byte[i] != Data[i])
+      return false;
+  }
+  return true;
+}
+
+constexpr bool Modbus_CRC_Valid(const uint8_t *Data, size_t Length)   // Frame including its CRC
+{
+  return Length >= 4 && Modbus_CRC16(Data, Length - 2) == (uint16_t)(Data[Length - 2] | (Data[Length - 1] << 8));
+}
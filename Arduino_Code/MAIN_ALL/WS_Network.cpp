@@ -0,0 +1,106 @@
+#include "WS_Network.h"
+#include <atomic>
+
+// MQTT and the web server do not care which interface carries them. The NetworkClient sockets follow the
+// lwIP default route, so this module only decides which link is the default : ETH whenever it has an
+// address, WiFi otherwise. Every switch bumps the generation so that long lived connections reconnect.
+char ipStr[16] = "";
+
+static volatile bool ETH_Up = false;
+static volatile bool WIFI_Up = false;
+static std::atomic<uint8_t> Network_Link_Active(Network_None);
+static std::atomic<uint32_t> Network_Link_Generation(0);
+
+static Network_Listener Network_Listeners[Network_Listener_MAX];
+static std::atomic<uint8_t> Network_Listener_Count(0);
+static portMUX_TYPE Network_Listener_Lock = portMUX_INITIALIZER_UNLOCKED;
+
+bool Network_Add_Listener(Network_Listener Listener)
+{
+  bool Result = 0;
+  portENTER_CRITICAL(&Network_Listener_Lock);
+  uint8_t Count = Network_Listener_Count.load(std::memory_order_relaxed);
+  if(Count < Network_Listener_MAX){
+    Network_Listeners[Count] = Listener;
+    Network_Listener_Count.store(Count + 1, std::memory_order_release);
+    Result = 1;
+  }
+  portEXIT_CRITICAL(&Network_Listener_Lock);
+  if(!Result)
+    printf("Network_Add_Listener(function): No free listener slot!!!!\r\n");
+  return Result;
+}
+
+Network_Link Network_Active(void)
+{
+  return (Network_Link)Network_Link_Active.load(std::memory_order_acquire);
+}
+bool Network_Connected(void)
+{
+  return Network_Active() != Network_None;
+}
+uint32_t Network_Generation(void)
+{
+  return Network_Link_Generation.load(std::memory_order_acquire);
+}
+const char *Network_Link_Name(Network_Link Link)
+{
+  switch(Link)
+  {
+    case Network_ETH:   return "ETH";
+    case Network_WIFI:  return "WIFI";
+    default:            return "None";
+  }
+}
+
+static void Network_Select(void)
+{
+  Network_Link Link = ETH_Up ? Network_ETH : (WIFI_Up ? Network_WIFI : Network_None);
+  if(Link == Network_Active())
+    return;
+  IPAddress IP;
+  if(Link == Network_ETH){
+    ETH.setDefault();
+    IP = ETH.localIP();
+  }
+  else if(Link == Network_WIFI){
+    WiFi.STA.setDefault();
+    IP = WiFi.localIP();
+  }
+  if(Link != Network_None)
+    snprintf(ipStr, sizeof(ipStr), "%d.%d.%d.%d", IP[0], IP[1], IP[2], IP[3]);
+  else
+    ipStr[0] = '\0';
+  Network_Link_Active.store(Link, std::memory_order_release);
+  Network_Link_Generation.fetch_add(1, std::memory_order_acq_rel);
+  printf("Network : active link %s %s\r\n", Network_Link_Name(Link), ipStr);
+  uint8_t Count = Network_Listener_Count.load(std::memory_order_acquire);
+  for (uint8_t i = 0; i < Count; i++) {
+    Network_Listeners[i](Link);
+  }
+}
+
+static void Network_Event(arduino_event_id_t event, arduino_event_info_t info)
+{
+  switch (event) {
+    case ARDUINO_EVENT_ETH_GOT_IP:            ETH_Up = true;    break;
+    case ARDUINO_EVENT_ETH_LOST_IP:
+    case ARDUINO_EVENT_ETH_DISCONNECTED:
+    case ARDUINO_EVENT_ETH_STOP:              ETH_Up = false;   break;
+    case ARDUINO_EVENT_WIFI_STA_GOT_IP:       WIFI_Up = true;   break;
+    case ARDUINO_EVENT_WIFI_STA_LOST_IP:
+    case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+    case ARDUINO_EVENT_WIFI_STA_STOP:         WIFI_Up = false;  break;
+    default: return;
+  }
+  Network_Select();
+}
+
+void Network_Init(void)
+{
+  static bool Initialized = false;
+  if(Initialized)
+    return;
+  Initialized = true;
+  Network.onEvent(Network_Event);           // Before ETH.begin() / WiFi.begin(), the first GOT_IP must not be missed
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ETH.h>
+#include <WiFi.h>
+
+#define Network_Listener_MAX      4       // Modules that can be told about a change of the active link
+
+typedef enum {
+  Network_None = 0,         // No link has an address
+  Network_ETH  = 1,         // W5500, always preferred while it has an address
+  Network_WIFI = 2,         // WiFi STA, used while ETH is down
+} Network_Link;
+
+typedef void (*Network_Listener)(Network_Link Link);   // Runs in the Arduino event task, must not block
+
+extern char ipStr[16];                    // Address of the active link, "" while offline
+
+void Network_Init(void);
+Network_Link Network_Active(void);
+bool Network_Connected(void);
+uint32_t Network_Generation(void);        // Changes with every switch of the active link, sockets opened before it are stale
+const char *Network_Link_Name(Network_Link Link);
+bool Network_Add_Listener(Network_Listener Listener);
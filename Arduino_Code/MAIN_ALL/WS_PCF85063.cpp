@@ -1,14 +1,81 @@
 #include "WS_PCF85063.h"
+#include <time.h>
 
-datetime_t datetime= {0};
 datetime_t Update_datetime= {0};
 static uint8_t decToBcd(int val);
 static int bcdToDec(uint8_t val);
 
+/********************************************************  Time service  ********************************************************/
+// One PCF85063 reading plus esp_timer replaces the 100 ms polling of the RTC.
+// Once SNTP has set the system clock that is the source, the RTC only mirrors it.
+static portMUX_TYPE Time_Lock = portMUX_INITIALIZER_UNLOCKED;
+static bool Time_Base_Valid = false;
+static uint32_t Time_Base_Epoch = 0;        // Last PCF85063 reading
+static int64_t Time_Base_Us = 0;            // esp_timer_get_time() when it was read
+
+static void Time_Set_Base(uint32_t Epoch)
+{
+  int64_t Us = esp_timer_get_time();
+  portENTER_CRITICAL(&Time_Lock);
+  Time_Base_Epoch = Epoch;
+  Time_Base_Us = Us;
+  Time_Base_Valid = true;
+  portEXIT_CRITICAL(&Time_Lock);
+}
+static bool Time_Refresh(void)
+{
+  datetime_t Time;
+  if(!PCF85063_Read_Time(&Time))
+    return false;
+  Time_Set_Base(datetime_to_epoch(Time));
+  return true;
+}
+bool Time_Get_Epoch(uint32_t *epoch)
+{
+  time_t now = time(nullptr);
+  if(now > Time_System_Valid_Epoch){
+    *epoch = (uint32_t)now;
+    return true;
+  }
+  portENTER_CRITICAL(&Time_Lock);
+  bool Valid = Time_Base_Valid;
+  uint32_t Epoch = Time_Base_Epoch;
+  int64_t Us = Time_Base_Us;
+  portEXIT_CRITICAL(&Time_Lock);
+  if(!Valid)
+    return false;
+  *epoch = Epoch + (uint32_t)((esp_timer_get_time() - Us) / 1000000);
+  return true;
+}
+bool Time_Get(datetime_t *time)
+{
+  uint32_t Epoch;
+  if(!Time_Get_Epoch(&Epoch))
+    return false;
+  epoch_to_datetime(Epoch, time);
+  return true;
+}
+void Time_Set(datetime_t time)
+{
+  PCF85063_Set_All(time);
+  Time_Set_Base(datetime_to_epoch(time));
+}
+void Time_Maintain(void)
+{
+  if(time(nullptr) > Time_System_Valid_Epoch)
+    return;
+  portENTER_CRITICAL(&Time_Lock);
+  bool Due = !Time_Base_Valid || esp_timer_get_time() - Time_Base_Us >= (int64_t)PCF85063_Resync_S * 1000000;
+  portEXIT_CRITICAL(&Time_Lock);
+  if(Due)
+    Time_Refresh();
+}
 
 void Time_printf(void *parameter) {
   while(1){
     char datetime_str[50];
+    datetime_t datetime = {0};
+    Time_Get(&datetime);
     datetime_to_str(datetime_str,datetime);
     printf("Time:%s\r\n",datetime_str);
     vTaskDelay(pdMS_TO_TICKS(500));
@@ -35,15 +102,8 @@ void PCF85063_Init(void)      // PCF85063 initialized
   // Update_datetime.minute = 50;
   // Update_datetime.second = 0;
   // PCF85063_Set_All(Update_datetime);
-  xTaskCreatePinnedToCore(
-    PCF85063Task,    
-    "PCF85063Task",   
-    4096,                
-    NULL,                 
-    3,                   
-    NULL,                 
-    0                   
-  );  
+  if(!Time_Refresh())
+    printf("PCF85063 : The time is unknown until SNTP sets it\r\n");
   // xTaskCreatePinnedToCore(
   //   Time_printf,    
   //   "Time_printf",   
@@ -55,14 +115,6 @@ void PCF85063_Init(void)      // PCF85063 initialized
   // );
 }
 
-void PCF85063Task(void *parameter) {
-  while(1){
-    PCF85063_Read_Time(&datetime);
-    vTaskDelay(pdMS_TO_TICKS(100));
-  }
-  vTaskDelete(NULL);
-}
-
 void PCF85063_Reset()  // Reset PCF85063
 {
 	uint8_t Value = RTC_CTRL_1_DEFAULT|RTC_CTRL_1_CAP_SEL|RTC_CTRL_1_SR;
@@ -104,12 +156,14 @@ void PCF85063_Set_All(datetime_t time) // Set Time And Date
 		printf("PCF85063 : Failed to set the date and time\r\n");
 }
 
-void PCF85063_Read_Time(datetime_t *time) // Read Time And Date
+bool PCF85063_Read_Time(datetime_t *time) // Read Time And Date
 {
 	uint8_t buf[7] = {0};
 	esp_err_t ret = I2C_Read(PCF85063_ADDRESS, RTC_SECOND_ADDR, buf, sizeof(buf));
-	if(ret != ESP_OK)
+	if(ret != ESP_OK){
 		printf("PCF85063 : Time read failure\r\n");
+		return false;
+	}
 	else{
 		time->second = bcdToDec(buf[0] & 0x7F);
 		time->minute = bcdToDec(buf[1] & 0x7F);
@@ -119,6 +173,9 @@ void PCF85063_Read_Time(datetime_t *time) // Read Time And Date
 		time->month = bcdToDec(buf[5] & 0x1F);
 		time->year = bcdToDec(buf[6]) + YEAR_OFFSET;
 	}
+	if(buf[0] & 0x80)                               // OS flag : the oscillator stopped, the time is not valid
+		return false;
+	return time->year >= 2000 && time->month >= 1 && time->month <= 12 && time->day >= 1 && time->day <= 31;
 }
 
 void PCF85063_Enable_Alarm() // Enable Alarm and Clear Alarm flag
@@ -130,6 +187,14 @@ void PCF85063_Enable_Alarm() // Enable Alarm and Clear Alarm flag
 		printf("PCF85063 : Failed to enable Alarm Flag and Clear Alarm Flag \r\n");
 }
 
+void PCF85063_Disable_Alarm() // Disable Alarm and Clear Alarm flag
+{
+	uint8_t Value = RTC_CTRL_2_DEFAULT;
+	esp_err_t ret = I2C_Write(PCF85063_ADDRESS, RTC_CTRL_2_ADDR, &Value, 1);
+	if(ret != ESP_OK)
+		printf("PCF85063 : Failed to disable Alarm\r\n");
+}
+
 uint8_t PCF85063_Get_Alarm_Flag() // Get Alarm flag
 {
 	uint8_t Value = 0;
@@ -149,9 +214,8 @@ void PCF85063_Set_Alarm(datetime_t time) // Set Alarm
 		decToBcd(time.second)&(~RTC_ALARM),
 		decToBcd(time.minute)&(~RTC_ALARM),
 		decToBcd(time.hour)&(~RTC_ALARM),
-		//decToBcd(time.day)&(~RTC_ALARM),
+		decToBcd(time.day)&(~RTC_ALARM),
 		//decToBcd(time.dotw)&(~RTC_ALARM)
-		RTC_ALARM, 	//disalbe day
 		RTC_ALARM	//disalbe weekday
 	};
 	esp_err_t ret = I2C_Write(PCF85063_ADDRESS, RTC_SECOND_ALARM, buf, sizeof(buf));
@@ -186,4 +250,44 @@ void datetime_to_str(char *datetime_str,datetime_t time)
 {
 	sprintf(datetime_str, " %d.%d.%d  %d:%d:%d  %s", time.year, time.month, 
 			time.day, time.hour, time.minute, time.second, Week[time.dotw]);
-} 
\ No newline at end of file
+} 
+
+// Days from civil date and back, proleptic Gregorian calendar (valid for the years the RTC can hold)
+static int32_t days_from_civil(int32_t y, uint32_t m, uint32_t d)
+{
+	y -= m <= 2;
+	int32_t era = (y >= 0 ? y : y - 399) / 400;
+	uint32_t yoe = (uint32_t)(y - era * 400);
+	uint32_t doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+	uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+	return era * 146097 + (int32_t)doe - 719468;
+}
+uint32_t datetime_to_epoch(datetime_t time)
+{
+	int32_t days = days_from_civil(time.year, time.month, time.day);
+	return (uint32_t)days * 86400 + time.hour * 3600 + time.minute * 60 + time.second;
+}
+void epoch_to_datetime(uint32_t epoch, datetime_t *time)
+{
+	int32_t z = epoch / 86400 + 719468;
+	uint32_t secs = epoch % 86400;
+	int32_t era = z / 146097;
+	uint32_t doe = (uint32_t)(z - era * 146097);
+	uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+	uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+	uint32_t mp = (5 * doy + 2) / 153;
+	time->day = doy - (153 * mp + 2) / 5 + 1;
+	time->month = mp < 10 ? mp + 3 : mp - 9;
+	time->year = yoe + era * 400 + (time->month <= 2);
+	time->dotw = (epoch / 86400 + 4) % 7;          // 1970-01-01 was a Thursday
+	time->hour = secs / 3600;
+	time->minute = secs / 60 % 60;
+	time->second = secs % 60;
+}
+uint8_t datetime_days_in_month(uint16_t year, uint8_t month)
+{
+	static const uint8_t days[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+	if(month == 2 && ((year % 4 == 0 && year % 100 != 0) || year % 400 == 0))
+		return 29;
+	return (month >= 1 && month <= 12) ? days[month - 1] : 0;
+}
@@ -59,6 +59,12 @@
 
 #define RTC_TIMER_FLAG		  (0x08)
 
+#define PCF85063_INT_PIN    -1      // GPIO wired to the INT output (open drain, active low), -1 : not connected, RTCTask sleeps on timers
+
+// Time service
+#define PCF85063_Resync_S         3600          // Without SNTP the PCF85063 is read again this often (unit: s)
+#define Time_System_Valid_Epoch   1609459200    // A system clock later than 2021-01-01 was set by SNTP
+
 typedef struct {
   uint16_t year;
   uint8_t month;
@@ -73,24 +79,32 @@ typedef struct {
 const unsigned char MonthStr[12][4] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov","Dec"};
 const unsigned char Week[7][5] = {"SUN","Mon","Tues","Wed","Thur","Fri","Sat"};
 
-extern datetime_t datetime;
 void PCF85063_Init(void);
 void PCF85063_Reset(void);
-void PCF85063Task(void *parameter);
 
 void PCF85063_Set_Time(datetime_t time);
 void PCF85063_Set_Date(datetime_t date);
 void PCF85063_Set_All(datetime_t time);
 
-void PCF85063_Read_Time(datetime_t *time);
+bool PCF85063_Read_Time(datetime_t *time);                  // false : I2C error or the RTC was never set
+
+// The PCF85063 is only read at boot, SNTP sets the system clock (see Acquisition_time()). Safe from any task.
+bool Time_Get(datetime_t *time);                            // Consistent snapshot, false while the time is unknown
+bool Time_Get_Epoch(uint32_t *epoch);
+void Time_Set(datetime_t time);                             // Writes the PCF85063 and restarts the count from it
+void Time_Maintain(void);                                   // Reads the PCF85063 again every PCF85063_Resync_S while there is no SNTP
 
 
-void PCF85063_Enable_Alarm(void);
+void PCF85063_Enable_Alarm(void);                           // Also clears the alarm flag, which releases INT
+void PCF85063_Disable_Alarm(void);
 uint8_t PCF85063_Get_Alarm_Flag();
-void PCF85063_Set_Alarm(datetime_t time);
+void PCF85063_Set_Alarm(datetime_t time);                   // Matches day of the month, hour, minute and second
 void PCF85063_Read_Alarm(datetime_t *time);
 
 void datetime_to_str(char *datetime_str,datetime_t time);
+uint32_t datetime_to_epoch(datetime_t time);                // Seconds since 1970-01-01 00:00:00 (the RTC keeps UTC)
+void epoch_to_datetime(uint32_t epoch, datetime_t *time);   // Also fills in dotw
+uint8_t datetime_days_in_month(uint16_t year, uint8_t month);
 
 
 // weekday format
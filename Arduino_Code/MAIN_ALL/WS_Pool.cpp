@@ -0,0 +1,58 @@
+#include "WS_Pool.h"
+
+static Pool_t *Pool_List = NULL;          // Zero initialized, so it is valid before any static constructor runs
+
+Pool_Registration::Pool_Registration(Pool_t *Pool)
+{
+  portMUX_INITIALIZE(&Pool->Lock);
+  Pool->Free_List = NULL;
+  for (int i = Pool->Block_Count - 1; i >= 0; i--) {         // Block 0 is handed out first
+    void **Block = (void **)(Pool->Storage + (size_t)i * Pool->Block_Size);
+    *Block = Pool->Free_List;
+    Pool->Free_List = Block;
+  }
+  Pool->Used = 0;
+  Pool->Peak = 0;
+  Pool->Failures = 0;
+  Pool->Next = Pool_List;
+  Pool_List = Pool;
+}
+
+void *Pool_Alloc(Pool_t *Pool)
+{
+  portENTER_CRITICAL(&Pool->Lock);
+  void **Block = (void **)Pool->Free_List;
+  if (Block) {
+    Pool->Free_List = *Block;
+    if (++Pool->Used > Pool->Peak)
+      Pool->Peak = Pool->Used;
+  }
+  else
+    Pool->Failures++;
+  portEXIT_CRITICAL(&Pool->Lock);
+  return Block;
+}
+
+void Pool_Free(Pool_t *Pool, void *Block)
+{
+  if (!Block)
+    return;
+  if ((uint8_t *)Block < Pool->Storage || (uint8_t *)Block >= Pool->Storage + (size_t)Pool->Block_Count * Pool->Block_Size
+   || ((uint8_t *)Block - Pool->Storage) % Pool->Block_Size) {
+    printf("Pool_Free(function): %s does not own %p!!!!\r\n", Pool->Name, Block);
+    return;
+  }
+  portENTER_CRITICAL(&Pool->Lock);
+  *(void **)Block = Pool->Free_List;
+  Pool->Free_List = Block;
+  Pool->Used--;
+  portEXIT_CRITICAL(&Pool->Lock);
+}
+
+void Pool_Print_Stats(void)
+{
+  for (Pool_t *Pool = Pool_List; Pool; Pool = Pool->Next) {
+    printf("Pool %-10s : %u x %u bytes, in use %u, peak %u, failed %lu\r\n", Pool->Name, Pool->Block_Count, Pool->Block_Size,
+           Pool->Used, Pool->Peak, (unsigned long)Pool->Failures);
+  }
+}
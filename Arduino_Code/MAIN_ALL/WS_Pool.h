@@ -0,0 +1,39 @@
+#pragma once
+
+#include <Arduino.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/*************************************************************  Fixed-block pools  *************************************************************/
+// Message buffers of the transports come from static pools instead of the heap : a pool is a fixed number of
+// equal blocks carved out of a static array, so steady-state traffic never calls malloc and never fragments the heap.
+// A pool is defined next to its user with POOL_DEFINE() and registers itself before setup() runs.
+// Pool_Alloc() / Pool_Free() take a short critical section, they can be called from any task but not from an ISR.
+#define Pool_Align                4       // Block alignment, also the smallest block (the free list lives in the blocks)
+#define Pool_Round(Size)          ((((Size) + Pool_Align - 1) / Pool_Align) * Pool_Align)
+
+typedef struct Pool_t {
+  const char *Name;
+  uint8_t *Storage;
+  uint16_t Block_Size;
+  uint16_t Block_Count;
+  void *Free_List;                        // Linked through the first word of every free block
+  uint16_t Used;
+  uint16_t Peak;                          // High-water mark of Used since boot
+  uint32_t Failures;                      // Pool_Alloc() calls that found every block in use
+  portMUX_TYPE Lock;
+  struct Pool_t *Next;                    // Every registered pool, for Pool_Print_Stats()
+} Pool_t;
+
+struct Pool_Registration {
+  Pool_Registration(Pool_t *Pool);
+};
+
+#define POOL_DEFINE(Name, Size, Count)                                                                    \
+  static uint8_t Name##_Storage[(Count) * Pool_Round(Size)] __attribute__((aligned(Pool_Align)));         \
+  Pool_t Name = {#Name, Name##_Storage, Pool_Round(Size), (Count)};                                       \
+  static Pool_Registration Name##_Registration(&Name)
+
+void *Pool_Alloc(Pool_t *Pool);           // NULL : every block is in use, counted in Failures
+void Pool_Free(Pool_t *Pool, void *Block);
+void Pool_Print_Stats(void);              // One line per pool : blocks, in use, high-water mark, failures
@@ -1,33 +1,23 @@
 #include "WS_RS485.h"
-#include <algorithm>
+#include <atomic>
+#include <Preferences.h>
+#include "WS_Console.h"
 
 HardwareSerial lidarSerial(1);  // Using serial port 1
-uint8_t data[][8] = {                                       // ESP32-S3-POE-ETH-8DI-8RO Control Command (RS485 receiving data)
-  { 0x06, 0x05, 0x00, 0x01, 0x55, 0x00, 0xA2, 0xED },       // ESP32-S3-POE-ETH-8DI-8RO CH1 Toggle
-  { 0x06, 0x05, 0x00, 0x02, 0x55, 0x00, 0x52, 0xED },       // ESP32-S3-POE-ETH-8DI-8RO CH2 Toggle
-  { 0x06, 0x05, 0x00, 0x03, 0x55, 0x00, 0x03, 0x2D },       // ESP32-S3-POE-ETH-8DI-8RO CH3 Toggle
-  { 0x06, 0x05, 0x00, 0x04, 0x55, 0x00, 0xB2, 0xEC },       // ESP32-S3-POE-ETH-8DI-8RO CH4 Toggle
-  { 0x06, 0x05, 0x00, 0x05, 0x55, 0x00, 0xE3, 0x2C },       // ESP32-S3-POE-ETH-8DI-8RO CH5 Toggle
-  { 0x06, 0x05, 0x00, 0x06, 0x55, 0x00, 0x13, 0x2C },       // ESP32-S3-POE-ETH-8DI-8RO CH6 Toggle
-  { 0x06, 0x05, 0x00, 0x07, 0x55, 0x00, 0x42, 0xEC },       // ESP32-S3-POE-ETH-8DI-8RO CH7 Toggle
-  { 0x06, 0x05, 0x00, 0x08, 0x55, 0x00, 0x72, 0xEF },       // ESP32-S3-POE-ETH-8DI-8RO CH8 Toggle
-  { 0x06, 0x05, 0x00, 0xFF, 0xFF, 0x00, 0xBD, 0xBD },       // ESP32-S3-POE-ETH-8DI-8RO ALL ON
-  { 0x06, 0x05, 0x00, 0xFF, 0x00, 0x00, 0xFC, 0x4D },       // ESP32-S3-POE-ETH-8DI-8RO ALL OFF
-};
-uint8_t Send_Data[][8] = {                                  // Modbus RTU Relay Control Command (RS485 send data)
-  { 0x01, 0x05, 0x00, 0x00, 0x55, 0x00, 0xF2, 0x9A },       // Modbus RTU Relay CH1 Toggle
-  { 0x01, 0x05, 0x00, 0x01, 0x55, 0x00, 0xA3, 0x5A },       // Modbus RTU Relay CH2 Toggle
-  { 0x01, 0x05, 0x00, 0x02, 0x55, 0x00, 0x53, 0x5A },       // Modbus RTU Relay CH3 Toggle
-  { 0x01, 0x05, 0x00, 0x03, 0x55, 0x00, 0x02, 0x9A },       // Modbus RTU Relay CH4 Toggle
-  { 0x01, 0x05, 0x00, 0x04, 0x55, 0x00, 0xB3, 0x5B },       // Modbus RTU Relay CH5 Toggle
-  { 0x01, 0x05, 0x00, 0x05, 0x55, 0x00, 0xE2, 0x9B },       // Modbus RTU Relay CH6 Toggle
-  { 0x01, 0x05, 0x00, 0x06, 0x55, 0x00, 0x12, 0x9B },       // Modbus RTU Relay CH7 Toggle
-  { 0x01, 0x05, 0x00, 0x07, 0x55, 0x00, 0x43, 0x5B },       // Modbus RTU Relay CH8 Toggle
-  { 0x01, 0x05, 0x00, 0xFF, 0xFF, 0xFF, 0xFC, 0x4A },       // Modbus RTU Relay ALL ON
-  { 0x01, 0x05, 0x00, 0xFF, 0x00, 0x00, 0xFD, 0xFA },       // Modbus RTU Relay ALL OFF
-};
-uint8_t buf[20] = {0};          // Data storage area
-int numRows = sizeof(data) / sizeof(data[0]);
+static uint8_t RS485_Frame[Modbus_ADU_MAX];     // One received frame, the UART RX timeout marks its end
+static uint8_t RS485_Response[Modbus_ADU_MAX];
+static TaskHandle_t RS485_Task_Handle = NULL;
+static QueueHandle_t Modbus_Master_Queue = NULL;
+
+static uint8_t Extension_ID[Extension_Board_MAX];          // Slave address of every board (RS485Task only after RS485_Init())
+static std::atomic<uint8_t> Extension_Board_Number(Extension_Board_Default);
+static Preferences Extension_Preferences;
+static uint8_t Extension_State[Extension_Board_MAX];       // Last known coils of every board (RS485Task only)
+static bool Extension_Known[Extension_Board_MAX];          // false : read the coils before a masked write
+
+static TickType_t Modbus_Master_Poll(void);
+static void Extension_Load_IDs(uint8_t *IDs);
+static void Console_Extension(const char *Args);
 
 void SetData(uint8_t* data, size_t length) {
   lidarSerial.write(data, length);                          // Send data from the RS485
@@ -37,127 +27,449 @@ void ReadData(uint8_t* buf, uint8_t length) {
   Receive_Flag = lidarSerial.available();
   if (Receive_Flag >= length) {
     lidarSerial.readBytes(buf, length); 
-    char printBuf[length * 3 + 1];
-    sprintf(printBuf, "Received data: ");
-    for (int i = 0; i < length; i++) {
-      sprintf(printBuf + strlen(printBuf), "%02X ", buf[i]); 
-    }
-    printf(printBuf); 
+    WS_LOG_HEX(RS485, LOG_INFO, "Received data: ", buf, length);   // Formatted by LogTask
     /*************************
     Add a receiving data handler
     *************************/
     Receive_Flag = 0;
-    memset(buf, 0, sizeof(buf));   
+    memset(buf, 0, length);   
   }
 }
-void RS485_Analysis(uint8_t *buf)
+void RS485_Analysis(uint8_t *buf)                           // ESP32-S3-POE-ETH-8DI-8RO receives, Modbus RTU Relay is sent to
 {
-  switch(buf[1])
-  {
-    case Extension_CH1:
-      SetData(Send_Data[0],sizeof(Send_Data[0])); 
-      printf("|***  Toggle expansion channel 1 ***|\r\n");
-      break;
-    case Extension_CH2:
-      SetData(Send_Data[1],sizeof(Send_Data[1])); 
-      printf("|***  Toggle expansion channel 2 ***|\r\n");
-      break;
-    case Extension_CH3:
-      SetData(Send_Data[2],sizeof(Send_Data[2])); 
-      printf("|***  Toggle expansion channel 3 ***|\r\n");
-      break;
-    case Extension_CH4:
-      SetData(Send_Data[3],sizeof(Send_Data[3])); 
-      printf("|***  Toggle expansion channel 4 ***|\r\n");
-      break;
-    case Extension_CH5:
-      SetData(Send_Data[4],sizeof(Send_Data[4])); 
-      printf("|***  Toggle expansion channel 5 ***|\r\n");
-      break;
-    case Extension_CH6:
-      SetData(Send_Data[5],sizeof(Send_Data[5])); 
-      printf("|***  Toggle expansion channel 6 ***|\r\n");
-      break;
-    case Extension_CH7:
-      SetData(Send_Data[6],sizeof(Send_Data[6])); 
-      printf("|***  Toggle expansion channel 7 ***|\r\n");
-      break;
-    case Extension_CH8:
-      SetData(Send_Data[7],sizeof(Send_Data[7])); 
-      printf("|***  Toggle expansion channel 8 ***|\r\n");
-      break;
-    case Extension_ALL_ON:
-      SetData(Send_Data[8],sizeof(Send_Data[8])); 
-      printf("|***  Enable all extension channels ***|\r\n");
-      break;
-    case Extension_ALL_OFF:
-      SetData(Send_Data[9],sizeof(Send_Data[9])); 
-      printf("|***  Close all expansion channels ***|\r\n");
-      break;
-    default:
-      printf("Note : Non-control external device instructions !\r\n");
+  uint8_t Board = buf[1] >> 4;
+  uint8_t Command = buf[1] & 0x0F;
+  if(Board >= Extension_Board_Number){
+    printf("Note : Expansion board %d is not installed !\r\n", Board);
+    return;
+  }
+  if(Command >= Extension_CH1 && Command < Extension_CH1 + Extension_Channel_Number){
+    Modbus_Master_Write_Coil(Extension_ID[Board], Command - Extension_CH1, Modbus_Coil_Toggle);
+    printf("|***  Toggle expansion board %d channel %d ***|\r\n", Board, Command);
+  }
+  else if(Command == Extension_ALL_ON){
+    Extension_Immediate_Masks(Board, 0xFF, 0x00);
+    printf("|***  Enable all channels of expansion board %d ***|\r\n", Board);
+  }
+  else if(Command == Extension_ALL_OFF){
+    Extension_Immediate_Masks(Board, 0x00, 0xFF);
+    printf("|***  Close all channels of expansion board %d ***|\r\n", Board);
   }
+  else
+    printf("Note : Non-control external device instructions !\r\n");
 }
 uint32_t Baudrate = 0;
-double  transmission_time = 0;
-double RS485_cmd_Time = 0;
 void RS485_Init()                                             // Initializing serial port
 {    
-  Baudrate = 9600;                                            // Set the baud rate of the serial port                                              
+  Baudrate = RS485_Baudrate;                                  // Set the baud rate of the serial port                                              
+  Extension_Preferences.begin(Extension_NVS_Namespace, false);
+  uint8_t Boards = Extension_Preferences.getUChar("Boards", Extension_Board_Default);
+  Extension_Board_Number = (Boards && Boards <= Extension_Board_MAX) ? Boards : Extension_Board_Default;
+  Extension_Load_IDs(Extension_ID);
+  Console_Add_Command("ext", Console_Extension, "expansion boards [boards <n> | id <board> <slave> | read <board> | set <board> <open> <closs>]");
+  Modbus_Master_Queue = xQueueCreate(Modbus_Master_Queue_Length, sizeof(Modbus_Request));
+  Task_Start(Task_RS485, RS485Task, &RS485_Task_Handle);
+  lidarSerial.setRxBufferSize(Modbus_ADU_MAX * 2);
   lidarSerial.begin(Baudrate, SERIAL_8N1, RXD1, TXD1);        // Initializing serial port
-  transmission_time = 10.0 / Baudrate * 1000 ;
-  RS485_cmd_Time = transmission_time*8;                       // 8:data length
-  xTaskCreatePinnedToCore(
-    RS485Task,    
-    "RS485Task",   
-    4096,                
-    NULL,                 
-    3,                   
-    NULL,                 
-    0                   
-  );
+  lidarSerial.setRxTimeout(RS485_RX_Timeout_Symbols);         // Counted in character times, so t3.5 follows the baud rate
+  lidarSerial.onReceive([]() {
+    if(RS485_Task_Handle)
+      xTaskNotifyGive(RS485_Task_Handle);
+  }, true);                                                   // Only at the end of a frame (RX timeout) or when the FIFO is full
+}
+void RS485_Set_Baudrate(uint32_t Rate)
+{
+  Baudrate = Rate;
+  lidarSerial.updateBaudRate(Rate);
 }
 
 void RS485Task(void *parameter) {
   while(1){
+    ulTaskNotifyTake(pdTRUE, Modbus_Master_Poll());         // RX frame, new master request or response timeout
     RS485_Loop();
-    vTaskDelay(pdMS_TO_TICKS(50));
   }
   vTaskDelete(NULL);
 }
 
-void RS485_Loop()
+/********************************************************  Modbus RTU master  ********************************************************/
+// One request is on the bus at a time. Consecutive masked writes to the same expansion board are folded
+// into one 0x0F, and a board whose coils are unknown (after boot or a failed request) is read first.
+static Modbus_Request Master_Request;                       // Request on the bus
+static bool Master_Busy = false;
+static bool Master_Reading = false;                         // Extension request : the coils are being read first
+static uint8_t Master_Attempts = 0;
+static uint32_t Master_Sent_Time = 0;
+static uint8_t Master_Frame[Modbus_ADU_MAX];
+static int Master_Frame_Length = 0;
+
+static bool Modbus_Master_Enqueue(const Modbus_Request *Request)
 {
-  uint8_t Receive_Flag = 0;       // Receiving mark
-  Receive_Flag = lidarSerial.available();    
+  if(!Modbus_Master_Queue){
+    printf("Modbus_Master_Enqueue(function): RS485 is not initialized!!!!\r\n");
+    return false;
+  }
+  if(xQueueSend(Modbus_Master_Queue, Request, 0) != pdTRUE){
+    printf("Note : The Modbus master queue is full and the request has been ignored - RS485 !\r\n");
+    return false;
+  }
+  if(RS485_Task_Handle)
+    xTaskNotifyGive(RS485_Task_Handle);
+  return true;
+}
+bool Modbus_Master_Read_Coils(uint8_t Slave_ID, uint16_t Address, uint16_t Quantity)
+{
+  if(!Slave_ID || !Quantity || Quantity > 2000){
+    printf("Modbus_Master_Read_Coils(function): Incoming parameter error!!!!\r\n");
+    return false;
+  }
+  Modbus_Request Request = {Modbus_Request_Raw, Slave_ID, Modbus_Read_Coils, Address, Quantity, 0, 0};
+  return Modbus_Master_Enqueue(&Request);
+}
+bool Modbus_Master_Write_Coil(uint8_t Slave_ID, uint16_t Address, uint16_t Value)
+{
+  Modbus_Request Request = {Modbus_Request_Raw, Slave_ID, Modbus_Write_Coil, Address, Value, 0, 0};
+  return Modbus_Master_Enqueue(&Request);
+}
+bool Extension_Immediate_Masks(uint8_t Board, uint8_t Open, uint8_t Closs)
+{
+  if(Board >= Extension_Board_Number){
+    printf("Extension_Immediate_Masks(function): Expansion board %d is not installed!!!!\r\n", Board);
+    return false;
+  }
+  Modbus_Request Request = {Modbus_Request_Extension, Board, Modbus_Write_Coils, 0, Extension_Channel_Number, Open, Closs};
+  return Modbus_Master_Enqueue(&Request);
+}
+static void Extension_Load_IDs(uint8_t *IDs)                // Saved addresses, board n on Modbus_Extension_ID + n if none are saved
+{
+  for (int i = 0; i < Extension_Board_MAX; i++)
+    IDs[i] = Modbus_Extension_ID + i;
+  if(Extension_Preferences.getBytesLength("IDs") == Extension_Board_MAX)
+    Extension_Preferences.getBytes("IDs", IDs, Extension_Board_MAX);
+}
+uint8_t Extension_Boards(void)
+{
+  return Extension_Board_Number;
+}
+bool Extension_Set_Boards(uint8_t Number)
+{
+  if(!Number || Number > Extension_Board_MAX){
+    printf("Extension_Set_Boards(function): Incoming parameter error!!!!\r\n");
+    return false;
+  }
+  Extension_Board_Number = Number;
+  if(Extension_Preferences.putUChar("Boards", Number) != 1)
+    printf("Note : The expansion board count could not be saved - RS485 !\r\n");
+  return true;
+}
+bool Extension_Set_ID(uint8_t Board, uint8_t Slave_ID)
+{
+  if(Board >= Extension_Board_MAX || !Slave_ID || Slave_ID > 247){
+    printf("Extension_Set_ID(function): Incoming parameter error!!!!\r\n");
+    return false;
+  }
+  uint8_t IDs[Extension_Board_MAX];
+  Extension_Load_IDs(IDs);
+  IDs[Board] = Slave_ID;
+  if(Extension_Preferences.putBytes("IDs", IDs, Extension_Board_MAX) != Extension_Board_MAX)
+    printf("Note : The expansion board addresses could not be saved - RS485 !\r\n");
+  Modbus_Request Request = {Modbus_Request_Extension_ID, Board, 0, Slave_ID, 0, 0, 0};
+  return Modbus_Master_Enqueue(&Request);                   // Extension_ID and Extension_Known belong to RS485Task
+}
 
-  if (Receive_Flag > 0) {
-    if(RS485_cmd_Time > 1)              // Time greater than 1 millisecond
-      delay((uint16_t)RS485_cmd_Time);
-    else                      // Time is less than 1 millisecond 
-      delay(1);
-    Receive_Flag = lidarSerial.available();
-    lidarSerial.readBytes(buf, Receive_Flag);              // The Receive_Flag length is read
-    if(Receive_Flag == 8){
-      uint8_t i=0;
-      for(i=0;i<numRows;i++){
-        bool result = std::equal(std::begin(buf), std::begin(buf) + 8, std::begin(data[i]));    // Compare two arrays
-        if(result){
-          if(i < numRows-1)
-            buf[0] = i+1+48;
-          else if(i == numRows-1)
-            buf[0] = 48;
-          Relay_Analysis(buf,RS485_Mode);
-          break;
-        }
-      }   
-      if(i > numRows-1)
-        printf("Note : Non-instruction data was received - RS485 !\r\n");
+static int Extension_Board_Of(uint8_t Slave_ID)             // Board index of a slave address, -1 if it is no expansion board
+{
+  for (int i = 0; i < Extension_Board_Number; i++) {
+    if(Extension_ID[i] == Slave_ID)
+      return i;
+  }
+  return -1;
+}
+static void Master_Build(uint8_t ID, uint8_t Function, uint16_t Address, uint16_t Value, uint32_t Coils)
+{
+  Master_Frame[0] = ID;
+  Master_Frame[1] = Function;
+  Master_Frame[2] = (uint8_t)(Address >> 8);
+  Master_Frame[3] = (uint8_t)Address;
+  Master_Frame[4] = (uint8_t)(Value >> 8);
+  Master_Frame[5] = (uint8_t)Value;
+  Master_Frame_Length = 6;
+  if(Function == Modbus_Write_Coils){
+    uint8_t Count = (Value + 7) / 8;
+    Master_Frame[Master_Frame_Length++] = Count;
+    for (uint8_t i = 0; i < Count; i++)
+      Master_Frame[Master_Frame_Length++] = (uint8_t)(Coils >> (i * 8));
+  }
+  uint16_t CRC = Modbus_CRC16(Master_Frame, Master_Frame_Length);
+  Master_Frame[Master_Frame_Length++] = (uint8_t)CRC;
+  Master_Frame[Master_Frame_Length++] = (uint8_t)(CRC >> 8);
+}
+static void Master_Transmit(void)
+{
+  if(Master_Request.Type == Modbus_Request_Extension){
+    uint8_t Board = Master_Request.Slave_ID;
+    Master_Reading = !Extension_Known[Board];
+    if(Master_Reading)
+      Master_Build(Extension_ID[Board], Modbus_Read_Coils, 0, Extension_Channel_Number, 0);
+    else
+      Master_Build(Extension_ID[Board], Modbus_Write_Coils, 0, Extension_Channel_Number,
+                   (Extension_State[Board] | Master_Request.Coils) & ~Master_Request.Closs);
+  }
+  else
+    Master_Build(Master_Request.Slave_ID, Master_Request.Function, Master_Request.Address, Master_Request.Value, Master_Request.Coils);
+  SetData(Master_Frame, Master_Frame_Length);
+  Master_Sent_Time = millis();
+  Master_Attempts++;
+  if(!Master_Frame[0]){                                     // Broadcast, nobody answers
+    lidarSerial.flush();
+    Master_Busy = false;
+  }
+}
+static void Master_Update_State(int Board, const uint8_t *Response)   // After a successful answer of an expansion board
+{
+  uint16_t Address = (Master_Frame[2] << 8) | Master_Frame[3];
+  uint16_t Value = (Master_Frame[4] << 8) | Master_Frame[5];
+  switch(Master_Frame[1])
+  {
+    case Modbus_Read_Coils:
+      if(Address == 0 && Value >= Extension_Channel_Number){
+        Extension_State[Board] = Response[3];
+        Extension_Known[Board] = true;
+      }
+      break;
+    case Modbus_Write_Coil:
+      if(Address == Modbus_Coil_All)
+        Extension_State[Board] = Value ? 0xFF : 0x00;
+      else if(Address < Extension_Channel_Number && Value == Modbus_Coil_Toggle)
+        Extension_State[Board] ^= (1 << Address);
+      else if(Address < Extension_Channel_Number)
+        Extension_State[Board] = Value ? (Extension_State[Board] | (1 << Address)) : (Extension_State[Board] & ~(1 << Address));
+      break;
+    case Modbus_Write_Coils:
+      if(Address == 0 && Value == Extension_Channel_Number){
+        Extension_State[Board] = Master_Frame[7];
+        Extension_Known[Board] = true;
+      }
+      else
+        Extension_Known[Board] = false;
+      break;
+  }
+}
+static bool Modbus_Master_Response(const uint8_t *Frame, int Length)   // true if the frame was the answer of the pending request
+{
+  if(!Master_Busy || Frame[0] != Master_Frame[0] || (Frame[1] & (uint8_t)~Modbus_Exception) != Master_Frame[1])
+    return false;
+  int Board = Extension_Board_Of(Frame[0]);
+  if(Frame[1] & Modbus_Exception){
+    printf("Note : Slave %d answered function 0x%02X with exception %d - RS485 !\r\n", Frame[0], Master_Frame[1], Length > 2 ? Frame[2] : 0);
+    if(Board >= 0)
+      Extension_Known[Board] = false;
+    Master_Busy = false;
+    return true;
+  }
+  if(Board >= 0)
+    Master_Update_State(Board, Frame);
+  if(Frame[1] == Modbus_Read_Coils && Master_Request.Type == Modbus_Request_Raw)
+    printf("Slave %d coils %d ~ %d : 0x%02X\r\n", Frame[0], (Master_Frame[2] << 8) | Master_Frame[3], ((Master_Frame[2] << 8) | Master_Frame[3]) + ((Master_Frame[4] << 8) | Master_Frame[5]) - 1, Length > 3 ? Frame[3] : 0);
+  if(Master_Reading){                                       // The coils are known now, send the write itself
+    Master_Attempts = 0;
+    Master_Transmit();
+    return true;
+  }
+  Master_Busy = false;
+  return true;
+}
+// Sends the next request when the bus is free and handles response timeouts.
+// Returns how long RS485Task may sleep before it has to look again.
+static TickType_t Modbus_Master_Poll(void)
+{
+  if(Master_Busy){
+    uint32_t Timeout = Modbus_Master_Timeout_MS + (uint32_t)(Master_Frame_Length + Modbus_Frame_Length + 2) * 11000 / Baudrate;
+    uint32_t Elapsed = millis() - Master_Sent_Time;
+    if(Elapsed < Timeout)
+      return pdMS_TO_TICKS(Timeout - Elapsed) + 1;
+    if(Master_Attempts <= Modbus_Master_Retries){
+      Master_Transmit();                                    // Repeat the frame that timed out
+      return pdMS_TO_TICKS(Timeout) + 1;
+    }
+    printf("Note : Slave %d did not answer function 0x%02X after %d attempts - RS485 !\r\n", Master_Frame[0], Master_Frame[1], Master_Attempts);
+    int Board = Extension_Board_Of(Master_Frame[0]);
+    if(Board >= 0)
+      Extension_Known[Board] = false;
+    Master_Busy = false;
+  }
+  if(!Modbus_Master_Queue || xQueueReceive(Modbus_Master_Queue, &Master_Request, 0) != pdTRUE)
+    return pdMS_TO_TICKS(RS485_Idle_Wake_MS);
+  if(Master_Request.Type == Modbus_Request_Extension_ID){  // Never while the old address could still answer
+    Extension_ID[Master_Request.Slave_ID] = (uint8_t)Master_Request.Address;
+    Extension_Known[Master_Request.Slave_ID] = false;
+    return 0;
+  }
+  Modbus_Request Next;
+  while(Master_Request.Type == Modbus_Request_Extension && xQueuePeek(Modbus_Master_Queue, &Next, 0) == pdTRUE &&
+        Next.Type == Modbus_Request_Extension && Next.Slave_ID == Master_Request.Slave_ID){
+    xQueueReceive(Modbus_Master_Queue, &Next, 0);          // Later masks of the same board win
+    Master_Request.Coils = (Master_Request.Coils & ~Next.Closs) | Next.Coils;
+    Master_Request.Closs = (Master_Request.Closs & ~Next.Coils) | Next.Closs;
+  }
+  Master_Busy = true;
+  Master_Attempts = 0;
+  Master_Transmit();
+  return Master_Busy ? pdMS_TO_TICKS(Modbus_Master_Timeout_MS) : 0;
+}
+
+/********************************************************  Modbus RTU slave  ********************************************************/
+// Coils 0 ~ Relay_Number_MAX-1 are CH1 ~ CHn. 0x01 reads them, 0x05 / 0x0F write them.
+// The ten fixed frames of the original firmware (toggle 0x5500 on coils 1 ~ 8, 0x00FF for all channels)
+// keep their meaning, they are matched before the standard decoding.
+static void Modbus_Send(uint8_t *Frame, int Length)             // Appends the CRC, Frame needs two spare bytes
+{
+  uint16_t CRC = Modbus_CRC16(Frame, Length);
+  Frame[Length++] = (uint8_t)CRC;
+  Frame[Length++] = (uint8_t)(CRC >> 8);
+  SetData(Frame, Length);
+}
+static bool Modbus_Legacy_Frame(const uint8_t *Frame)
+{
+  uint8_t Instruction[1] = {0};
+  int CHx = Relay_Channels.Find_RS485_Frame(Frame);
+  if(CHx >= 0)
+    Instruction[0] = Relay_Channels.CH[CHx].Instruction;
+  else if(Modbus_Frame_Equal(Relay_Channels.RS485_Frame_ALL_ON, Frame))
+    Instruction[0] = ALL_ON;
+  else if(Modbus_Frame_Equal(Relay_Channels.RS485_Frame_ALL_OFF, Frame))
+    Instruction[0] = ALL_OFF;
+  if(!Instruction[0])
+    return false;
+  Relay_Analysis(Instruction, RS485_Mode);
+  return true;
+}
+// Returns the exception code, 0 when the request was executed and RS485_Response[2...] holds the answer
+static uint8_t Modbus_Slave_Execute(const uint8_t *Frame, int Length, int *Response_Length)
+{
+  if(Length < 8)
+    return Modbus_Illegal_Value;
+  uint16_t Address = (Frame[2] << 8) | Frame[3];
+  uint16_t Value = (Frame[4] << 8) | Frame[5];
+  switch(Frame[1])
+  {
+    case Modbus_Read_Coils: {
+      if(Length != 8 || !Value || Value > 2000)
+        return Modbus_Illegal_Value;
+      if(Address + Value > Relay_Number_MAX)
+        return Modbus_Illegal_Address;
+      uint32_t State = (uint32_t)Relay_Get_PinState() >> Address;
+      uint8_t Count = (Value + 7) / 8;
+      RS485_Response[2] = Count;
+      for (uint8_t i = 0; i < Count; i++) {
+        uint8_t Bits = (Value - i * 8 >= 8) ? 0xFF : (uint8_t)((1 << (Value - i * 8)) - 1);
+        RS485_Response[3 + i] = (uint8_t)(State >> (i * 8)) & Bits;
+      }
+      *Response_Length = 3 + Count;
+      return 0;
     }
-    else{
-      printf("Note : Non-instruction data was received .Number of bytes: %d - RS485 !\r\n",Receive_Flag);
+    case Modbus_Write_Coil:
+      if(Length != 8)
+        return Modbus_Illegal_Value;
+      if(!Modbus_Legacy_Frame(Frame)){
+        if(Address >= Relay_Number_MAX)
+          return Modbus_Illegal_Address;
+        if(Value != Modbus_Coil_All_ON && Value != Modbus_Coil_OFF)
+          return Modbus_Illegal_Value;
+        Relay_Immediate(Address + 1, Value == Modbus_Coil_All_ON, RS485_Mode);
+      }
+      memcpy(RS485_Response + 2, Frame + 2, 4);                 // Echo of the request
+      *Response_Length = 6;
+      return 0;
+    case Modbus_Write_Coils: {
+      if(Length < 10 || Length != 9 + Frame[6] || !Value || Value > 1968 || Frame[6] != (Value + 7) / 8)
+        return Modbus_Illegal_Value;
+      if(Address + Value > Relay_Number_MAX)
+        return Modbus_Illegal_Address;
+      Relay_Mask_t Open = 0, Closs = 0;
+      for (uint16_t i = 0; i < Value; i++) {
+        Relay_Mask_t Mask = (Relay_Mask_t)(1UL << (Address + i));
+        if((Frame[7 + i / 8] >> (i % 8)) & 0x01)
+          Open |= Mask;
+        else
+          Closs |= Mask;
+      }
+      Relay_Immediate_Masks(Open, Closs, RS485_Mode);           // All coils of the request switch together
+      memcpy(RS485_Response + 2, Frame + 2, 4);                 // Start address and quantity
+      *Response_Length = 6;
+      return 0;
     }
-    Receive_Flag=0;
-    memset(buf,0, sizeof(buf));
+    default:
+      return Modbus_Illegal_Function;
+  }
+}
+static void Modbus_Slave_Handle(const uint8_t *Frame, int Length)
+{
+  if(!Modbus_CRC_Valid(Frame, Length)){
+    printf("Note : Non-instruction data was received .Number of bytes: %d - RS485 !\r\n", Length);
+    return;
+  }
+  if(Frame[0] != Modbus_Local_ID && Frame[0] != Modbus_Broadcast_ID)
+    return;                                                     // Another slave on the bus, e.g. the expansion board answering
+  bool Broadcast = (Frame[0] == Modbus_Broadcast_ID);
+  int Response_Length = 0;
+  uint8_t Exception = Modbus_Slave_Execute(Frame, Length, &Response_Length);
+  if(Broadcast)
+    return;
+  RS485_Response[0] = Modbus_Local_ID;
+  if(Exception){
+    RS485_Response[1] = Frame[1] | Modbus_Exception;
+    RS485_Response[2] = Exception;
+    Response_Length = 3;
+    printf("Note : Modbus exception %d for function 0x%02X - RS485 !\r\n", Exception, Frame[1]);
   }
-}
\ No newline at end of file
+  else
+    RS485_Response[1] = Frame[1];
+  Modbus_Send(RS485_Response, Response_Length);
+}
+
+void RS485_Loop()
+{
+  int Length = lidarSerial.available();
+  if(Length <= 0)
+    return;
+  if(Length > Modbus_ADU_MAX){                                  // No frame gap for longer than any RTU frame
+    printf("Note : %d bytes without a frame gap were dropped - RS485 !\r\n", Length);
+    while(lidarSerial.available() > 0)
+      lidarSerial.read();
+    return;
+  }
+  Length = lidarSerial.readBytes(RS485_Frame, Length);
+  if(Modbus_CRC_Valid(RS485_Frame, Length) && Modbus_Master_Response(RS485_Frame, Length))
+    return;
+  Modbus_Slave_Handle(RS485_Frame, Length);
+}
+
+/********************************************************  Console  ********************************************************/
+static void Console_Extension(const char *Args)
+{
+  char Name[8] = "";
+  int A = 0, B = 0, C = 0;
+  int Count = sscanf(Args, "%7s %i %i %i", Name, &A, &B, &C);
+  if(Count <= 0){
+    uint8_t IDs[Extension_Board_MAX];
+    Extension_Load_IDs(IDs);
+    printf("Expansion boards : %d\r\n", Extension_Boards());
+    for (int i = 0; i < Extension_Board_MAX; i++)
+      printf("  board %d : slave %d%s\r\n", i, IDs[i], i < Extension_Boards() ? "" : " (not installed)");
+  }
+  else if(A < 0 || A > 0xFF || B < 0 || B > 0xFF || C < 0 || C > 0xFF)
+    printf("Note : ext arguments are 0 ~ 255 !\r\n");
+  else if(!strcmp(Name, "boards") && Count == 2)
+    Extension_Set_Boards(A);
+  else if(!strcmp(Name, "id") && Count == 3)
+    Extension_Set_ID(A, B);
+  else if(!strcmp(Name, "read") && Count == 2 && A < Extension_Board_MAX){
+    uint8_t IDs[Extension_Board_MAX];
+    Extension_Load_IDs(IDs);
+    Modbus_Master_Read_Coils(IDs[A], 0, Extension_Channel_Number);   // RS485Task prints the answer
+  }
+  else if(!strcmp(Name, "set") && Count == 4)
+    Extension_Immediate_Masks(A, B, C);                     // Masks : bit0 = channel 1, 0x prefix for hex
+  else
+    printf("Note : Unknown ext arguments, try ext boards <n> | id <board> <slave> | read <board> | set <board> <open> <closs> !\r\n");
+}
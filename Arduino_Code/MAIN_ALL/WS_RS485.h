@@ -3,6 +3,8 @@
 #include <HardwareSerial.h>       // Reference the ESP32 built-in serial port library
 #include "WS_GPIO.h"
 #include "WS_Relay.h"
+#include "WS_Log.h"
+#include "WS_Tasks.h"
 
 #define Extension_CH1       1     // Expansion Channel 1
 #define Extension_CH2       2     // Expansion Channel 2
@@ -14,13 +16,52 @@
 #define Extension_CH8       8     // Expansion Channel 8
 #define Extension_ALL_ON    9     // Expansion ALL ON
 #define Extension_ALL_OFF   10    // Expansion ALL OFF
+#define Extension_Channel_Number  8       // Coils of one Modbus RTU Relay expansion board
+#define Extension_Board_MAX       4       // Expansion boards that can share the bus
+#define Extension_Board_Default   1       // Boards installed until Extension_Set_Boards(), board n answers on Modbus_Extension_ID + n until Extension_Set_ID()
+#define Extension_NVS_Namespace   "Extension"   // Board count and slave addresses survive reboots in NVS
+
+#define RS485_Baudrate            9600    // Baud rate after RS485_Init()
+#define RS485_RX_Timeout_Symbols  4       // A pause this long ends a frame, t3.5 rounded up (unit: character times)
+#define RS485_Idle_Wake_MS        1000    // RS485Task also looks at the UART this often without an RX event (unit: ms)
+
+#define Modbus_Master_Queue_Length  16    // Requests to the expansion boards that can wait for the bus
+#define Modbus_Master_Timeout_MS    100   // Response timeout, the frame times at the current baud rate are added (unit: ms)
+#define Modbus_Master_Retries       2     // Repeats after a timeout before the request is dropped
+
+typedef enum {
+  Modbus_Request_Raw = 0,         // Function / Address / Value / Coils are sent as they are
+  Modbus_Request_Extension = 1,   // Open / Closs masks of one expansion board, sent as one 0x0F with the other coils retained
+  Modbus_Request_Extension_ID = 2,  // New slave address (Address) of one expansion board, nothing is sent
+} Modbus_Request_Type;
+
+typedef struct {
+  uint8_t Type;                   // Modbus_Request_Type
+  uint8_t Slave_ID;               // Raw : slave address (0 : broadcast)    Extension / Extension_ID : board index
+  uint8_t Function;               // Raw : Modbus_Read_Coils / Modbus_Write_Coil
+  uint16_t Address;               // Extension_ID : slave address
+  uint16_t Value;                 // Modbus_Write_Coil : coil value, Modbus_Read_Coils : quantity
+  uint32_t Coils;                 // Extension : Open mask
+  uint32_t Closs;                 // Extension : Closs mask
+} Modbus_Request;
 
 
 
 void SetData(uint8_t* data, size_t length);   // Send data from the RS485
 void ReadData(uint8_t* buf, uint8_t length);  // Data is received over RS485
 
-void RS485_Analysis(uint8_t *buf);            // External relay control
+void RS485_Analysis(uint8_t *buf);            // External relay control, buf[1] : (board << 4) | Extension_CHx / Extension_ALL_ON / Extension_ALL_OFF
+
+// Modbus RTU master for the expansion boards. The requests queue up and RS485Task sends them one after
+// the other, each one waits for its answer and is repeated after a timeout.
+bool Modbus_Master_Read_Coils(uint8_t Slave_ID, uint16_t Address, uint16_t Quantity);
+bool Modbus_Master_Write_Coil(uint8_t Slave_ID, uint16_t Address, uint16_t Value);
+bool Extension_Immediate_Masks(uint8_t Board, uint8_t Open, uint8_t Closs);                               // One 0x0F, the other channels are retained
+// Board count and slave addresses, saved in NVS and applied in RS485Task between two requests. The "ext" console command uses them.
+uint8_t Extension_Boards(void);
+bool Extension_Set_Boards(uint8_t Number);                  // 1 ~ Extension_Board_MAX
+bool Extension_Set_ID(uint8_t Board, uint8_t Slave_ID);     // Slave_ID : 1 ~ 247
 void RS485_Init();         // Example Initialize the system serial port and RS485
-void RS485_Loop();         // Read RS485 data, parse and control relays
+void RS485_Set_Baudrate(uint32_t Rate);
+void RS485_Loop();         // Read one Modbus RTU frame, control the relays and answer
 void RS485Task(void *parameter);
@@ -1,350 +1,472 @@
 #include "WS_RTC.h"
+#include <Preferences.h>
+#include <stdarg.h>
+#include <atomic>
 
 Timing_RTC CHx_State[Timing_events_Number_MAX];       // Set a maximum of Timing_events_Number_MAX timers
-char Event_str[Timing_events_Number_MAX][1000];
 static Timing_RTC CHx_State_Default;            // Event initial state
 const unsigned char Event_cycle[4][13] = {"Aperiodicity","everyday","Weekly","monthly"};
 
-void RTC_Init(void){
-  PCF85063_Init();
-  xTaskCreatePinnedToCore(
-    RTCTask,    
-    "RTCTask",   
-    4096,                
-    NULL,                 
-    3,                   
-    NULL,                 
-    0                   
-  );
+static SemaphoreHandle_t RTC_Event_Mutex = NULL;   // CHx_State / Event_Order are changed by BLE / WIFI and read by RTCTask
+static TaskHandle_t RTC_Task_Handle = NULL;
+static Preferences RTC_Preferences;
+static uint8_t Event_Order[Timing_events_Number_MAX];   // Indexes of the events that will fire, earliest Next_Fire first
+static uint8_t Event_Order_Num = 0;
+static bool Event_Reschedule = true;                    // Next_Fire of every event has to be computed again
+static volatile uint32_t Event_Revision = 0;            // Counts the changes of the event list, the web page reloads it when this moves
+static std::atomic<bool> RTC_Sync_Pending(false);       // SNTP set the system clock, the PCF85063 follows in RTCTask
+
+static void TimerEvent_Remove(uint8_t Index);
+
+/********************************************************  Alarm  ********************************************************/
+// With PCF85063_INT_PIN the PCF85063 alarm wakes RTCTask shortly before the earliest event, no task runs in between.
+// The INT line is also usable as a light sleep wake up source (gpio_wakeup_enable()).
+#if PCF85063_INT_PIN >= 0
+static uint32_t RTC_Alarm_Epoch = 0;                    // What the PCF85063 alarm is programmed to, 0 : disabled
+
+static void IRAM_ATTR RTC_Alarm_ISR(void)
+{
+  BaseType_t Woken = pdFALSE;
+  if(RTC_Task_Handle)
+    vTaskNotifyGiveFromISR(RTC_Task_Handle, &Woken);
+  portYIELD_FROM_ISR(Woken);
 }
-uint8_t Timing_events_Num = 0;
-void RTCTask(void *parameter)
-{ 
-  static uint8_t Time_Old = 0;
-  while(1){
-    if(Timing_events_Num){
-      for (int i = 0; i < Timing_events_Number_MAX; i++){
-        if(CHx_State[i].Enable_Flag){
-          if(CHx_State[i].Time.hour == datetime.hour && CHx_State[i].Time.minute == datetime.minute && CHx_State[i].Time.second == datetime.second && datetime.second != Time_Old){       // The event time is consistent with the current time
-            switch(CHx_State[i].repetition_State){
-              case Repetition_NONE:
-                if(CHx_State[i].Time.year == datetime.year && CHx_State[i].Time.month == datetime.month && CHx_State[i].Time.day == datetime.day){ // Executes at the defined date and time
-                  TimerEvent_handling(CHx_State[i]);
-                  TimerEvent_Del(CHx_State[i]);
-                }
-                break;
-              case Repetition_everyday:
-                TimerEvent_handling(CHx_State[i]);
-                break;
-              case Repetition_Weekly:
-                if(CHx_State[i].Time.dotw == datetime.dotw){
-                  TimerEvent_handling(CHx_State[i]);
-                }
-                break;
-              case Repetition_monthly:
-                if(CHx_State[i].Time.day == datetime.day){
-                  TimerEvent_handling(CHx_State[i]);
-                }
-                break;
-              default:
-                printf("Event error!!!!\n");
-                break;
-            }
-          }
-        }
-      }
-    }
-    Time_Old = datetime.second;
-    vTaskDelay(pdMS_TO_TICKS(100));
-  }
-  vTaskDelete(NULL);
+static void RTC_Alarm_Init(void)
+{
+  PCF85063_Disable_Alarm();
+  pinMode(PCF85063_INT_PIN, INPUT_PULLUP);
+  attachInterrupt(PCF85063_INT_PIN, RTC_Alarm_ISR, FALLING);
 }
-
-void TimerEvent_handling(Timing_RTC event){
-  uint8_t Retain_channels = 0;  
-  printf("Event %d : \r\n", event.Event_Number);
-  char datetime_str[50];
-  datetime_to_str(datetime_str,event.Time);
-  for (int i = 0; i < Relay_Number_MAX; i++) {
-    if(*(&(event.Relay_CH1)+i) == STATE_Retain)                     // Find the modified channel
-      Retain_channels ++;                                     // Number of unmodified channels  
+static void RTC_Alarm_Program(uint32_t Epoch)            // Not with RTC_Event_Mutex held, I2C
+{
+  if(Epoch == RTC_Alarm_Epoch){
+    if(Epoch && PCF85063_Get_Alarm_Flag() & RTC_CTRL_2_AF)                 // Fired already, re-arm the same time
+      PCF85063_Enable_Alarm();
+    return;
   }
-  if(Retain_channels < Relay_Number_MAX - 1){  
-    printf("%s\r\n", datetime_str);
-    printf("CHx Open   : ");  
-    int j = 0;       
-    for (j = 0; j < Relay_Number_MAX; j++) {
-      if(*(&(event.Relay_CH1)+j) == STATE_Open)                          
-        printf("CH%d    ", j+1); 
-    } 
-    printf("\r\nCHx Closs  : ");         
-    for (j = 0; j < Relay_Number_MAX; j++) {
-      if(*(&(event.Relay_CH1)+j) == STATE_Closs)                          
-        printf("CH%d    ", j+1); 
-    }
-    if(Retain_channels){
-      printf("\r\nCHx Retain : ");         
-      for (j = 0; j < Relay_Number_MAX; j++) {
-        if(*(&(event.Relay_CH1)+j) == STATE_Retain)                          
-          printf("CH%d    ", j+1); 
-      }
-    }
-    printf("\r\n");   
-    Relay_Immediate_CHxn(&(event.Relay_CH1), RTC_Mode);
-    printf("\r\n");
+  RTC_Alarm_Epoch = Epoch;
+  if(!Epoch){
+    PCF85063_Disable_Alarm();
+    return;
   }
-  else if(Retain_channels == Relay_Number_MAX - 1){           // Modified a channel                (use TimerEvent_CHx_Set())
-    printf("%s\r\n", datetime_str);
-    for (int x = 0; x < Relay_Number_MAX; x++) {
-      if(*(&(event.Relay_CH1)+x) != STATE_Retain){                   // Find the modified channel
-        if(*(&(event.Relay_CH1)+x)){
-          printf("CH%d Open\r\n", x); 
-          Relay_Immediate(x, true, RTC_Mode);
-          printf("\r\n");
+  datetime_t Time;
+  epoch_to_datetime(Epoch, &Time);                          // The PCF85063 keeps UTC like the epoch
+  PCF85063_Set_Alarm(Time);
+  PCF85063_Enable_Alarm();
+}
+#endif
+
+static bool RTC_Now(uint32_t *Now)
+{
+  Time_Maintain();
+  return Time_Get_Epoch(Now);                               // false : neither the RTC nor SNTP knows the time
+}
+
+/********************************************************  Schedule  ********************************************************/
+// First execution time of the event at or after After (epoch), 0 if it will not fire again
+uint32_t TimerEvent_Next_Fire(const Timing_RTC *event, uint32_t After)
+{
+  datetime_t Now;
+  epoch_to_datetime(After, &Now);
+  uint32_t Time_Of_Day = event->Time.hour * 3600 + event->Time.minute * 60 + event->Time.second;
+  uint32_t Day_Start = After - After % 86400;
+  uint32_t Fire = 0;
+  switch(event->repetition_State){
+    case Repetition_NONE:
+      Fire = datetime_to_epoch(event->Time);
+      return Fire >= After ? Fire : 0;
+    case Repetition_everyday:
+      Fire = Day_Start + Time_Of_Day;
+      return Fire >= After ? Fire : Fire + 86400;
+    case Repetition_Weekly:
+      Fire = Day_Start + ((event->Time.dotw + 7 - Now.dotw) % 7) * 86400 + Time_Of_Day;
+      return Fire >= After ? Fire : Fire + 7 * 86400;
+    case Repetition_monthly:
+      for (int i = 0; i < 13; i++) {                            // Months without that day (e.g. the 31st) are skipped
+        if(event->Time.day <= datetime_days_in_month(Now.year, Now.month)){
+          datetime_t Date = Now;
+          Date.day = event->Time.day;
+          Fire = datetime_to_epoch(Date) - Date.hour * 3600 - Date.minute * 60 - Date.second + Time_Of_Day;
+          if(Fire >= After)
+            return Fire;
         }
-        else{
-          printf("CH%d Closs\r\n", x); 
-          Relay_Immediate(x, false, RTC_Mode);
-          printf("\r\n");
+        if(++Now.month > 12){
+          Now.month = 1;
+          Now.year++;
         }
-        break;
       }
-    }
+      return 0;
+    default:
+      return 0;
   }
-  else{
-    printf("Event error or no relay control!!!\r\n");
+}
+static void TimerEvent_Order_Insert(uint8_t Index)                  // Keeps Event_Order sorted, O(n)
+{
+  if(!CHx_State[Index].Enable_Flag || !CHx_State[Index].Next_Fire)
+    return;
+  int i = Event_Order_Num;
+  while(i > 0 && CHx_State[Event_Order[i - 1]].Next_Fire > CHx_State[Index].Next_Fire){
+    Event_Order[i] = Event_Order[i - 1];
+    i--;
+  }
+  Event_Order[i] = Index;
+  Event_Order_Num++;
+}
+static void TimerEvent_Order_Rebuild(void)                          // After the events were renumbered
+{
+  Event_Order_Num = 0;
+  for (int i = 0; i < Timing_events_Num; i++) {
+    TimerEvent_Order_Insert(i);
   }
 }
+static void TimerEvent_Schedule_All(uint32_t Now)
+{
+  for (int i = 0; i < Timing_events_Num; i++) {
+    CHx_State[i].Next_Fire = TimerEvent_Next_Fire(&CHx_State[i], Now);
+  }
+  TimerEvent_Order_Rebuild();
+  Event_Reschedule = false;
+}
 
-void TimerEvent_CHx_Set(datetime_t time,uint8_t CHx, bool State, Repetition_event Repetition)
+/********************************************************  Storage  ********************************************************/
+static RTC_Event_Record Event_Records[Timing_events_Number_MAX];   // Save / load buffer, only used with RTC_Event_Mutex held or before RTCTask starts
+
+static void RTC_Event_Save(void)                            // After every change of the list
 {
-  char datetime_str[50];
-  datetime_to_str(datetime_str,datetime);
-  printf("Now Time: %s!!!!\r\n", datetime_str);
-  if(CHx > Relay_Number_MAX){
-    printf("Timing_CHx_Set(function): Error passing parameter CHx!!!!\r\n");
+  Event_Revision = Event_Revision + 1;
+  for (int i = 0; i < Timing_events_Num; i++) {
+    Event_Records[i].Time = datetime_to_epoch(CHx_State[i].Time);
+    Event_Records[i].Open = CHx_State[i].Open;
+    Event_Records[i].Closs = CHx_State[i].Closs;
+    Event_Records[i].Repetition = CHx_State[i].repetition_State;
+    Event_Records[i].Dotw = CHx_State[i].Time.dotw;
+  }
+  if(Timing_events_Num){
+    if(RTC_Preferences.putBytes("Events", Event_Records, Timing_events_Num * sizeof(RTC_Event_Record)) != Timing_events_Num * sizeof(RTC_Event_Record))
+      printf("RTC : Failed to save the RTC events!!!\r\n");
+  }
+  else
+    RTC_Preferences.remove("Events");
+}
+static void RTC_Event_Load(void)
+{
+  size_t Length = RTC_Preferences.getBytesLength("Events");
+  if(!Length)
+    return;
+  if(Length % sizeof(RTC_Event_Record) || Length > sizeof(Event_Records)){
+    printf("RTC : The stored RTC events have an unknown format and are ignored\r\n");
     return;
   }
-  if(Timing_events_Num + 1 >= Timing_events_Number_MAX)
-  {
-    printf("Note : The number of scheduled events is full.\r\n");
+  RTC_Preferences.getBytes("Events", Event_Records, Length);
+  Timing_events_Num = Length / sizeof(RTC_Event_Record);
+  for (int i = 0; i < Timing_events_Num; i++) {
+    CHx_State[i] = CHx_State_Default;
+    CHx_State[i].Enable_Flag = true;
+    CHx_State[i].Event_Number = i + 1;
+    epoch_to_datetime(Event_Records[i].Time, &CHx_State[i].Time);
+    CHx_State[i].Time.dotw = Event_Records[i].Dotw % 7;
+    CHx_State[i].Open = Event_Records[i].Open & Relay_Channels.All;
+    CHx_State[i].Closs = Event_Records[i].Closs & Relay_Channels.All & (Relay_Mask_t)~CHx_State[i].Open;
+    CHx_State[i].repetition_State = (Repetition_event)(Event_Records[i].Repetition & 0x03);
   }
-  else{
-    //RGB_Open_Time(50, 36, 0, 1000, 0); 
-    CHx_State[Timing_events_Num].Enable_Flag = true;
-    CHx_State[Timing_events_Num].Event_Number = Timing_events_Num + 1;
-    *(&(CHx_State[Timing_events_Num].Relay_CH1)+CHx) = (Status_adjustment)State;
-    CHx_State[Timing_events_Num].Time = time;
-    CHx_State[Timing_events_Num].repetition_State = Repetition;
-    Timing_events_Num ++;
-    datetime_to_str(datetime_str,time);
-    if(State){
-      printf("New timing event%d :\r\n        %s set CH%d Open  ----- %s\r\n\r\n", Timing_events_Num, datetime_str, CHx, Event_cycle[Repetition]);
-      sprintf(Event_str[Timing_events_Num-1], "Event %d : %s set CH%d Open  ----- %s\\n\\n", Timing_events_Num, datetime_str, CHx, Event_cycle[Repetition]);
+  printf("RTC : %d events restored\r\n", Timing_events_Num);
+}
+static void RTC_Event_Changed(void)                         // Called with RTC_Event_Mutex held
+{
+  RTC_Event_Save();
+  Event_Reschedule = true;
+  if(RTC_Task_Handle)
+    xTaskNotifyGive(RTC_Task_Handle);
+}
+
+void RTC_Init(void){
+  PCF85063_Init();
+  RTC_Event_Mutex = xSemaphoreCreateMutex();
+  RTC_Preferences.begin(RTC_Event_NVS_Namespace, false);
+  RTC_Event_Load();
+#if PCF85063_INT_PIN >= 0
+  RTC_Alarm_Init();
+#endif
+  Task_Start(Task_RTC, RTCTask, &RTC_Task_Handle);
+}
+void RTC_Sync_From_System(void)
+{
+  RTC_Sync_Pending = true;
+  if(RTC_Task_Handle)
+    xTaskNotifyGive(RTC_Task_Handle);
+}
+static void RTC_Sync_Write(void)                          // RTCTask, I2C
+{
+  time_t Now = time(nullptr);
+  if(Now <= Time_System_Valid_Epoch)
+    return;
+  datetime_t Time;
+  epoch_to_datetime((uint32_t)Now, &Time);
+  Time_Set(Time);
+  printf("[NTP] RTC updated from the system UTC (epoch=%ld)\r\n", (long)Now);
+}
+uint8_t Timing_events_Num = 0;
+// Sleeps until the earliest Next_Fire instead of comparing every event every tick.
+// Everything at or before the current second fires, so a skipped second does not lose an event.
+void RTCTask(void *parameter)
+{ 
+  uint32_t Last_Now = 0;
+  TickType_t Last_Tick = 0;
+  while(1){
+    uint32_t Now;
+    if(RTC_Sync_Pending.exchange(false))
+      RTC_Sync_Write();
+    if(!RTC_Now(&Now)){
+      ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(1000));
+      continue;
+    }
+    xSemaphoreTake(RTC_Event_Mutex, portMAX_DELAY);
+    uint32_t Expected = Last_Now + (xTaskGetTickCount() - Last_Tick) / configTICK_RATE_HZ;
+    if(Last_Now && (Now + RTC_Time_Jump_S < Expected || Now > Expected + RTC_Time_Jump_S + 1)){
+      printf("RTC : The clock was changed, the events are rescheduled\r\n");
+      Event_Reschedule = true;
     }
+    if(Event_Reschedule)
+      TimerEvent_Schedule_All(Now);
+    Last_Now = Now;
+    Last_Tick = xTaskGetTickCount();
+    while(Event_Order_Num && CHx_State[Event_Order[0]].Next_Fire <= Now){
+      uint8_t Index = Event_Order[0];
+      memmove(Event_Order, Event_Order + 1, --Event_Order_Num);
+      if(Now - CHx_State[Index].Next_Fire <= RTC_Event_Grace_S)
+        TimerEvent_handling(CHx_State[Index]);
+      else
+        printf("RTC : Event %d was missed by %lu s and is skipped\r\n", CHx_State[Index].Event_Number, (unsigned long)(Now - CHx_State[Index].Next_Fire));
+      if(CHx_State[Index].repetition_State == Repetition_NONE){
+        TimerEvent_Remove(Index);                           // Renumbers the events
+        RTC_Event_Save();
+        TimerEvent_Order_Rebuild();
+      }
+      else{
+        CHx_State[Index].Next_Fire = TimerEvent_Next_Fire(&CHx_State[Index], Now + 1);
+        TimerEvent_Order_Insert(Index);
+      }
+    }
+    uint32_t Wait_MS = RTC_Sleep_MAX_S * 1000;
+    uint32_t Next_Fire = Event_Order_Num ? CHx_State[Event_Order[0]].Next_Fire : 0;
+    if(Next_Fire && Next_Fire - Now <= RTC_Sleep_MAX_S)
+      Wait_MS = (Next_Fire - Now - 1) * 1000 + 100;             // The last second is approached in 100 ms steps
+    xSemaphoreGive(RTC_Event_Mutex);
+#if PCF85063_INT_PIN >= 0
+    if(Next_Fire && Next_Fire - Now <= RTC_Alarm_Lead_S)
+      RTC_Alarm_Program(0);                                       // Close enough, timed
     else{
-      printf("New timing event%d :\r\n        %s set CH%d Closs ----- %s\r\n\r\n", Timing_events_Num, datetime_str, CHx, Event_cycle[Repetition]);
-      sprintf(Event_str[Timing_events_Num-1], "Event %d : %s set CH%d Closs  ----- %s\\n\\n", Timing_events_Num, datetime_str, CHx, Event_cycle[Repetition]);
+      RTC_Alarm_Program(Next_Fire ? Next_Fire - RTC_Alarm_Lead_S : 0);
+      Wait_MS = RTC_Alarm_Fallback_S * 1000;
     }
-    Buzzer_Open_Time(700, 0);
+#endif
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(Wait_MS));
   }
+  vTaskDelete(NULL);
 }
 
-void TimerEvent_CHxs_Set(datetime_t time,uint8_t PinState, Repetition_event Repetition)
+static void TimerEvent_printf_CHx(const char *Title, Relay_Mask_t Mask)
 {
+  printf("%s", Title);
+  for (int i = 0; i < Relay_Number_MAX; i++) {
+    if((Mask >> i) & 0x01)
+      printf("%s    ", Relay_Channels.CH[i].Name);
+  }
+  printf("\r\n");
+}
+void TimerEvent_handling(Timing_RTC event){
+  char datetime_str[50];
+  printf("Event %d : \r\n", event.Event_Number);
+  if(!event.Open && !event.Closs){
+    printf("Event error or no relay control!!!\r\n");
+    return;
+  }
+  datetime_to_str(datetime_str,event.Time);
+  printf("%s\r\n", datetime_str);
+  TimerEvent_printf_CHx("CHx Open   : ", event.Open);
+  TimerEvent_printf_CHx("CHx Closs  : ", event.Closs);
+  Relay_Immediate_Masks(event.Open, event.Closs, RTC_Mode);     // Every channel of the event switches in one batch
+  printf("\r\n");
+}
 
+static bool TimerEvent_Add(datetime_t time, Relay_Mask_t Open, Relay_Mask_t Closs, Repetition_event Repetition)
+{
   char datetime_str[50];
+  datetime_t datetime = {0};
+  Time_Get(&datetime);
   datetime_to_str(datetime_str,datetime);
   printf("Now Time: %s!!!!\r\n", datetime_str);
-  if(Timing_events_Num + 1 >= Timing_events_Number_MAX)
-  {
+  if((uint8_t)Repetition > Repetition_monthly){
+    printf("TimerEvent_Add(function): Unknown repetition %d!!!!\r\n", Repetition);
+    return false;
+  }
+  xSemaphoreTake(RTC_Event_Mutex, portMAX_DELAY);
+  if(Timing_events_Num >= Timing_events_Number_MAX){
+    xSemaphoreGive(RTC_Event_Mutex);
     printf("Note : The number of scheduled events is full.\r\n");
+    return false;
   }
-  else{
-    //RGB_Open_Time(50, 36, 0, 1000, 0); 
-    CHx_State[Timing_events_Num].Enable_Flag = true;
-    CHx_State[Timing_events_Num].Event_Number = Timing_events_Num + 1;
-    for (int i = 0; i < Relay_Number_MAX; i++) {
-      *(&(CHx_State[Timing_events_Num].Relay_CH1)+i) = (Status_adjustment)((PinState >> i) & 0x01); 
-    }
-    CHx_State[Timing_events_Num].Time = time;
-    CHx_State[Timing_events_Num].repetition_State = Repetition;
-    Timing_events_Num ++;
-    datetime_to_str(datetime_str,time);
-    printf("New timing event%d :\r\n       %s \r\n",Timing_events_Num, datetime_str);
-    printf("        CHx   :");
-    for (int i = 0; i < Relay_Number_MAX; i++) 
-      printf("CH%d      ", i+1);
-    printf("\r\n        State :");
-    for (int i = 0; i < Relay_Number_MAX; i++) {
-      if((PinState >> i) & 0x01)
-        printf("Open     ");
-      else
-        printf("Closs    ");
-    }
-    printf("\r\n");
-    printf("        ----- %s\r\n\r\n", Event_cycle[Repetition]);
-    printf("\r\n");  
-    Buzzer_Open_Time(700, 0);
-
-    int len = 0;  
-    char Event_content[1000];  
-    len += snprintf(Event_content + len, sizeof(Event_content) - len, "&nbsp;&nbsp;&nbsp;&nbsp;CHx&nbsp;&nbsp;:");
-    for (int i = 0; i < Relay_Number_MAX; i++) {
-      len += snprintf(Event_content + len, sizeof(Event_content) - len, "CH%d&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;", i + 1);
-    }
-    len += snprintf(Event_content + len, sizeof(Event_content) - len, "\\n &nbsp;&nbsp;&nbsp;&nbsp;State :");
-    for (int i = 0; i < Relay_Number_MAX; i++) {
-      if ((PinState >> i) & 0x01)  
-        len += snprintf(Event_content + len, sizeof(Event_content) - len, "Open&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;");
-      else
-        len += snprintf(Event_content + len, sizeof(Event_content) - len, "Closs&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;");
-    }
-    len += snprintf(Event_content + len, sizeof(Event_content) - len, "\\n&nbsp;&nbsp;&nbsp;&nbsp;----- %s\\n\\n", Event_cycle[Repetition]);
-    // printf("%s\r\n", Event_content);
-    sprintf(Event_str[Timing_events_Num-1], "Event %d : %s \\n%s", Timing_events_Num, datetime_str,Event_content);
+  //RGB_Open_Time(50, 36, 0, 1000, 0); 
+  Timing_RTC *event = &CHx_State[Timing_events_Num];
+  *event = CHx_State_Default;
+  event->Enable_Flag = true;
+  event->Event_Number = Timing_events_Num + 1;
+  event->Open = Open & Relay_Channels.All;
+  event->Closs = Closs & Relay_Channels.All & (Relay_Mask_t)~Open;
+  event->Time = time;
+  event->repetition_State = Repetition;
+  Timing_events_Num ++;
+  RTC_Event_Changed();
+  xSemaphoreGive(RTC_Event_Mutex);
+  datetime_to_str(datetime_str,time);
+  printf("New timing event%d :\r\n       %s \r\n", Timing_events_Num, datetime_str);
+  TimerEvent_printf_CHx("        CHx Open  : ", Open);
+  TimerEvent_printf_CHx("        CHx Closs : ", Closs);
+  printf("        ----- %s\r\n\r\n", Event_cycle[Repetition]);
+  Buzzer_Open_Time(700, 0);
+  return true;
+}
+void TimerEvent_CHx_Set(datetime_t time,uint8_t CHx, bool State, Repetition_event Repetition)
+{
+  if(!CHx || CHx > Relay_Number_MAX){
+    printf("Timing_CHx_Set(function): Error passing parameter CHx!!!!\r\n");
+    return;
   }
+  Relay_Mask_t Mask = (Relay_Mask_t)(1UL << (CHx - 1));
+  TimerEvent_Add(time, State ? Mask : 0, State ? 0 : Mask, Repetition);
+}
+void TimerEvent_CHxs_Set(datetime_t time,Relay_Mask_t PinState, Repetition_event Repetition)
+{
+  TimerEvent_Add(time, PinState, (Relay_Mask_t)~PinState, Repetition);
 }
 void TimerEvent_CHxn_Set(datetime_t time,Status_adjustment *Relay_n, Repetition_event Repetition)
 {
-  char datetime_str[50];
-  datetime_to_str(datetime_str,datetime);
-  printf("Now Time: %s!!!!\r\n", datetime_str);
-  if(Timing_events_Num + 1 >= Timing_events_Number_MAX)
-  {
-    printf("Note : The number of scheduled events is full.\r\n");
-  }
-  else{
-    //RGB_Open_Time(50, 36, 0, 1000, 0); 
-    CHx_State[Timing_events_Num].Enable_Flag = true;
-    CHx_State[Timing_events_Num].Event_Number = Timing_events_Num + 1;
-    for (int i = 0; i < Relay_Number_MAX; i++) {
-      *(&(CHx_State[Timing_events_Num].Relay_CH1)+i) = Relay_n[i]; 
-    }
-    CHx_State[Timing_events_Num].Time = time;
-    CHx_State[Timing_events_Num].repetition_State = Repetition;
-    Timing_events_Num ++;
-    datetime_to_str(datetime_str,time);
-    printf("New timing event%d :\r\n       %s \r\n",Timing_events_Num, datetime_str);
-    printf("        CHx   :");
-    for (int i = 0; i < Relay_Number_MAX; i++) 
-      printf("CH%d      ", i+1);
-    printf("\r\n        State :");
-    for (int i = 0; i < Relay_Number_MAX; i++) {
-      if(Relay_n[i] == STATE_Open)
-        printf("Open     ");
-      else if(Relay_n[i] == STATE_Closs)
-        printf("Closs    ");
-      else if(Relay_n[i] == STATE_Retain)
-        printf("Retain   ");
-    }
-    printf("\r\n");
-    printf("        ----- %s\r\n\r\n", Event_cycle[Repetition]);
-    printf("\r\n");
-    Buzzer_Open_Time(700, 0);
-    
-    int len = 0;  
-    char Event_content[1000];  
-    len += snprintf(Event_content + len, sizeof(Event_content) - len, "&nbsp;&nbsp;&nbsp;&nbsp;CHx&nbsp;&nbsp;:");
-    for (int i = 0; i < Relay_Number_MAX; i++) {
-      len += snprintf(Event_content + len, sizeof(Event_content) - len, "CH%d&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;", i + 1);
-    }
-    len += snprintf(Event_content + len, sizeof(Event_content) - len, "\\n&nbsp;&nbsp;&nbsp;&nbsp;State&nbsp;:");
-    for (int i = 0; i < Relay_Number_MAX; i++) {
-      if (Relay_n[i] == STATE_Open)
-        len += snprintf(Event_content + len, sizeof(Event_content) - len, "Open&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;");
-      else if(Relay_n[i] == STATE_Closs)
-        len += snprintf(Event_content + len, sizeof(Event_content) - len, "Closs&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;");
-      else if(Relay_n[i] == STATE_Retain)
-        len += snprintf(Event_content + len, sizeof(Event_content) - len, "Retain&nbsp;&nbsp;&nbsp;");
-    }
-    len += snprintf(Event_content + len, sizeof(Event_content) - len, "\\n&nbsp;&nbsp;&nbsp;&nbsp;----- %s\\n\\n", Event_cycle[Repetition]);
-    // printf("%s\r\n", Event_content);  
-    sprintf(Event_str[Timing_events_Num-1], "Event %d : %s \\n%s", Timing_events_Num, datetime_str,Event_content);
+  Relay_Mask_t Open = 0, Closs = 0;
+  for (int i = 0; i < Relay_Number_MAX; i++) {
+    if(Relay_n[i] == STATE_Open)
+      Open |= (Relay_Mask_t)(1UL << i);
+    else if(Relay_n[i] == STATE_Closs)
+      Closs |= (Relay_Mask_t)(1UL << i);
   }
+  TimerEvent_Add(time, Open, Closs, Repetition);
 }
 
 void TimerEvent_printf(Timing_RTC event){
-  uint8_t Retain_channels = 0;
-  uint8_t open[8]={0};      
-  printf("Event %d : \r\n", event.Event_Number);
   char datetime_str[50];
+  printf("Event %d : \r\n", event.Event_Number);
   datetime_to_str(datetime_str,event.Time);
-  for (int i = 0; i < Relay_Number_MAX; i++) {
-    if(*(&(event.Relay_CH1)+i) == STATE_Retain)                     // Find the modified channel
-      Retain_channels ++;                                     // Number of unmodified channels  
-    else
-      open[i] = *(&(event.Relay_CH1)+i);
-  }
-  if(Retain_channels == 0){                                   // All channels have been modified   (use TimerEvent_CHxs_Set())   
-    printf("%s\r\n", datetime_str);
-    printf(" CHx Open  : ");         
-    for (int j = 0; j < Relay_Number_MAX; j++) {
-      if(open[j])                          
-        printf("CH%d    ", j); 
-    } 
-    printf("\r\n CHx Closs : ");         
-    for (int k = 0; k < Relay_Number_MAX; k++) {
-      if(!open[k])                          
-        printf("CH%d    ", k); 
-    }
-    printf("\r\n");    
-  }
-  else if(Retain_channels == Relay_Number_MAX - 1){           // Modified a channel                (use TimerEvent_CHx_Set())
-    printf("%s    ,", datetime_str);
-    for (int x = 0; x < Relay_Number_MAX; x++) {
-      if(*(&(event.Relay_CH1)+x) != STATE_Retain){                   // Find the modified channel
-        if(*(&(event.Relay_CH1)+x))
-          printf("CH%d Open\r\n", x); 
-        else
-          printf("CH%d Closs\r\n", x); 
-        break;
-      }
-    }
-  }
-  else{
-    printf("%s\r\n", datetime_str);
-    printf("CHx Open   : ");  
-    int j = 0;       
-    for (j = 0; j < Relay_Number_MAX; j++) {
-      if(open[j] == STATE_Open)                          
-        printf("CH%d    ", j+1); 
-    } 
-    printf("\r\nCHx Closs  : ");         
-    for (j = 0; j < Relay_Number_MAX; j++) {
-      if(open[j] == STATE_Closs)                          
-        printf("CH%d    ", j+1); 
-    }
-    printf("\r\nCHx Retain : ");         
-    for (j = 0; j < Relay_Number_MAX; j++) {
-      if(open[j] == STATE_Retain)                          
-        printf("CH%d    ", j+1); 
-    }
-    printf("\r\n");   
-  }
+  printf("%s    ----- %s\r\n", datetime_str, Event_cycle[event.repetition_State]);
+  TimerEvent_printf_CHx(" CHx Open   : ", event.Open);
+  TimerEvent_printf_CHx(" CHx Closs  : ", event.Closs);
+  TimerEvent_printf_CHx(" CHx Retain : ", (Relay_Mask_t)(Relay_Channels.All & ~(event.Open | event.Closs)));
 }
 
 void TimerEvent_printf_ALL(void)
 {
+  Timing_RTC event;
   printf("/******************* Current RTC event *******************/ \r\n");
-  for (int i = 0; i < Timing_events_Number_MAX; i++) {
-    if(CHx_State[i].Enable_Flag)
-      TimerEvent_printf(CHx_State[i]);
+  for (int i = 1; TimerEvent_Get(i, &event); i++) {
+    TimerEvent_printf(event);
   }
   printf("/******************* Current RTC event *******************/\r\n\r\n ");
 }
-void TimerEvent_Del(Timing_RTC event){
+static void TimerEvent_Remove(uint8_t Index){              // Called with RTC_Event_Mutex held
   //RGB_Open_Time(20, 0, 50, 1000, 0); 
-  printf("Example Delete an RTC event%d\r\n\r\n",event.Event_Number);
-  for (int i = event.Event_Number; i < Timing_events_Number_MAX; i++) {
-    CHx_State[i].Event_Number = CHx_State[i].Event_Number -1;
+  printf("Example Delete an RTC event%d\r\n\r\n",CHx_State[Index].Event_Number);
+  for (int i = Index + 1; i < Timing_events_Num; i++) {
     CHx_State[i-1] = CHx_State[i];  
+    CHx_State[i-1].Event_Number = i;
   }
-  CHx_State[Timing_events_Number_MAX - 1] = CHx_State_Default;
-  memset(Event_str[Timing_events_Number_MAX - 1], 0, sizeof(Event_str[Timing_events_Number_MAX - 1]));
+  CHx_State[Timing_events_Num - 1] = CHx_State_Default;
   Timing_events_Num --;
 }
+void TimerEvent_Del(Timing_RTC event){
+  xSemaphoreTake(RTC_Event_Mutex, portMAX_DELAY);
+  if(!event.Event_Number || event.Event_Number > Timing_events_Num){
+    xSemaphoreGive(RTC_Event_Mutex);
+    printf("TimerEvent_Del(function): Event %d does not exist!!!!\r\n", event.Event_Number);
+    return;
+  }
+  TimerEvent_Remove(event.Event_Number - 1);
+  RTC_Event_Changed();
+  xSemaphoreGive(RTC_Event_Mutex);
+}
 void TimerEvent_Del_Number(uint8_t Event_Number){
-  TimerEvent_Del(CHx_State[Event_Number - 1]);
+  xSemaphoreTake(RTC_Event_Mutex, portMAX_DELAY);
+  if(!Event_Number || Event_Number > Timing_events_Num){
+    xSemaphoreGive(RTC_Event_Mutex);
+    printf("TimerEvent_Del_Number(function): Event %d does not exist!!!!\r\n", Event_Number);
+    return;
+  }
+  TimerEvent_Remove(Event_Number - 1);
+  RTC_Event_Changed();
+  xSemaphoreGive(RTC_Event_Mutex);
   Buzzer_Open_Time(700, 300); 
-}
\ No newline at end of file
+}
+uint32_t TimerEvent_Revision(void)
+{
+  return Event_Revision;
+}
+bool TimerEvent_Get(uint8_t Event_Number, Timing_RTC *event)
+{
+  bool Result = false;
+  xSemaphoreTake(RTC_Event_Mutex, portMAX_DELAY);
+  if(Event_Number && Event_Number <= Timing_events_Num){
+    *event = CHx_State[Event_Number - 1];
+    Result = true;
+  }
+  xSemaphoreGive(RTC_Event_Mutex);
+  return Result;
+}
+
+/********************************************************  Display  ********************************************************/
+// Rendered when the page asks for it, nothing is kept per event. "\\n" is a JSON escape, the page turns it into <br>.
+static int TimerEvent_Append(char *Text, size_t Size, int Length, const char *Format, ...)
+{
+  if(Length < 0)                                              // An earlier item did not fit
+    return Length;
+  va_list Args;
+  va_start(Args, Format);
+  int n = vsnprintf(Text + Length, Size - Length, Format, Args);
+  va_end(Args);
+  if(n < 0 || (size_t)n >= Size - Length){                   // Never half an item, a cut "\\n" would break the JSON string
+    Text[Length] = 0;
+    return -1;
+  }
+  return Length + n;
+}
+int TimerEvent_Render(const Timing_RTC *event, char *Text, size_t Size)
+{
+  char datetime_str[50];
+  Relay_Mask_t Changed = event->Open | event->Closs;
+  datetime_to_str(datetime_str, event->Time);
+  int Length = TimerEvent_Append(Text, Size, 0, "Event %d : %s ", event->Event_Number, datetime_str);
+  if(Changed && !(Changed & (Changed - 1))){                 // One channel (TimerEvent_CHx_Set())
+    for (int i = 0; i < Relay_Number_MAX; i++) {
+      if((Changed >> i) & 0x01)
+        Length = TimerEvent_Append(Text, Size, Length, "set %s %s ", Relay_Channels.CH[i].Name, (event->Open >> i) & 0x01 ? "Open " : "Closs");
+    }
+  }
+  else{
+    Length = TimerEvent_Append(Text, Size, Length, "\\n&nbsp;&nbsp;&nbsp;&nbsp;CHx&nbsp;&nbsp;:");
+    for (int i = 0; i < Relay_Number_MAX; i++) {
+      Length = TimerEvent_Append(Text, Size, Length, "%s&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;", Relay_Channels.CH[i].Name);
+    }
+    Length = TimerEvent_Append(Text, Size, Length, "\\n&nbsp;&nbsp;&nbsp;&nbsp;State&nbsp;:");
+    for (int i = 0; i < Relay_Number_MAX; i++) {
+      if((event->Open >> i) & 0x01)
+        Length = TimerEvent_Append(Text, Size, Length, "Open&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;");
+      else if((event->Closs >> i) & 0x01)
+        Length = TimerEvent_Append(Text, Size, Length, "Closs&nbsp;&nbsp;&nbsp;&nbsp;&nbsp;");
+      else
+        Length = TimerEvent_Append(Text, Size, Length, "Retain&nbsp;&nbsp;&nbsp;");
+    }
+    Length = TimerEvent_Append(Text, Size, Length, "\\n&nbsp;&nbsp;&nbsp;&nbsp;");
+  }
+  Length = TimerEvent_Append(Text, Size, Length, "----- %s\\n\\n", Event_cycle[event->repetition_State]);
+  if(Length < 0){
+    printf("TimerEvent_Render(function): Event %d does not fit in %d bytes and is cut!!!!\r\n", event->Event_Number, (int)Size);
+    Length = strlen(Text);
+  }
+  return Length;
+}
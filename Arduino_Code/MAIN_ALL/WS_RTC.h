@@ -3,8 +3,16 @@
 #include "WS_PCF85063.h"
 #include "WS_Relay.h"
 #include "WS_GPIO.h"
+#include "WS_Tasks.h"
 
-#define Timing_events_Number_MAX    10              // Indicates the number of timers that can be set
+#define Timing_events_Number_MAX    200             // Indicates the number of timers that can be set (at most 255)
+#define RTC_Event_Grace_S           60              // An event found later than this (e.g. after a power cut) is skipped, not executed (unit: s)
+#define RTC_Time_Jump_S             2               // A clock step larger than this reschedules every event (unit: s)
+#define RTC_Sleep_MAX_S             60              // RTCTask re-checks the clock at least this often (unit: s)
+#define RTC_Alarm_Lead_S            2               // With PCF85063_INT_PIN the alarm wakes RTCTask this early, the rest is timed (RTC / system clock skew)
+#define RTC_Alarm_Fallback_S        3600            // With PCF85063_INT_PIN RTCTask still wakes at least this often (unit: s)
+#define RTC_Event_NVS_Namespace     "RTC_Event"     // The event list survives reboots in NVS
+#define RTC_Event_Text_Size         (192 + Relay_Number_MAX * 81)  // TimerEvent_Render() of one event with every channel in the table (190 + 81 per channel + NUL)
 
 typedef enum {
   Repetition_NONE = 0,        // aperiodicity
@@ -16,21 +24,23 @@ typedef enum {
 typedef struct {
   bool Enable_Flag = false;                                   // The timer event enabled flag.    
   uint8_t Event_Number = 0;                                   // Current event sequence number   
-  Status_adjustment Relay_CH1 = STATE_Retain;                       // The CH1 status is changed periodically
-  Status_adjustment Relay_CH2 = STATE_Retain;                       // The CH2 status is changed periodically
-  Status_adjustment Relay_CH3 = STATE_Retain;                       // The CH3 status is changed periodically
-  Status_adjustment Relay_CH4 = STATE_Retain;                       // The CH4 status is changed periodically
-  Status_adjustment Relay_CH5 = STATE_Retain;                       // The CH5 status is changed periodically
-  Status_adjustment Relay_CH6 = STATE_Retain;                       // The CH6 status is changed periodically
-  Status_adjustment Relay_CH7 = STATE_Retain;                       // The CH7 status is changed periodically
-  Status_adjustment Relay_CH8 = STATE_Retain;                       // The CH8 status is changed periodically
+  Relay_Mask_t Open = 0;                                      // Channels that are opened
+  Relay_Mask_t Closs = 0;                                     // Channels that are clossed, the others are retained
   datetime_t Time;
   Repetition_event repetition_State = Repetition_NONE;         // Periodic execution
+  uint32_t Next_Fire = 0;                                       // Epoch of the next execution, 0 : will not fire again
 }Timing_RTC;
 
+typedef struct __attribute__((packed)) {     // One event in NVS
+  uint32_t Time;                             // Epoch of Time (the date part matters for Repetition_NONE / Weekly / monthly)
+  Relay_Mask_t Open;
+  Relay_Mask_t Closs;
+  uint8_t Repetition;
+  uint8_t Dotw;                              // Weekday as entered, the web form and BLE send it apart from the date (weekly events)
+} RTC_Event_Record;
+
 extern uint8_t Timing_events_Num;
 extern Timing_RTC CHx_State[Timing_events_Number_MAX];
-extern char Event_str[Timing_events_Number_MAX][1000];
 
 void RTCTask(void *parameter);
 void TimerEvent_handling(Timing_RTC event);
@@ -38,8 +48,13 @@ void TimerEvent_printf(Timing_RTC event);
 void TimerEvent_Del(Timing_RTC event);
 
 void RTC_Init(void);
-void TimerEvent_CHx_Set(datetime_t time,uint8_t CHx, bool State, Repetition_event Repetition);
-void TimerEvent_CHxs_Set(datetime_t time,uint8_t PinState, Repetition_event Repetition);
+void RTC_Sync_From_System(void);                  // Never blocks (SNTP callback) : RTCTask writes the system clock to the PCF85063
+void TimerEvent_CHx_Set(datetime_t time,uint8_t CHx, bool State, Repetition_event Repetition);   // CHx : 1 ~ Relay_Number_MAX
+void TimerEvent_CHxs_Set(datetime_t time,Relay_Mask_t PinState, Repetition_event Repetition);
 void TimerEvent_CHxn_Set(datetime_t time,Status_adjustment *Relay_n, Repetition_event Repetition);
 void TimerEvent_printf_ALL(void);
-void TimerEvent_Del_Number(uint8_t Event_Number);
\ No newline at end of file
+void TimerEvent_Del_Number(uint8_t Event_Number);
+uint32_t TimerEvent_Next_Fire(const Timing_RTC *event, uint32_t After);    // Epoch of the first execution at or after After, 0 : never again
+uint32_t TimerEvent_Revision(void);                                         // Changes whenever an event is added, removed or finished
+bool TimerEvent_Get(uint8_t Event_Number, Timing_RTC *event);               // Consistent copy of one event, false if it does not exist
+int TimerEvent_Render(const Timing_RTC *event, char *Text, size_t Size);    // Display text of the web page, JSON string escaped, cut after the last item that fits (reported)
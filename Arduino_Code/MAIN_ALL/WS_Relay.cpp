@@ -1,12 +1,32 @@
 #include "WS_Relay.h"
+#include "WS_Relay_Store.h"
+#include "WS_SD_Log.h"
+#include <atomic>
 
-bool Failure_Flag = 0;
+static bool Failure_Reported = false;                       // An alarm was started, the next one waits until it ended
+static uint32_t Failure_Time = 0;
+static TaskHandle_t Relay_Task_Handle = NULL;               // Relay actuator task, the only task that touches the TCA9554 and Relay_Flag
+static SemaphoreHandle_t Relay_Job_Lock = NULL;             // Relay_Run_Job() : one job at a time
+static SemaphoreHandle_t Relay_Job_Done = NULL;
+static_assert(Relay_Number_MAX <= 8, "The TCA9554 drives 8 channels, a wider board needs a wider Set_EXIOS()");
 /*************************************************************  Relay I/O  *************************************************************/
+// Only RelayTask writes the relays, so no lock is needed. Failures within one alarm are reported once.
+static void Relay_Failure(void)
+{
+  uint32_t Now = millis();
+  if(Failure_Reported && Now - Failure_Time < Relay_Failure_Alarm_MS)
+    return;
+  Failure_Reported = true;
+  Failure_Time = Now;
+  printf("Error: Relay control failed!!!\r\n");
+  //RGB_Open_Time(60,0,0,Relay_Failure_Alarm_MS,500);
+  Buzzer_Open_Time(Relay_Failure_Alarm_MS, 500);
+}
 bool Relay_Open(uint8_t CHx)
 {
   if(!Set_EXIO(CHx, true)){
     printf("Failed to Open CH%d!!!\r\n", CHx);
-    Failure_Flag = 1;
+    Relay_Failure();
     return 0;
   }
   return 1;
@@ -15,7 +35,7 @@ bool Relay_Closs(uint8_t CHx)
 {
   if(!Set_EXIO(CHx, false)){
     printf("Failed to Closs CH%d!!!\r\n", CHx);
-    Failure_Flag = 1;
+    Relay_Failure();
     return 0;
   }
   return 1;
@@ -24,7 +44,7 @@ bool Relay_CHx_Toggle(uint8_t CHx)
 {
    if(!Set_Toggle(CHx)){
     printf("Failed to Toggle CH%d!!!\r\n", CHx);
-    Failure_Flag = 1;
+    Relay_Failure();
     return 0;
   }
   return 1;
@@ -37,237 +57,356 @@ bool Relay_CHx(uint8_t CHx, bool State)
   else
     result = Relay_Closs(CHx);
   if(!result)
-    Failure_Flag = 1;
+    Relay_Failure();
   return result;
 }
 bool Relay_CHxs_PinState(uint8_t PinState)
 {
   if(!Set_EXIOS(PinState)){
     printf("Failed to set the relay status!!!\r\n");
-    Failure_Flag = 1;
+    Relay_Failure();
     return 0;
   }
   return 1;
 }
 
-void RelayFailTask(void *parameter) {
-  while(1){
-    if(Failure_Flag)
-    {
-      Failure_Flag = 0;
-      printf("Error: Relay control failed!!!\r\n");
-      //RGB_Open_Time(60,0,0,5000,500);
-      Buzzer_Open_Time(5000, 500);
-    }
-    vTaskDelay(pdMS_TO_TICKS(50));
-  }
-  vTaskDelete(NULL);
+void RelayTask(void *parameter);
+/********************************************************  Data Analysis  ********************************************************/
+bool Relay_Flag[Relay_Number_MAX] = {0};       // Relay current status flag
+static std::atomic<Relay_Mask_t> Relay_PinState(0);        // Relay_Flag as one bit per channel, readable from any task
+
+Relay_Mask_t Relay_Get_PinState(void)
+{
+  return Relay_PinState.load(std::memory_order_acquire);
 }
+
+// A reset of the ESP32 alone (brownout of the module, watchdog, esp_restart) leaves the TCA9554 latched : the relays
+// keep their state instead of dropping for the whole boot. A chip that lost its supply gets the stored state, see WS_Relay_Store.h.
 void Relay_Init(void)
 {
-  TCA9554PWR_Init(0x00);
-  xTaskCreatePinnedToCore(
-    RelayFailTask,    
-    "RelayFailTask",   
-    4096,                
-    NULL,                 
-    3,                   
-    NULL,                 
-    0                   
-  );
+  Relay_Mask_t PinState = 0;
+  const char *Source = Relay_Store_Load(&PinState);
+  if(TCA9554PWR_Adopt(0x00)){
+    PinState = Read_EXIOS_Shadow();
+    printf("Note : Relay outputs kept across the reset, state 0x%02X !\r\n", PinState);
+  }
+  else{
+    TCA9554PWR_Init(0x00, PinState);                 // Outputs first, then the direction : one Set_EXIOS() and no off glitch
+    if(Source)
+      printf("Note : Relay state 0x%02X restored from %s !\r\n", PinState, Source);
+  }
+  for (int i = 0; i < Relay_Number_MAX; i++) {
+    Relay_Flag[i] = (PinState >> i) & 0x01;
+  }
+  Relay_PinState.store(PinState, std::memory_order_release);
+  Relay_Store_Start(PinState);
+  Relay_Job_Lock = xSemaphoreCreateMutex();
+  Relay_Job_Done = xSemaphoreCreateBinary();
+  Task_Start(Task_Relay, RelayTask, &Relay_Task_Handle);
+}
+
+static Relay_Listener Relay_Listeners[Relay_Listener_MAX];
+static std::atomic<uint8_t> Relay_Listener_Count(0);
+static portMUX_TYPE Relay_Listener_Lock = portMUX_INITIALIZER_UNLOCKED;
+
+bool Relay_Add_Listener(Relay_Listener Listener)
+{
+  bool Result = 0;
+  portENTER_CRITICAL(&Relay_Listener_Lock);
+  uint8_t Count = Relay_Listener_Count.load(std::memory_order_relaxed);
+  if(Count < Relay_Listener_MAX){
+    Relay_Listeners[Count] = Listener;
+    Relay_Listener_Count.store(Count + 1, std::memory_order_release);   // The slot is written before RelayTask can see it
+    Result = 1;
+  }
+  portEXIT_CRITICAL(&Relay_Listener_Lock);
+  if(!Result)
+    printf("Relay_Add_Listener(function): No free listener slot!!!!\r\n");
+  return Result;
+}
+static void Relay_Notify_Listeners(Relay_Mask_t PinState)
+{
+  uint8_t Count = Relay_Listener_Count.load(std::memory_order_acquire);
+  for (uint8_t i = 0; i < Count; i++) {
+    Relay_Listeners[i](PinState);
+  }
 }
 
-/********************************************************  Data Analysis  ********************************************************/
-bool Relay_Flag[8] = {0};       // Relay current status flag
-void Relay_Analysis(uint8_t *buf,uint8_t Mode_Flag)
+const char *Relay_Source_Name(uint8_t Mode_Flag)
 {
-  uint8_t ret = 0;
-  if(Mode_Flag == Bluetooth_Mode)
-    printf("Bluetooth Data :\r\n");
-  else if(Mode_Flag == WIFI_Mode)
-    printf("WIFI Data :\r\n");
-  else if(Mode_Flag == MQTT_Mode)
-    printf("MQTT Data :\r\n");
-  else if(Mode_Flag == RS485_Mode)
-    printf("RS485 Data :\r\n");  
-  switch(buf[0])
+  switch(Mode_Flag)
   {
-    case CH1: 
-      ret = Relay_CHx_Toggle(GPIO_PIN_CH1);                                              //Toggle the level status of the GPIO_PIN_CH1 pin
-      if(ret){
-        Relay_Flag[0] =! Relay_Flag[0];
-        Buzzer_Open_Time(200, 0);
-        if(Relay_Flag[0])
-          printf("|***  Relay CH1 on  ***|\r\n");
-        else
-          printf("|***  Relay CH1 off ***|\r\n");
-      }
-      break;
-    case CH2: 
-      ret = Relay_CHx_Toggle(GPIO_PIN_CH2);                                             //Toggle the level status of the GPIO_PIN_CH2 pin
-      if(ret){
-        Relay_Flag[1] =! Relay_Flag[1];
-        Buzzer_Open_Time(200, 0);
-        if(Relay_Flag[1])
-          printf("|***  Relay CH2 on  ***|\r\n");
-        else
-          printf("|***  Relay CH2 off ***|\r\n");
-      }
-      break;
-    case CH3:
-      ret = Relay_CHx_Toggle(GPIO_PIN_CH3);                                             //Toggle the level status of the GPIO_PIN_CH3 pin
-      if(ret){
-        Relay_Flag[2] =! Relay_Flag[2];
-        Buzzer_Open_Time(200, 0);
-        if(Relay_Flag[2])
-          printf("|***  Relay CH3 on  ***|\r\n");
-        else
-          printf("|***  Relay CH3 off ***|\r\n");
+    case DIN_Mode:        return "DIN";
+    case RS485_Mode:      return "RS485";
+    case Bluetooth_Mode:  return "Bluetooth";
+    case WIFI_Mode:       return "WIFI";
+    case MQTT_Mode:       return "MQTT";
+    case RTC_Mode:        return "RTC";
+    case CAN_Mode:        return "CAN";
+    default:              return "Unknown";
+  }
+}
+
+/********************************************************  Command queue  ********************************************************/
+// Every source (DIN_Mode ... RTC_Mode) owns one single-producer/single-consumer ring.
+// The transport task of that source is the only writer of Head, RelayTask is the only writer of Tail,
+// so enqueueing never blocks and never takes a lock.
+typedef struct {
+  Relay_Command Buffer[Relay_Queue_Length];
+  std::atomic<uint32_t> Head;                               // Next slot to be written (producer)
+  std::atomic<uint32_t> Tail;                               // Next slot to be read (RelayTask)
+} Relay_Ring;
+static Relay_Ring Relay_Queue[Relay_Source_Number];
+
+static bool Relay_Enqueue(const Relay_Command *Command)
+{
+  if(!Command->Mode_Flag || Command->Mode_Flag > Relay_Source_Number){
+    printf("Relay_Enqueue(function): Unknown command source %d!!!!\r\n", Command->Mode_Flag);
+    return 0;
+  }
+  Relay_Ring *Ring = &Relay_Queue[Command->Mode_Flag - 1];
+  uint32_t Head = Ring->Head.load(std::memory_order_relaxed);
+  uint32_t Tail = Ring->Tail.load(std::memory_order_acquire);
+  if(Head - Tail >= Relay_Queue_Length){
+    WS_LOG(RELAY, LOG_WARN, "Note : The relay command queue of source %d is full and the command has been ignored\r\n", Command->Mode_Flag);
+    return 0;
+  }
+  Ring->Buffer[Head % Relay_Queue_Length] = *Command;
+  Ring->Buffer[Head % Relay_Queue_Length].Ingress = Trace_Now();
+  Ring->Head.store(Head + 1, std::memory_order_release);
+  if(Relay_Task_Handle)
+    xTaskNotifyGive(Relay_Task_Handle);
+  return 1;
+}
+static bool Relay_Dequeue(uint8_t Source, Relay_Command *Command)
+{
+  Relay_Ring *Ring = &Relay_Queue[Source];
+  uint32_t Tail = Ring->Tail.load(std::memory_order_relaxed);
+  if(Tail == Ring->Head.load(std::memory_order_acquire))
+    return 0;
+  *Command = Ring->Buffer[Tail % Relay_Queue_Length];
+  Ring->Tail.store(Tail + 1, std::memory_order_release);
+  return 1;
+}
+
+/********************************************************  Jobs  ********************************************************/
+// Other tasks that need the TCA9554 (the benchmark) hand a function to RelayTask instead of racing its writes
+static std::atomic<Relay_Job> Relay_Job_Function(NULL);
+static void *Relay_Job_Arg = NULL;
+
+bool Relay_Run_Job(Relay_Job Job, void *Arg)
+{
+  if(!Relay_Task_Handle || !Relay_Job_Lock || xTaskGetCurrentTaskHandle() == Relay_Task_Handle){
+    printf("Relay_Run_Job(function): RelayTask is not available!!!!\r\n");
+    return 0;
+  }
+  xSemaphoreTake(Relay_Job_Lock, portMAX_DELAY);
+  Relay_Job_Arg = Arg;
+  Relay_Job_Function.store(Job, std::memory_order_release);
+  xTaskNotifyGive(Relay_Task_Handle);
+  xSemaphoreTake(Relay_Job_Done, portMAX_DELAY);             // Arg may live on the caller's stack, so there is no timeout
+  xSemaphoreGive(Relay_Job_Lock);
+  return 1;
+}
+static void Relay_Run_Pending_Job(void)
+{
+  Relay_Job Job = Relay_Job_Function.exchange(NULL, std::memory_order_acquire);
+  if(!Job)
+    return;
+  Job(Relay_Job_Arg);
+  xSemaphoreGive(Relay_Job_Done);
+}
+
+// One batch : every command that arrived within Relay_Batch_Window_MS is folded into a single target state
+typedef struct {
+  Relay_Mask_t PinState;          // Target state after all folded commands
+  uint8_t Sources;                // Bit (Mode_Flag - 1) set for every source that contributed
+  uint16_t Buzzer_Time;           // Strongest indication requested by the folded commands
+  uint16_t Buzzer_Flicker;
+  uint16_t Traced;                // Commands with a stamp in Trace[]
+  struct {
+    uint8_t Mode_Flag;
+    uint32_t Ingress;
+    uint32_t Dequeue;
+  } Trace[Relay_Source_Number * Relay_Queue_Length];   // Further commands of a long batch are not traced
+} Relay_Batch;
+
+static void Relay_Batch_Buzzer(Relay_Batch *Batch, uint16_t Time, uint16_t flicker_time)
+{
+  if(Time > Batch->Buzzer_Time || (Time == Batch->Buzzer_Time && flicker_time > Batch->Buzzer_Flicker)){
+    Batch->Buzzer_Time = Time;
+    Batch->Buzzer_Flicker = flicker_time;
+  }
+}
+
+static void Relay_Fold(const Relay_Command *Command, Relay_Batch *Batch)
+{
+  int CHx = -1;
+  switch(Command->Type)
+  {
+    case Relay_Cmd_Analysis:
+      CHx = Relay_Channels.Find_Instruction(Command->Data[0]);
+      if(CHx >= 0){
+        Batch->PinState ^= (Relay_Mask_t)(1UL << CHx);                                 // Toggle the channel
+        Relay_Batch_Buzzer(Batch, 200, 0);
       }
-      break;
-    case CH4:
-      ret = Relay_CHx_Toggle(GPIO_PIN_CH4);                                             //Toggle the level status of the GPIO_PIN_CH4 pin
-      if(ret){
-        Relay_Flag[3] =! Relay_Flag[3];
-        Buzzer_Open_Time(200, 0);
-        if(Relay_Flag[3])
-          printf("|***  Relay CH4 on  ***|\r\n");
-        else
-          printf("|***  Relay CH4 off ***|\r\n");
+      else if(Command->Data[0] == ALL_ON){
+        Batch->PinState = Relay_Channels.All;                                          // Turn on all relay
+        Relay_Batch_Buzzer(Batch, 500, 0);
       }
-      break;
-    case CH5:
-      ret = Relay_CHx_Toggle(GPIO_PIN_CH5);                                             //Toggle the level status of the GPIO_PIN_CH5 pin
-      if(ret){  
-        Relay_Flag[4] =! Relay_Flag[4];
-        Buzzer_Open_Time(200, 0);
-        if(Relay_Flag[4])
-          printf("|***  Relay CH5 on  ***|\r\n");
-        else
-          printf("|***  Relay CH5 off ***|\r\n");
+      else if(Command->Data[0] == ALL_OFF){
+        Batch->PinState = 0x00;                                                        // Turn off all relay
+        Relay_Batch_Buzzer(Batch, 500, 150);
       }
-      break;
-    case CH6:
-      ret = Relay_CHx_Toggle(GPIO_PIN_CH6);                                             //Toggle the level status of the GPIO_PIN_CH6 pin
-      if(ret){
-        Relay_Flag[5] =! Relay_Flag[5];
-        Buzzer_Open_Time(200, 0);
-        if(Relay_Flag[5])
-          printf("|***  Relay CH6 on  ***|\r\n");
-        else
-          printf("|***  Relay CH6 off ***|\r\n");
+      else{
+        printf("Note : Non-instruction data was received !  -  %c\r\n", Command->Data[0]);
+        return;
       }
       break;
-    case CH7:
-      ret = Relay_CHx_Toggle(GPIO_PIN_CH7);                                             //Toggle the level status of the GPIO_PIN_CH6 pin
-      if(ret){
-        Relay_Flag[6] =! Relay_Flag[6];
-        Buzzer_Open_Time(200, 0);
-        if(Relay_Flag[6])
-          printf("|***  Relay CH7 on  ***|\r\n");
-        else
-          printf("|***  Relay CH7 off ***|\r\n");
+    case Relay_Cmd_Immediate:
+      if(!Command->Data[0] || Command->Data[0] > Relay_Number_MAX){
+        printf("Relay_Immediate(function): Incoming parameter error!!!!\r\n");
+        Relay_Failure();
+        return;
       }
+      if(Command->Data[1])
+        Batch->PinState |= (Relay_Mask_t)(1UL << (Command->Data[0] - 1));
+      else
+        Batch->PinState &= (Relay_Mask_t)~(1UL << (Command->Data[0] - 1));
+      Relay_Batch_Buzzer(Batch, 200, 0);
       break;
-    case CH8:
-      ret = Relay_CHx_Toggle(GPIO_PIN_CH8);                                             //Toggle the level status of the GPIO_PIN_CH6 pin
-      if(ret){
-        Relay_Flag[7] =! Relay_Flag[7];
-        Buzzer_Open_Time(200, 0);
-        if(Relay_Flag[7])
-          printf("|***  Relay CH8 on  ***|\r\n");
-        else
-          printf("|***  Relay CH8 off ***|\r\n");
-      }
+    case Relay_Cmd_CHxs:
+      Batch->PinState = Command->Data[0] & Relay_Channels.All;
+      Relay_Batch_Buzzer(Batch, 200, 0);
       break;
-    case ALL_ON:
-      ret = Relay_CHxs_PinState(0xFF);                                              // Turn on all relay
-      if(ret){
-        memset(Relay_Flag,1, sizeof(Relay_Flag));
-        printf("|***  Relay ALL on  ***|\r\n");
-        Buzzer_Open_Time(500, 0);
-      }
-
+    case Relay_Cmd_CHxn:
+      Batch->PinState = (((Batch->PinState | Command->Data[0]) & (Relay_Mask_t)~Command->Data[1]) ^ Command->Data[2]) & Relay_Channels.All;
+      Relay_Batch_Buzzer(Batch, 200, 0);
       break;
-    case ALL_OFF:
-      ret = Relay_CHxs_PinState(0x00);                                                // Turn off all relay
-      if(ret){
-        memset(Relay_Flag,0, sizeof(Relay_Flag));
-        printf("|***  Relay ALL off ***|\r\n");
-        Buzzer_Open_Time(500, 150); 
-      }
+    case Relay_Cmd_Toggle:
+      Batch->PinState ^= Command->Data[0] & Relay_Channels.All;
+      Relay_Batch_Buzzer(Batch, 200, 0);
       break;
     default:
-      printf("Note : Non-instruction data was received !  -  %c\r\n", buf[0]);
+      printf("Relay_Fold(function): Unknown command type %d!!!!\r\n", Command->Type);
+      return;
   }
+  Batch->Sources |= (1 << (Command->Mode_Flag - 1));
 }
 
-void Relay_Immediate(uint8_t CHx, bool State, uint8_t Mode_Flag)
+static void Relay_Apply(Relay_Batch *Batch)
 {
-  if(!CHx || CHx > 8){
-    printf("Relay_Immediate(function): Incoming parameter error!!!!\r\n");
-    Failure_Flag = 1;
+  Relay_Mask_t PinState_Old = Relay_Get_PinState();
+  for (uint8_t i = 0; i < Relay_Source_Number; i++) {
+    if((Batch->Sources >> i) & 0x01)
+      WS_LOG(RELAY, LOG_INFO, "%s Data :\r\n", Relay_Source_Name(i + 1));
   }
-  else{
-    uint8_t ret = 0;
-    if(Mode_Flag == DIN_Mode)
-      printf("DIN Data :\r\n"); 
-    else if(Mode_Flag == RTC_Mode)
-      printf("RTC Data :\r\n");
-    ret = Relay_CHx(CHx,State);                                               
-    if(ret){
-      Relay_Flag[CHx-1] = State;
-      Buzzer_Open_Time(200, 0);
-      if(Relay_Flag[0])
-        printf("|***  Relay CH%d on  ***|\r\n",CHx);
-      else
-        printf("|***  Relay CH%d off ***|\r\n",CHx);
+  if(Batch->PinState != PinState_Old){
+    uint32_t I2C_Start = Trace_Now();
+    if(!Relay_CHxs_PinState(Batch->PinState)){                                          // One write for the whole batch, all changed channels switch together
+      printf("Relay_Apply(function): Relay control failure!!!!\r\n");
+      SD_Log_Write(SD_Log_Relay_Failure, Batch->Sources, PinState_Old, Batch->PinState);
+      return;
     }
+    Trace_Record_I2C(I2C_Start, Trace_Now());
+    for (int i = 0; i < Relay_Number_MAX; i++) {
+      Relay_Flag[i] = (Batch->PinState >> i) & 0x01;
+    }
+    Relay_PinState.store(Batch->PinState, std::memory_order_release);
+    Relay_Notify_Listeners(Batch->PinState);
+    SD_Log_Write(SD_Log_Relay, Batch->Sources, PinState_Old, Batch->PinState);
+    for (int i = 0; i < Relay_Number_MAX; i++) {
+      if(((Batch->PinState ^ PinState_Old) >> i) & 0x01){
+        if(Relay_Flag[i])
+          WS_LOG(RELAY, LOG_INFO, "|***  Relay %s on  ***|\r\n", Relay_Channels.CH[i].Name);
+        else
+          WS_LOG(RELAY, LOG_INFO, "|***  Relay %s off ***|\r\n", Relay_Channels.CH[i].Name);
+      }
+    }
+  }
+  uint32_t Done = Trace_Now();                                                           // The relay edge : the write returned, or nothing had to change
+  for (uint16_t i = 0; i < Batch->Traced; i++) {
+    Trace_Record(Batch->Trace[i].Mode_Flag, Batch->Trace[i].Ingress, Batch->Trace[i].Dequeue, Done);
   }
+  Buzzer_Open_Time(Batch->Buzzer_Time, Batch->Buzzer_Flicker);
 }
-void Relay_Immediate_CHxn(Status_adjustment * Relay_n, uint8_t Mode_Flag)
+
+void RelayTask(void *parameter)
 {
-  uint8_t ret = 0;
-  if(Mode_Flag == DIN_Mode)
-    printf("DIN Data :\r\n"); 
-  else if(Mode_Flag == RTC_Mode)
-    printf("RTC Data :\r\n");            
-  for (int i = 0; i < 8; i++) {
-    if(Relay_n[i] == STATE_Open || Relay_n[i] == STATE_Closs){
-      Relay_Flag[i] = (bool)Relay_n[i];
-      ret = Relay_CHx(i+1,Relay_n[i]);  
-      if(Relay_n[i] == STATE_Open)
-        printf("|***  Relay CH%d on  ***|\r\n",i+1);
-      else if(Relay_n[i] == STATE_Closs)
-        printf("|***  Relay CH%d off ***|\r\n",i+1);
+  Relay_Command Command;
+  static Relay_Batch Batch;                                   // Static, the trace stamps would take a third of the stack
+  while(1){
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    Relay_Run_Pending_Job();
+    if(Relay_Batch_Window_MS)
+      vTaskDelay(pdMS_TO_TICKS(Relay_Batch_Window_MS));    // Let the commands of the other sources that land in the same window join this batch
+    Batch.PinState = Relay_Get_PinState();
+    Batch.Sources = 0;
+    Batch.Buzzer_Time = 0;
+    Batch.Buzzer_Flicker = 0;
+    Batch.Traced = 0;
+    bool Pending = true;
+    while(Pending){                                           // Round robin keeps the arrival order between sources roughly intact
+      Pending = false;
+      for (uint8_t i = 0; i < Relay_Source_Number; i++) {
+        if(Relay_Dequeue(i, &Command)){
+          if(Batch.Traced < sizeof(Batch.Trace) / sizeof(Batch.Trace[0])){
+            Batch.Trace[Batch.Traced].Mode_Flag = Command.Mode_Flag;
+            Batch.Trace[Batch.Traced].Ingress = Command.Ingress;
+            Batch.Trace[Batch.Traced].Dequeue = Trace_Now();
+            Batch.Traced++;
+          }
+          Relay_Fold(&Command, &Batch);
+          Pending = true;
+        }
+      }
     }
+    if(Batch.Sources)
+      Relay_Apply(&Batch);
   }
-  Buzzer_Open_Time(200, 0);
+  vTaskDelete(NULL);
 }
 
-void Relay_Immediate_CHxs(uint8_t PinState, uint8_t Mode_Flag)
+/*******************************************************  Command entry  *******************************************************/
+// Called from the transport tasks. They only enqueue and return, RelayTask performs the I2C write.
+void Relay_Analysis(uint8_t *buf,uint8_t Mode_Flag)
 {
-  uint8_t ret = 0;
-  if(Mode_Flag == DIN_Mode)
-    printf("DIN Data :\r\n"); 
-  else if(Mode_Flag == RTC_Mode)
-    printf("RTC Data :\r\n");
-  for (int i = 0; i < 8; i++) {
-    Relay_Flag[i] = (PinState >> i) & 0x01; // 提取每一位并赋值
-  }
-  ret = Relay_CHxs_PinState(PinState);                                               
-  if(ret){
-    for (int j = 0; j < 8; j++) {
-      if(Relay_Flag[j])
-        printf("|***  Relay CH%d on  ***|\r\n",j+1);
-      else
-        printf("|***  Relay CH%d off ***|\r\n",j+1);
-    }
-    Buzzer_Open_Time(200, 0);
-  }
-  else
-  {
-    printf("Relay_Immediate_CHxs(function): Relay control failure!!!!\r\n");
-    Failure_Flag = 1;
+  Relay_Command Command = {Relay_Cmd_Analysis, Mode_Flag, {buf[0], 0}};
+  Relay_Enqueue(&Command);
+}
+void Relay_Immediate(uint8_t CHx, bool State, uint8_t Mode_Flag)
+{
+  Relay_Command Command = {Relay_Cmd_Immediate, Mode_Flag, {CHx, State}};
+  Relay_Enqueue(&Command);
+}
+void Relay_Immediate_CHxn(Status_adjustment * Relay_n, uint8_t Mode_Flag)
+{
+  Relay_Command Command = {Relay_Cmd_CHxn, Mode_Flag, {0, 0}};
+  for (int i = 0; i < Relay_Number_MAX; i++) {
+    if(Relay_n[i] == STATE_Open)
+      Command.Data[0] |= (Relay_Mask_t)(1UL << i);
+    else if(Relay_n[i] == STATE_Closs)
+      Command.Data[1] |= (Relay_Mask_t)(1UL << i);
   }
-}
\ No newline at end of file
+  Relay_Enqueue(&Command);
+}
+void Relay_Immediate_Masks(Relay_Mask_t Open, Relay_Mask_t Closs, uint8_t Mode_Flag)
+{
+  Relay_Command Command = {Relay_Cmd_CHxn, Mode_Flag, {Open, Closs}};
+  Relay_Enqueue(&Command);
+}
+void Relay_Immediate_Toggle(Relay_Mask_t Toggle, uint8_t Mode_Flag)
+{
+  Relay_Command Command = {Relay_Cmd_Toggle, Mode_Flag, {Toggle, 0}};
+  Relay_Enqueue(&Command);
+}
+void Relay_Immediate_Change(Relay_Mask_t Open, Relay_Mask_t Closs, Relay_Mask_t Toggle, uint8_t Mode_Flag)
+{
+  Relay_Command Command = {Relay_Cmd_CHxn, Mode_Flag, {Open, Closs, Toggle}};
+  Relay_Enqueue(&Command);
+}
+void Relay_Immediate_CHxs(Relay_Mask_t PinState, uint8_t Mode_Flag)
+{
+  Relay_Command Command = {Relay_Cmd_CHxs, Mode_Flag, {PinState, 0}};
+  Relay_Enqueue(&Command);
+}
@@ -3,6 +3,10 @@
 #include "WS_TCA9554PWR.h"
 #include <HardwareSerial.h>     // Reference the ESP32 built-in serial port library
 #include "WS_GPIO.h"
+#include "WS_Channel.h"
+#include "WS_Log.h"
+#include "WS_Trace.h"
+#include "WS_Tasks.h"
 
 
 /*************************************************************  I/O  *************************************************************/
@@ -16,6 +20,9 @@
 #define GPIO_PIN_CH7      EXIO_PIN7    // CH7 Control GPIO
 #define GPIO_PIN_CH8      EXIO_PIN8    // CH8 Control GPIO
 
+typedef Relay_Mask_Type<Relay_Number_MAX> Relay_Mask_t;               // One bit per channel, bit0 = CH1
+constexpr Relay_Channel_Table<Relay_Number_MAX> Relay_Channels;       // Names, instructions and Modbus frames of every channel
+
 
 #define CH1 '1'                 // CH1 Enabled Instruction              Hex : 0x31
 #define CH2 '2'                 // CH2 Enabled Instruction              Hex : 0x32
@@ -34,6 +41,13 @@
 #define WIFI_Mode         4
 #define MQTT_Mode         5
 #define RTC_Mode          6
+#define CAN_Mode          7
+#define Relay_Source_Number   7   // Number of command sources, each one has its own command queue
+
+#define Relay_Queue_Length    16  // Commands that can wait per source before RelayTask executes them
+#define Relay_Listener_MAX    6   // Modules that can be told about relay state changes
+#define Relay_Batch_Window_MS 2   // Commands arriving within this window after the first one are merged into one Set_EXIOS() write (unit: ms, 0: no wait)
+#define Relay_Failure_Alarm_MS 5000   // Buzzer alarm after a failed relay write, further failures during it are not reported again (unit: ms)
 
 typedef enum {
   STATE_Closs = 0,    // Closs Relay
@@ -41,7 +55,29 @@ typedef enum {
   STATE_Retain = 2,   // Stay in place
 } Status_adjustment;
 
-extern bool Relay_Flag[8];  // Relay current status flag
+typedef enum {
+  Relay_Cmd_Analysis = 0,   // Data[0] : CH1 ~ CH8 / ALL_ON / ALL_OFF instruction   (Relay_Analysis)
+  Relay_Cmd_Immediate = 1,  // Data[0] : CHx, Data[1] : State                        (Relay_Immediate)
+  Relay_Cmd_CHxs = 2,       // Data[0] : PinState mask                                (Relay_Immediate_CHxs)
+  Relay_Cmd_CHxn = 3,       // Data[0] : Open mask, Data[1] : Closs mask, then Data[2] : Toggle mask   (Relay_Immediate_CHxn / Relay_Immediate_Masks / Relay_Immediate_Change)
+  Relay_Cmd_Toggle = 4,     // Data[0] : Toggle mask                                  (Relay_Immediate_Toggle)
+} Relay_Command_Type;
+
+typedef struct {
+  uint8_t Type;             // Relay_Command_Type
+  uint8_t Mode_Flag;        // Data source
+  Relay_Mask_t Data[3];
+  uint32_t Ingress;         // Trace_Now() when the command was queued, set by the queue
+} Relay_Command;
+
+typedef void (*Relay_Listener)(Relay_Mask_t PinState);   // Runs in RelayTask after every state change, must not block
+typedef void (*Relay_Job)(void *Arg);                      // Runs in RelayTask between two batches, may use the TCA9554
+
+extern bool Relay_Flag[Relay_Number_MAX];  // Relay current status flag (written by RelayTask only)
+Relay_Mask_t Relay_Get_PinState(void);   // Relay_Flag as a bit mask (bit0 = CH1), consistent snapshot for other tasks
+bool Relay_Add_Listener(Relay_Listener Listener);
+const char *Relay_Source_Name(uint8_t Mode_Flag);
+bool Relay_Run_Job(Relay_Job Job, void *Arg);             // Waits until RelayTask ran Job, not from RelayTask itself
 
 void Relay_Init(void);
 bool Relay_Closs(uint8_t CHx);
@@ -50,7 +86,11 @@ bool Relay_CHx_Toggle(uint8_t CHx);
 bool Relay_CHx(uint8_t CHx, bool State);
 bool Relay_CHxs_PinState(uint8_t PinState);
 
+// The functions below queue the command and return immediately, RelayTask executes it
 void Relay_Analysis(uint8_t *buf,uint8_t Mode_Flag);
 void Relay_Immediate(uint8_t CHx, bool State, uint8_t Mode_Flag);
-void Relay_Immediate_CHxs(uint8_t PinState, uint8_t Mode_Flag);
+void Relay_Immediate_CHxs(Relay_Mask_t PinState, uint8_t Mode_Flag);
 void Relay_Immediate_CHxn(Status_adjustment * Relay_n, uint8_t Mode_Flag);
+void Relay_Immediate_Masks(Relay_Mask_t Open, Relay_Mask_t Closs, uint8_t Mode_Flag);   // Open / Closs mask, the other channels are retained
+void Relay_Immediate_Toggle(Relay_Mask_t Toggle, uint8_t Mode_Flag);                    // Every channel in the mask changes state
+void Relay_Immediate_Change(Relay_Mask_t Open, Relay_Mask_t Closs, Relay_Mask_t Toggle, uint8_t Mode_Flag);   // One command : Open / Closs, then Toggle
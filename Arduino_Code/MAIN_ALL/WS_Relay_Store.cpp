@@ -0,0 +1,122 @@
+#include "WS_Relay_Store.h"
+#include <Preferences.h>
+#include "esp_system.h"                             // esp_reset_reason()
+#include <atomic>
+
+#define Relay_Store_Magic   0x52535431              // "RST1"
+
+typedef struct {
+  uint32_t Magic;
+  uint32_t Sequence;                                // Increments with every change, the newer record wins
+  uint32_t PinState;
+  uint32_t Check;
+} Relay_Store_Record;
+
+static RTC_NOINIT_ATTR Relay_Store_Record Relay_Store_RTC;   // Not cleared by the startup code, Check tells garbage apart
+
+static Preferences Relay_Store_Preferences;
+static bool Relay_Store_Open = false;
+static TaskHandle_t Relay_Store_Task_Handle = NULL;
+static uint32_t Relay_Store_Sequence = 0;                    // Sequence of the last change (RelayTask)
+static Relay_Store_Record Relay_Store_NVS;                   // Last record in NVS (RelayStoreTask)
+static std::atomic<uint32_t> Relay_Store_Write_Count(0);
+
+static uint32_t Relay_Store_Check(const Relay_Store_Record *Record)
+{
+  uint32_t Check = Record->Magic ^ 0xA5A5A5A5;
+  Check = (Check << 7 | Check >> 25) ^ Record->Sequence;
+  Check = (Check << 7 | Check >> 25) ^ Record->PinState;
+  return Check;
+}
+static bool Relay_Store_Valid(const Relay_Store_Record *Record)
+{
+  return Record->Magic == Relay_Store_Magic && Record->Check == Relay_Store_Check(Record) && !(Record->PinState & ~(uint32_t)Relay_Channels.All);
+}
+static void Relay_Store_Fill(Relay_Store_Record *Record, Relay_Mask_t PinState, uint32_t Sequence)
+{
+  Record->Magic = Relay_Store_Magic;
+  Record->Sequence = Sequence;
+  Record->PinState = PinState;
+  Record->Check = Relay_Store_Check(Record);
+}
+
+const char *Relay_Store_Load(Relay_Mask_t *PinState)
+{
+  memset(&Relay_Store_NVS, 0, sizeof(Relay_Store_NVS));
+  Relay_Store_Open = Relay_Store_Preferences.begin(Relay_Store_NVS_Namespace, false);
+  if(!Relay_Store_Open)
+    printf("Relay_Store_Load(function): NVS namespace could not be opened!!!!\r\n");
+  else if(Relay_Store_Preferences.getBytesLength("State") == sizeof(Relay_Store_Record))
+    Relay_Store_Preferences.getBytes("State", &Relay_Store_NVS, sizeof(Relay_Store_NVS));
+  bool NVS_Valid = Relay_Store_Valid(&Relay_Store_NVS);
+  bool RTC_Valid = esp_reset_reason() != ESP_RST_POWERON && Relay_Store_Valid(&Relay_Store_RTC);
+  if(!NVS_Valid)
+    memset(&Relay_Store_NVS, 0, sizeof(Relay_Store_NVS));
+
+  const Relay_Store_Record *Record = NULL;
+  const char *Source = NULL;
+  if(RTC_Valid && (!NVS_Valid || (int32_t)(Relay_Store_RTC.Sequence - Relay_Store_NVS.Sequence) >= 0)){
+    Record = &Relay_Store_RTC;                      // Newer than NVS unless the write was still pending at the reset
+    Source = "RTC memory";
+  }
+  else if(NVS_Valid){
+    Record = &Relay_Store_NVS;
+    Source = "NVS";
+  }
+  if(!Record)
+    return NULL;
+  Relay_Store_Sequence = Record->Sequence;
+  if(!Relay_Store_Restore)
+    return NULL;
+  *PinState = (Relay_Mask_t)Record->PinState;
+  return Source;
+}
+
+static void Relay_Store_Changed(Relay_Mask_t PinState)     // Relay listener, RelayTask
+{
+  Relay_Store_Sequence++;
+  Relay_Store_Fill(&Relay_Store_RTC, PinState, Relay_Store_Sequence);
+  if(Relay_Store_Task_Handle)
+    xTaskNotifyGive(Relay_Store_Task_Handle);
+}
+
+void Relay_Store_Start(Relay_Mask_t PinState)
+{
+  Relay_Store_Fill(&Relay_Store_RTC, PinState, Relay_Store_Sequence);
+  if(!Relay_Store_Open)
+    return;                                         // RTC memory only
+  if(!Task_Start(Task_Relay_Store, RelayStoreTask, &Relay_Store_Task_Handle))
+    return;
+  if(!Relay_Store_Valid(&Relay_Store_NVS) || Relay_Store_NVS.PinState != PinState)
+    xTaskNotifyGive(Relay_Store_Task_Handle);       // Store the state the relays start with
+  Relay_Add_Listener(Relay_Store_Changed);
+}
+
+uint32_t Relay_Store_Writes(void)
+{
+  return Relay_Store_Write_Count.load(std::memory_order_relaxed);
+}
+
+void RelayStoreTask(void *parameter)
+{
+  while(1){
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    TickType_t First = xTaskGetTickCount();
+    while(xTaskGetTickCount() - First < pdMS_TO_TICKS(Relay_Store_Delay_MAX_MS)){
+      if(!ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(Relay_Store_Quiet_MS)))
+        break;                                      // Quiet : the state settled
+    }
+    Relay_Store_Record Record = Relay_Store_RTC;    // The RTC copy is written by RelayTask in one go, a torn read fails Check
+    if(!Relay_Store_Valid(&Record))
+      Relay_Store_Fill(&Record, Relay_Get_PinState(), Relay_Store_Sequence);
+    if(Relay_Store_Valid(&Relay_Store_NVS) && Relay_Store_NVS.PinState == Record.PinState)
+      continue;                                     // Toggled back, nothing to write
+    if(Relay_Store_Preferences.putBytes("State", &Record, sizeof(Record)) != sizeof(Record)){
+      printf("RelayStoreTask(function): NVS write failed!!!!\r\n");
+      continue;
+    }
+    Relay_Store_NVS = Record;
+    Relay_Store_Write_Count.fetch_add(1, std::memory_order_relaxed);
+  }
+  vTaskDelete(NULL);
+}
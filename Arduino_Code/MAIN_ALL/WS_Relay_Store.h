@@ -0,0 +1,21 @@
+#pragma once
+
+#include "WS_Relay.h"
+
+/*************************************************************  Relay state store  *************************************************************/
+// The relay state survives resets in two places :
+//   RTC slow memory (RTC_NOINIT_ATTR) : written on every change, kept by software, watchdog and brownout resets, lost at power-on.
+//   NVS ("Relay_State" / "State")   : (PinState, Sequence) record, written by RelayStoreTask once the state stayed the same for
+//                                      Relay_Store_Quiet_MS, at the latest Relay_Store_Delay_MAX_MS after the first change.
+//                                      NVS appends every write to its log pages and erases a page only when all of them are used,
+//                                      so no sector is rewritten per toggle.
+// Relay_Init() restores the record with one Set_EXIOS(), before the network and BLE come up.
+#define Relay_Store_Restore       1                 // 0 : every boot starts with all relays off, the state is still stored
+#define Relay_Store_NVS_Namespace "Relay_State"
+#define Relay_Store_Quiet_MS      2000              // Coalescing : no change for this long before the NVS write (unit: ms)
+#define Relay_Store_Delay_MAX_MS  10000             // A channel that keeps toggling is stored at least this often (unit: ms)
+
+const char *Relay_Store_Load(Relay_Mask_t *PinState);     // Source of the restored state ("RTC memory", "NVS"), NULL : nothing stored, PinState unchanged
+void Relay_Store_Start(Relay_Mask_t PinState);            // PinState : the state the relays start with, RelayStoreTask keeps the store up to date from here on
+uint32_t Relay_Store_Writes(void);                        // NVS writes since boot
+void RelayStoreTask(void *parameter);
@@ -6,13 +6,13 @@ bool SDCard_Finish = 0;
 uint16_t SDCard_Size = 0;
 uint16_t Flash_Size = 0;
 
-void SD_Init() {
+void SD_Init(bool Format_If_Mount_Failed) {
   // SD MMC
   if(!SD_MMC.setPins(SD_CLK_PIN, SD_CMD_PIN, SD_D0_PIN,-1,-1,-1)){
     printf("SD MMC: Pin change failed!\r\n");
     return;
   }
-  if (SD_MMC.begin("/sdcard", true, true)) {                // "/sdcard", true, true     or  "/sdcard", true, false                            
+  if (SD_MMC.begin("/sdcard", true, Format_If_Mount_Failed)) {   // 1-bit mode, formats the card on a failed mount only if asked to
     printf("SD card initialization successful!\r\n");
   } else {
     printf("SD card initialization failed!\r\n");
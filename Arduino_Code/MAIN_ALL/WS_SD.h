@@ -11,7 +11,7 @@
 extern uint16_t SDCard_Size;
 extern uint16_t Flash_Size;
 
-void SD_Init();
+void SD_Init(bool Format_If_Mount_Failed = true);     // false : a card that does not mount is left as it is
 void Flash_test();
 
 bool File_Search(const char* directory, const char* fileName);
@@ -0,0 +1,230 @@
+#include "WS_SD_Log.h"
+#include "WS_PCF85063.h"           // Time_Get_Epoch(), epoch_to_datetime()
+#include "WS_Relay.h"               // Relay_Get_PinState()
+#include "esp_system.h"            // esp_reset_reason()
+#include <atomic>
+
+static_assert(SD_Log_Buffer_Size % sizeof(SD_Log_Record) == 0, "SD_Log_Buffer_Size has to hold whole records");
+
+static uint8_t SD_Log_Buffer[2][SD_Log_Buffer_Size];
+static uint16_t SD_Log_Fill[2];
+static uint8_t SD_Log_Active = 0;                           // Half the producers write to
+static int8_t SD_Log_Pending = -1;                          // Half waiting for SDLogTask, -1 : none
+static portMUX_TYPE SD_Log_Lock = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t SD_Log_Task_Handle = NULL;
+static std::atomic<uint32_t> SD_Log_Lost(0);
+
+static SemaphoreHandle_t SD_Log_Card_Mutex = NULL;          // Mount, rotation and writes of SDLogTask against the export
+static bool SD_Log_Mounted = false;                         // Changed by SDLogTask with SD_Log_Card_Mutex held
+static bool SD_Log_Remount = true;                          // Mount at the start and after a failed write, not periodically
+static File SD_Log_File;
+static uint32_t SD_Log_Day = 0;                             // UTC day of SD_Log_File, 0 : time unknown
+
+bool SD_Log_Write(uint8_t Type, uint8_t Source, uint16_t Arg16, uint32_t Arg32)
+{
+  SD_Log_Record Record;
+  if(!Time_Get_Epoch(&Record.Epoch))
+    Record.Epoch = 0;
+  Record.Millis = millis();
+  Record.Type = Type;
+  Record.Source = Source;
+  Record.Arg16 = Arg16;
+  Record.Arg32 = Arg32;
+
+  bool Swapped = false, Stored = true;
+  portENTER_CRITICAL(&SD_Log_Lock);
+  if(SD_Log_Fill[SD_Log_Active] + sizeof(Record) > SD_Log_Buffer_Size){
+    if(SD_Log_Pending >= 0)
+      Stored = false;                                        // SDLogTask is still writing the other half
+    else{
+      SD_Log_Pending = SD_Log_Active;
+      SD_Log_Active ^= 1;
+      SD_Log_Fill[SD_Log_Active] = 0;
+      Swapped = true;
+    }
+  }
+  if(Stored){
+    memcpy(&SD_Log_Buffer[SD_Log_Active][SD_Log_Fill[SD_Log_Active]], &Record, sizeof(Record));
+    SD_Log_Fill[SD_Log_Active] += sizeof(Record);
+  }
+  portEXIT_CRITICAL(&SD_Log_Lock);
+  if(!Stored)
+    SD_Log_Lost.fetch_add(1, std::memory_order_relaxed);
+  if(Swapped && SD_Log_Task_Handle)
+    xTaskNotifyGive(SD_Log_Task_Handle);
+  return Stored;
+}
+
+uint32_t SD_Log_Dropped(void)
+{
+  return SD_Log_Lost.load(std::memory_order_relaxed);
+}
+
+static bool SD_Log_Card_Lock(uint32_t Wait_MS)              // Card access outside SDLogTask, false : busy or not mounted, no SD_Log_Card_Unlock() then
+{
+  if(!SD_Log_Card_Mutex || xSemaphoreTake(SD_Log_Card_Mutex, pdMS_TO_TICKS(Wait_MS)) != pdTRUE)
+    return false;
+  if(!SD_Log_Mounted || SD_Log_Remount){                    // Remount pending : the card may go away under the reader
+    xSemaphoreGive(SD_Log_Card_Mutex);
+    return false;
+  }
+  return true;
+}
+static void SD_Log_Card_Unlock(void)
+{
+  xSemaphoreGive(SD_Log_Card_Mutex);
+}
+
+const char *SD_Log_Type_Name(uint8_t Type)
+{
+  switch(Type)
+  {
+    case SD_Log_Boot:           return "boot";
+    case SD_Log_Relay:          return "relay";
+    case SD_Log_Relay_Failure:  return "relay_failure";
+    case SD_Log_Auth_Failure:   return "auth_failure";
+    default:                    return "unknown";
+  }
+}
+
+/********************************************************  Files  ********************************************************/
+static bool SD_Log_Open(uint32_t Day)                       // Next file of the day, or a boot file while the time is unknown
+{
+  char Name[SD_Log_Name_MAX];
+  datetime_t Date;
+  if(Day)
+    epoch_to_datetime(Day * 86400, &Date);
+  for (int i = 0; i < 100; i++) {
+    if(Day)
+      snprintf(Name, sizeof(Name), SD_Log_Directory "/%04d%02d%02d_%02d.bin", Date.year, Date.month, Date.day, i);
+    else
+      snprintf(Name, sizeof(Name), SD_Log_Directory "/boot_%02d.bin", i);
+    if(SD_MMC.exists(Name)){
+      File Old = SD_MMC.open(Name, FILE_READ);
+      bool Room = Old && Old.size() < SD_Log_File_MAX;
+      Old.close();
+      if(!Room || !Day)
+        continue;                                           // Boot files are never continued, the millis() restart with every boot
+    }
+    SD_Log_File = SD_MMC.open(Name, FILE_APPEND);
+    if(!SD_Log_File){
+      printf("SD_Log_Open(function): %s could not be opened!!!!\r\n", Name);
+      return false;
+    }
+    SD_Log_Day = Day;
+    printf("SD log : writing %s\r\n", Name);
+    return true;
+  }
+  printf("SD_Log_Open(function): No free file name left!!!!\r\n");
+  return false;
+}
+
+static void SD_Log_Flush(const uint8_t *Data, uint16_t Length)
+{
+  if(!SD_Log_Mounted){
+    SD_Log_Lost.fetch_add(Length / sizeof(SD_Log_Record), std::memory_order_relaxed);
+    return;
+  }
+  uint32_t Epoch = 0;
+  uint32_t Day = Time_Get_Epoch(&Epoch) ? Epoch / 86400 : 0;
+  if(SD_Log_File && (Day != SD_Log_Day || SD_Log_File.size() + Length > SD_Log_File_MAX))
+    SD_Log_File.close();                                    // Rotation : new day, size limit, or the time became known
+  if(!SD_Log_File && !SD_Log_Open(Day)){
+    SD_Log_Lost.fetch_add(Length / sizeof(SD_Log_Record), std::memory_order_relaxed);
+    return;
+  }
+  if(SD_Log_File.write(Data, Length) != Length){
+    printf("SD_Log_Flush(function): Write failed, the card is remounted!!!!\r\n");
+    SD_Log_File.close();
+    SD_Log_Mounted = false;
+    SD_Log_Remount = true;
+    SD_Log_Lost.fetch_add(Length / sizeof(SD_Log_Record), std::memory_order_relaxed);
+    return;
+  }
+  SD_Log_File.flush();                                      // FAT and directory entry, the size is right after a power cut
+}
+
+/********************************************************  Export  ********************************************************/
+// Every call holds the card for one directory or file chunk only. The caller sends it to the client
+// after the card is released, so SDLogTask never waits for the network.
+int SD_Log_List(uint16_t First, SD_Log_File_Info *Files, int Count)
+{
+  if(!SD_Log_Card_Lock(SD_Log_Export_Wait_MS))
+    return -1;
+  File Directory = SD_MMC.open(SD_Log_Directory);
+  int Found = 0;
+  uint16_t Index = 0;
+  for (File Entry = Directory ? Directory.openNextFile() : File(); Entry && Found < Count; Entry = Directory.openNextFile()) {
+    if(Entry.isDirectory() || Index++ < First)
+      continue;
+    snprintf(Files[Found].Name, sizeof(Files[Found].Name), "%s", Entry.name());
+    Files[Found].Size = Entry.size();
+    Found++;
+  }
+  Directory.close();
+  SD_Log_Card_Unlock();
+  return Found;
+}
+int SD_Log_Read(const char *Name, uint32_t Offset, uint8_t *Data, size_t Size, uint32_t *File_Size)
+{
+  char Path[sizeof(SD_Log_Directory) + SD_Log_Name_MAX];
+  snprintf(Path, sizeof(Path), SD_Log_Directory "/%s", Name);
+  if(!SD_Log_Card_Lock(SD_Log_Export_Wait_MS))
+    return -1;
+  int Length = -2;
+  File Log = SD_MMC.open(Path, FILE_READ);                  // Opened per chunk, SDLogTask may append to it in between
+  if(Log){
+    if(File_Size)
+      *File_Size = Log.size();
+    Length = Log.seek(Offset) ? Log.read(Data, Size) : 0;
+    Log.close();
+  }
+  SD_Log_Card_Unlock();
+  return Length;
+}
+
+/********************************************************  Task  ********************************************************/
+void SD_Log_Init(void)
+{
+  static bool Initialized = false;
+  if(Initialized)
+    return;
+  Initialized = true;
+  SD_Log_Card_Mutex = xSemaphoreCreateMutex();
+  SD_Log_Write(SD_Log_Boot, 0, (uint16_t)esp_reset_reason(), Relay_Get_PinState());
+  Task_Start(Task_SD_Log, SDLogTask, &SD_Log_Task_Handle);
+}
+
+void SDLogTask(void *parameter)
+{
+  while(1){
+    if(SD_Log_Remount){
+      xSemaphoreTake(SD_Log_Card_Mutex, portMAX_DELAY);
+      SD_Log_Remount = false;
+      SD_MMC.end();
+      SD_Init(false);                                       // The card may have been swapped after a failed write, never format the audit trail
+      SD_Log_Mounted = SD_MMC.cardType() != CARD_NONE && (SD_MMC.exists(SD_Log_Directory) || SD_MMC.mkdir(SD_Log_Directory));
+      xSemaphoreGive(SD_Log_Card_Mutex);
+      if(!SD_Log_Mounted)
+        printf("Note : No SD card, the audit log is not written !\r\n");
+    }
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(SD_Log_Flush_MS));
+    portENTER_CRITICAL(&SD_Log_Lock);
+    if(SD_Log_Pending < 0 && SD_Log_Fill[SD_Log_Active]){   // Timeout : the partly filled half goes too
+      SD_Log_Pending = SD_Log_Active;
+      SD_Log_Active ^= 1;
+      SD_Log_Fill[SD_Log_Active] = 0;
+    }
+    int8_t Pending = SD_Log_Pending;
+    portEXIT_CRITICAL(&SD_Log_Lock);
+    if(Pending < 0)
+      continue;
+    xSemaphoreTake(SD_Log_Card_Mutex, portMAX_DELAY);       // Rotation and write, at most one export chunk is in the way
+    SD_Log_Flush(SD_Log_Buffer[Pending], SD_Log_Fill[Pending]);   // The producers do not touch the pending half
+    xSemaphoreGive(SD_Log_Card_Mutex);
+    portENTER_CRITICAL(&SD_Log_Lock);
+    SD_Log_Pending = -1;
+    portEXIT_CRITICAL(&SD_Log_Lock);
+  }
+  vTaskDelete(NULL);
+}
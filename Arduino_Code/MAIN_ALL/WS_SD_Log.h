@@ -0,0 +1,55 @@
+#pragma once
+
+#include <Arduino.h>
+#include <stdint.h>
+#include "WS_SD.h"
+#include "WS_Tasks.h"
+
+/*************************************************************  SD audit log  *************************************************************/
+// Relay changes, relay failures, rejected authenticated commands and the reset reason go to the SD card as 16 byte
+// binary records. SD_Log_Write() only copies the record into one half of a RAM double buffer, SDLogTask writes a
+// full half with a single File.write() and the producers go on with the other one. A partly filled half is written
+// after SD_Log_Flush_MS, that is the most that is lost on a power cut. The card is mounted by SDLogTask at boot and
+// again after a failed write, without a card the records are counted by SD_Log_Dropped().
+// Files : /log/YYYYMMDD_NN.bin (UTC day, NN : next file of the day once SD_Log_File_MAX is reached), /log/boot_NN.bin
+// while the time is unknown. GET /api/log lists them, /api/log?file=NAME streams one (&format=csv decodes it).
+#define SD_Log_Buffer_Size    8192          // One half of the double buffer, the unit of every write (unit: bytes)
+#define SD_Log_Flush_MS       30000         // A partly filled half is written after this long (unit: ms)
+#define SD_Log_File_MAX       (1024 * 1024) // A new file is started beyond this size (unit: bytes)
+#define SD_Log_Directory      "/log"
+#define SD_Log_Name_MAX       32
+#define SD_Log_Export_Wait_MS 1000          // /api/log waits this long for SDLogTask to finish a write or a remount (unit: ms)
+#define SD_Log_Export_Chunk   512           // /api/log reads this much per card access, sent after the card is released (unit: bytes)
+#define SD_Log_Export_Files   8             // /api/log lists this many files per card access
+
+typedef enum {
+  SD_Log_Boot = 1,            // Arg16 : esp_reset_reason(), Arg32 : relay state after Relay_Init()
+  SD_Log_Relay = 2,           // Source : command sources (bit0 = DIN_Mode), Arg16 : old state, Arg32 : new state
+  SD_Log_Relay_Failure = 3,   // As SD_Log_Relay, Arg32 : the state that could not be written
+  SD_Log_Auth_Failure = 4,    // Source : Mode_Flag, Arg16 : Auth_Result, Arg32 : epoch of the command
+} SD_Log_Type;
+
+typedef struct {
+  uint32_t Epoch;             // UTC, 0 : time unknown
+  uint32_t Millis;            // millis() of the event
+  uint8_t Type;               // SD_Log_Type
+  uint8_t Source;
+  uint16_t Arg16;
+  uint32_t Arg32;
+} SD_Log_Record;
+static_assert(sizeof(SD_Log_Record) == 16, "SD_Log_Record is the on-card format");
+static_assert(SD_Log_Export_Chunk % sizeof(SD_Log_Record) == 0, "SD_Log_Export_Chunk has to hold whole records");
+
+typedef struct {
+  char Name[SD_Log_Name_MAX];
+  uint32_t Size;
+} SD_Log_File_Info;
+
+void SD_Log_Init(void);                                                           // Starts SDLogTask, which mounts the card
+bool SD_Log_Write(uint8_t Type, uint8_t Source, uint16_t Arg16, uint32_t Arg32);   // Never blocks, false : both halves full or no log
+uint32_t SD_Log_Dropped(void);                                                    // Records lost because the card was missing or too slow
+// Export, the card is held for one call only. -1 : busy or not mounted, -2 : no such file
+int SD_Log_List(uint16_t First, SD_Log_File_Info *Files, int Count);                 // Files First ~ First + Count - 1 of SD_Log_Directory, returns how many
+int SD_Log_Read(const char *Name, uint32_t Offset, uint8_t *Data, size_t Size, uint32_t *File_Size);   // Name : file of SD_Log_Directory, returns the bytes read
+const char *SD_Log_Type_Name(uint8_t Type);
+void SDLogTask(void *parameter);
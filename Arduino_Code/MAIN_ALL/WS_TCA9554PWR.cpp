@@ -1,25 +1,22 @@
 #include "WS_TCA9554PWR.h"
 
+/*****************************************************  Output shadow register   ****************************************************/
+static uint8_t EXIO_Output_Shadow = 0x00;                 // Last value successfully written to TCA9554_OUTPUT_REG
+static bool EXIO_Shadow_Valid = false;                    // false : the next access reads the output register back from the chip
+static uint32_t EXIO_Shadow_Sync_Time = 0;                // millis() of the last read back
+
 /*****************************************************  Operation register REG   ****************************************************/   
 uint8_t Read_REG(uint8_t REG)                             // Read the value of the TCA9554PWR register REG
 {
-  Wire.beginTransmission(TCA9554_ADDRESS);                
-  Wire.write(REG);                                        
-  uint8_t result = Wire.endTransmission();               
-  if (result != 0) {                                     
+  uint8_t bitsStatus = 0;
+  if (I2C_Read(TCA9554_ADDRESS, REG, &bitsStatus, 1) != ESP_OK) {
     printf("Data Transfer Failure !!!\r\n");
   }
-  Wire.requestFrom(TCA9554_ADDRESS, 1);                   
-  uint8_t bitsStatus = Wire.read();                        
   return bitsStatus;                                     
 }
 uint8_t Write_REG(uint8_t REG,uint8_t Data)              // Write Data to the REG register of the TCA9554PWR
 {
-  Wire.beginTransmission(TCA9554_ADDRESS);                
-  Wire.write(REG);                                        
-  Wire.write(Data);                                       
-  uint8_t result = Wire.endTransmission();                  
-  if (result != 0) {    
+  if (I2C_Write(TCA9554_ADDRESS, REG, &Data, 1) != ESP_OK) {
     printf("Data write failure!!!\r\n");
     return -1;
   }
@@ -28,9 +25,14 @@ uint8_t Write_REG(uint8_t REG,uint8_t Data)              // Write Data to the RE
 /********************************************************** Set EXIO mode **********************************************************/       
 void Mode_EXIO(uint8_t Pin,uint8_t State)                 // Set the mode of the TCA9554PWR Pin. The default is Output mode (output mode or input mode). State: 0= Output mode 1= input mode   
 {
+  if (!I2C_Lock()) {                                      // Read-modify-write of the configuration register
+    printf("I/O Configuration Failure !!!\r\n");
+    return;
+  }
   uint8_t bitsStatus = Read_REG(TCA9554_CONFIG_REG);      
   uint8_t Data = (0x01 << (Pin-1)) | bitsStatus;   
   uint8_t result = Write_REG(TCA9554_CONFIG_REG,Data); 
+  I2C_Unlock();
   if (result != 0) { 
     printf("I/O Configuration Failure !!!\r\n");
   }
@@ -55,22 +57,44 @@ uint8_t Read_EXIOS(uint8_t REG = TCA9554_INPUT_REG)       // Read the level of a
   return inputBits;     
 }
 
+/********************************************************** Output shadow register **********************************************************/
+bool TCA9554PWR_Resync(void)                              // Read the output register back from the chip into the shadow register
+{
+  uint8_t Value;
+  if (I2C_Read(TCA9554_ADDRESS, TCA9554_OUTPUT_REG, &Value, 1) != ESP_OK) {
+    printf("Output register read back failure !!!\r\n");
+    EXIO_Shadow_Valid = false;
+    return 0;
+  }
+  EXIO_Output_Shadow = Value;
+  EXIO_Shadow_Valid = true;
+  EXIO_Shadow_Sync_Time = millis();
+  return 1;
+}
+uint8_t Read_EXIOS_Shadow(void)                           // Output state as last written, read back only after a write error or every EXIO_Shadow_Resync_MS
+{
+  if (!EXIO_Shadow_Valid || (EXIO_Shadow_Resync_MS && millis() - EXIO_Shadow_Sync_Time >= EXIO_Shadow_Resync_MS))
+    TCA9554PWR_Resync();
+  return EXIO_Output_Shadow;
+}
+
 /********************************************************** Set the EXIO output status **********************************************************/  
 bool Set_EXIO(uint8_t Pin,uint8_t State)                  // Sets the level state of the Pin without affecting the other pins
 {
   uint8_t Data;
   if(State < 2 && Pin < 9 && Pin > 0){  
-    uint8_t bitsStatus = Read_EXIOS(TCA9554_OUTPUT_REG);
-    if(State == 1)                                     
-      Data = (0x01 << (Pin-1)) | bitsStatus; 
-    else if(State == 0)                  
-      Data = (~(0x01 << (Pin-1))) & bitsStatus;      
-    uint8_t result = Write_REG(TCA9554_OUTPUT_REG,Data);  
-    if (result != 0) {                         
+    if (!I2C_Lock()) {                                    // The shadow read back and the write stay one step
       printf("Failed to set GPIO!!!\r\n");
       return 0;
     }
-    return 1;
+    uint8_t bitsStatus = Read_EXIOS_Shadow();
+    if(State == 1)                                     
+      Data = (0x01 << (Pin-1)) | bitsStatus; 
+    else
+      Data = (~(0x01 << (Pin-1))) & bitsStatus;      
+    bool result = Set_EXIOS(Data);
+    I2C_Unlock();
+    return result;
   }
   else                                           
   {
@@ -83,15 +107,30 @@ bool Set_EXIOS(uint8_t PinState)                          // Set 7 pins to the P
   uint8_t result = Write_REG(TCA9554_OUTPUT_REG,PinState); 
   if (result != 0) {                  
     printf("Failed to set GPIO!!!\r\n");
+    EXIO_Shadow_Valid = false;                            // The chip may or may not have latched the byte, resync before the next change
     return 0;
   }
+  EXIO_Output_Shadow = PinState;
+  if (!EXIO_Shadow_Valid) {
+    EXIO_Shadow_Valid = true;
+    EXIO_Shadow_Sync_Time = millis();
+  }
   return 1;
 }
 /********************************************************** Flip EXIO state **********************************************************/  
 bool Set_Toggle(uint8_t Pin)                              // Flip the level of the TCA9554PWR Pin
 {
-    uint8_t bitsStatus = Read_EXIO(Pin);    
+    if (Pin > 8 || Pin < 1) {
+      printf("Parameter error, please enter the correct parameter!\r\n");
+      return 0;
+    }
+    if (!I2C_Lock()) {                                    // Recursive : Set_EXIO() takes it again, the read and the write stay one step
+      printf("Failed to Toggle GPIO!!!\r\n");
+      return 0;
+    }
+    uint8_t bitsStatus = (Read_EXIOS_Shadow() >> (Pin-1)) & 0x01;
     uint8_t result = Set_EXIO(Pin,(bool)!bitsStatus); 
+    I2C_Unlock();
     if (!result) {                         
       printf("Failed to Toggle GPIO!!!\r\n");
       return 0;
@@ -104,4 +143,14 @@ void TCA9554PWR_Init(uint8_t PinMode, uint8_t PinState)                  // Set
   Set_EXIOS(PinState);
   Mode_EXIOS(PinMode);    
 }
-
+bool TCA9554PWR_Adopt(uint8_t PinMode)                   // Keeps the outputs if the chip is still configured with PinMode, see WS_TCA9554PWR.h
+{
+  uint8_t Config;
+  if (I2C_Read(TCA9554_ADDRESS, TCA9554_CONFIG_REG, &Config, 1) != ESP_OK) {
+    printf("Configuration register read back failure !!!\r\n");
+    return 0;
+  }
+  if (Config != PinMode)                             // Power-on default 0xFF (all inputs) : the chip lost its supply
+    return 0;
+  return TCA9554PWR_Resync();
+}
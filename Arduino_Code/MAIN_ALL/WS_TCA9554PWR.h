@@ -23,6 +23,8 @@
 #define EXIO_PIN7   7
 #define EXIO_PIN8   8
 
+#define EXIO_Shadow_Resync_MS   60000                     // Period for reading the output register back into the shadow register (unit: ms, 0: only after a write error)
+
 /*****************************************************  Operation register REG   ****************************************************/   
 uint8_t Read_REG(uint8_t REG);                                                      // Read the value of the TCA9554PWR register REG
 uint8_t Write_REG(uint8_t REG,uint8_t Data);                                        // Write Data to the REG register of the TCA9554PWR
@@ -32,10 +34,14 @@ void Mode_EXIOS(uint8_t PinState);
 /********************************************************** Read EXIO status **********************************************************/       
 uint8_t Read_EXIO(uint8_t Pin);                                                     // Read the level of the TCA9554PWR Pin
 uint8_t Read_EXIOS(uint8_t REG);                                                    // Read the level of all pins of TCA9554PWR, the default read input level state, want to get the current IO output state, pass the parameter TCA9554_OUTPUT_REG, such as Read_EXIOS(TCA9554_OUTPUT_REG);
+/********************************************************** Output shadow register **********************************************************/  
+bool TCA9554PWR_Resync(void);                                                       // Read the output register back from the chip into the shadow register
+uint8_t Read_EXIOS_Shadow(void);                                                    // Output state as last written, without an I2C transaction unless a resync is due
 /********************************************************** Set the EXIO output status **********************************************************/  
-bool Set_EXIO(uint8_t Pin,uint8_t State);                                           // Sets the level state of the Pin without affecting the other pins
+bool Set_EXIO(uint8_t Pin,uint8_t State);                                           // Sets the level state of the Pin without affecting the other pins (one write, the other pins come from the shadow register)
 bool Set_EXIOS(uint8_t PinState);                                                   // Set 7 pins to the PinState state such as :PinState=0x23, 0010 0011 state (the highest bit is not used)
 /********************************************************** Flip EXIO state **********************************************************/  
 bool Set_Toggle(uint8_t Pin);                                                       // Flip the level of the TCA9554PWR Pin
 /********************************************************* TCA9554PWR Initializes the device ***********************************************************/  
 void TCA9554PWR_Init(uint8_t PinMode = 0x00, uint8_t PinState = 0x00);              // Set the seven pins to PinState state, for example :PinState=0x23, 0010 0011 State (the highest bit is not used) (Output mode or input mode) 0= Output mode 1= Input mode. The default value is output mode
+bool TCA9554PWR_Adopt(uint8_t PinMode = 0x00);                                      // true : the configuration register still holds PinMode (ESP32 reset, the expander kept its supply), the output register is read into the shadow register and left as it is
@@ -0,0 +1,79 @@
+#include "WS_Tasks.h"
+
+static const Task_Config Task_Table[Task_Number] = {
+  //  Name              Stack   Priority  Core
+  {"RelayTask",         4096,   5,        Task_Core_Control},     // I2C relay writes, every command source ends here
+  {"DINTask",           4096,   5,        Task_Core_Control},     // Debounce and DIN mirroring
+  {"RTCTask",           4096,   4,        Task_Core_Control},     // Timed relay events
+  {"RS485Task",         4096,   4,        Task_Core_Control},
+  {"CANTask",           4096,   4,        Task_Core_Control},
+  {"CANTxTask",         4096,   3,        Task_Core_Control},
+  {"RelayStoreTask",    4096,   1,        Task_Core_Control},     // Coalesced NVS writes of the relay state
+  {"MQTTTask",          4096,   3,        Task_Core_Radio},
+  {"WifiStaTask",       4096,   3,        Task_Core_Radio},
+  {"WebServerTask",     4096,   3,        Task_Core_Radio},
+  {"BLECmdTask",        4096,   3,        Task_Core_Radio},
+  {"BLETask",           4096,   2,        Task_Core_Radio},
+  {"IndicatorTask",     3072,   2,        Task_Core_Radio},       // Buzzer and RGB patterns, sleeps while idle
+  {"LogTask",           4096,   1,        Task_Core_Radio},
+  {"ConsoleTask",       4096,   1,        Task_Core_Radio},       // Serial commands, see WS_Console.h
+  {"SDLogTask",         4096,   1,        Task_Core_Radio},       // Audit log double buffer to the SD card
+  {"BootNetTask",       4096,   2,        Task_Core_Radio},       // ETH and web server bring-up, ends afterwards
+  {"BootBLETask",       6144,   2,        Task_Core_Radio},       // BLEDevice::init() and the GATT server, ends afterwards
+};
+static TaskHandle_t Task_Handles[Task_Number];
+
+bool Task_Start(Task_ID ID, TaskFunction_t Function, TaskHandle_t *Handle)
+{
+  if (ID >= Task_Number)
+    return false;
+  const Task_Config *Config = &Task_Table[ID];
+  TaskHandle_t *Target = Handle ? Handle : &Task_Handles[ID];   // The caller's handle is written before the new task can run
+  if (xTaskCreatePinnedToCore(Function, Config->Name, Config->Stack, NULL, Config->Priority, Target, Config->Core) != pdPASS) {
+    printf("Task_Start(function): %s could not be created!!!!\r\n", Config->Name);
+    *Target = NULL;
+    return false;
+  }
+  Task_Handles[ID] = *Target;
+  return true;
+}
+
+TaskHandle_t Task_Handle(Task_ID ID)
+{
+  return ID < Task_Number ? Task_Handles[ID] : NULL;
+}
+
+void Task_Finish(Task_ID ID)
+{
+  if (ID < Task_Number && Task_Handles[ID] == xTaskGetCurrentTaskHandle())
+    Task_Handles[ID] = NULL;                                  // Task_Print_Stats() must not look at a deleted task
+  vTaskDelete(NULL);
+}
+
+void Task_Print_Stats(void)
+{
+#if configUSE_TRACE_FACILITY && configGENERATE_RUN_TIME_STATS
+  static TaskStatus_t Status[Task_Status_MAX];
+  uint32_t Total = 0;
+  UBaseType_t Count = uxTaskGetSystemState(Status, Task_Status_MAX, &Total);
+  Total /= 100;                                               // Percent
+#endif
+  printf("Task            Core  Prio  Stack  Free   CPU\r\n");
+  for (int i = 0; i < Task_Number; i++) {
+    const Task_Config *Config = &Task_Table[i];
+    if (!Task_Handles[i])
+      continue;
+    unsigned long Percent = 0;
+#if configUSE_TRACE_FACILITY && configGENERATE_RUN_TIME_STATS
+    for (UBaseType_t j = 0; j < Count; j++) {
+      if (Status[j].xHandle == Task_Handles[i] && Total)
+        Percent = Status[j].ulRunTimeCounter / Total;
+    }
+#endif
+    printf("%-15s %-5d %-5u %-6lu %-6u %lu%%\r\n", Config->Name, (int)Config->Core, (unsigned)Config->Priority, (unsigned long)Config->Stack,
+           (unsigned)uxTaskGetStackHighWaterMark(Task_Handles[i]), Percent);   // Free : least stack ever left (unit: bytes)
+  }
+#if !(configUSE_TRACE_FACILITY && configGENERATE_RUN_TIME_STATS)
+  printf("Note : CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS is off, CPU share not available !\r\n");
+#endif
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <Arduino.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+/*************************************************************  Task registry  *************************************************************/
+// Every task of the firmware is started through Task_Start(), its core, priority and stack come from Task_Table[] in WS_Tasks.cpp.
+// Core 0 (PRO_CPU) runs the WiFi / BLE / lwIP stacks, the latency-critical relay and input path lives on core 1 (APP_CPU)
+// next to loop(), so DIN-to-relay timing no longer moves when the radio is busy.
+#define Task_Core_Radio       0       // Shared with the WiFi / BLE controller and the TCP/IP stack
+#define Task_Core_Control     1       // Relay, DIN, RTC scheduler and the wired buses
+#define Task_Status_MAX       32      // Tasks Task_Print_Stats() can look at, registered or not (IDLE, timers, stacks...)
+
+typedef enum {
+  Task_Relay = 0,
+  Task_DIN,
+  Task_RTC,
+  Task_RS485,
+  Task_CAN,
+  Task_CAN_TX,
+  Task_Relay_Store,
+  Task_MQTT,
+  Task_WiFi_STA,
+  Task_Web_Server,
+  Task_BLE_Cmd,
+  Task_BLE_State,
+  Task_Indicator,
+  Task_Log,
+  Task_Console,
+  Task_SD_Log,
+  Task_Boot_Network,                  // Boot tasks end with Task_Finish()
+  Task_Boot_BLE,
+  Task_Number,
+} Task_ID;
+
+typedef struct {
+  const char *Name;
+  uint32_t Stack;                     // unit: bytes
+  UBaseType_t Priority;
+  BaseType_t Core;
+} Task_Config;
+
+bool Task_Start(Task_ID ID, TaskFunction_t Function, TaskHandle_t *Handle = NULL);   // false : the task could not be created
+TaskHandle_t Task_Handle(Task_ID ID);                                                  // NULL : not started or finished
+void Task_Finish(Task_ID ID);                                                          // Last call of a task that ends, deletes the calling task
+void Task_Print_Stats(void);          // Core, priority, stack high-water mark and CPU share of every registered task
@@ -0,0 +1,115 @@
+#include "WS_Trace.h"
+#include "WS_Relay.h"
+
+static_assert(Trace_Sources >= Relay_Source_Number, "Trace_Sources has to cover every relay command source");
+
+typedef struct {
+  uint32_t Count;
+  uint32_t Max;
+  uint32_t Bucket[Trace_Buckets];
+} Trace_Histogram;
+
+static Trace_Histogram Trace_Wait[Trace_Sources];
+static Trace_Histogram Trace_Total[Trace_Sources];
+static Trace_Histogram Trace_I2C;
+static portMUX_TYPE Trace_Lock = portMUX_INITIALIZER_UNLOCKED;
+
+// 0 1 2 3 | 4 6 | 8 12 | 16 24 | ... : two buckets per power of two
+static uint8_t Trace_Bucket_Index(uint32_t Time_US)
+{
+  if (Time_US < 4)
+    return Time_US;
+  uint8_t MSB = 31 - __builtin_clz(Time_US);
+  uint32_t Index = MSB * 2 + ((Time_US >> (MSB - 1)) & 0x01);
+  return Index < Trace_Buckets ? Index : Trace_Buckets - 1;
+}
+static uint32_t Trace_Bucket_Upper(uint8_t Index)
+{
+  if (Index < 4)
+    return Index;
+  uint8_t MSB = Index / 2;
+  uint32_t Lower = (1UL << MSB) | ((uint32_t)(Index & 0x01) << (MSB - 1));
+  return Lower + (1UL << (MSB - 1)) - 1;
+}
+
+static void Trace_Add(Trace_Histogram *Histogram, uint32_t Time_US)
+{
+  Histogram->Count++;
+  Histogram->Bucket[Trace_Bucket_Index(Time_US)]++;
+  if (Time_US > Histogram->Max)
+    Histogram->Max = Time_US;
+}
+static uint32_t Trace_Percentile(const Trace_Histogram *Histogram, uint32_t Percent)
+{
+  uint32_t Target = (Histogram->Count * Percent + 99) / 100;
+  uint32_t Sum = 0;
+  for (uint8_t i = 0; i < Trace_Buckets; i++) {
+    Sum += Histogram->Bucket[i];
+    if (Sum >= Target && Sum) {
+      uint32_t Upper = Trace_Bucket_Upper(i);
+      return Upper < Histogram->Max ? Upper : Histogram->Max;
+    }
+  }
+  return Histogram->Max;
+}
+static void Trace_Summarize(const Trace_Histogram *Histogram, Trace_Summary *Summary)
+{
+  Trace_Histogram Copy;                                     // Copied under the lock, summarized outside it
+  portENTER_CRITICAL(&Trace_Lock);
+  Copy = *Histogram;
+  portEXIT_CRITICAL(&Trace_Lock);
+  Summary->Count = Copy.Count;
+  Summary->P50 = Trace_Percentile(&Copy, 50);
+  Summary->P99 = Trace_Percentile(&Copy, 99);
+  Summary->Max = Copy.Max;
+}
+
+void Trace_Record(uint8_t Mode_Flag, uint32_t Ingress, uint32_t Dequeue, uint32_t Done)
+{
+  if (!Mode_Flag || Mode_Flag > Trace_Sources)
+    return;
+  portENTER_CRITICAL(&Trace_Lock);
+  Trace_Add(&Trace_Wait[Mode_Flag - 1], Dequeue - Ingress);
+  Trace_Add(&Trace_Total[Mode_Flag - 1], Done - Ingress);
+  portEXIT_CRITICAL(&Trace_Lock);
+}
+void Trace_Record_I2C(uint32_t Start, uint32_t Done)
+{
+  portENTER_CRITICAL(&Trace_Lock);
+  Trace_Add(&Trace_I2C, Done - Start);
+  portEXIT_CRITICAL(&Trace_Lock);
+}
+
+void Trace_Get_Report(Trace_Report *Report)
+{
+  for (uint8_t i = 0; i < Trace_Sources; i++) {
+    Trace_Summarize(&Trace_Wait[i], &Report->Wait[i]);
+    Trace_Summarize(&Trace_Total[i], &Report->Total[i]);
+  }
+  Trace_Summarize(&Trace_I2C, &Report->I2C);
+}
+void Trace_Reset(void)
+{
+  portENTER_CRITICAL(&Trace_Lock);
+  memset(Trace_Wait, 0, sizeof(Trace_Wait));
+  memset(Trace_Total, 0, sizeof(Trace_Total));
+  memset(&Trace_I2C, 0, sizeof(Trace_I2C));
+  portEXIT_CRITICAL(&Trace_Lock);
+}
+
+int Trace_Format(const Trace_Report *Report, int Item, char *Text, size_t Size)
+{
+  if (Item < 0 || Item > Relay_Source_Number)
+    return -1;
+  if (Item == Relay_Source_Number) {
+    const Trace_Summary *S = &Report->I2C;
+    return snprintf(Text, Size, ",{\"src\":\"I2C\",\"n\":%lu,\"time\":[%lu,%lu,%lu]}]",
+                    (unsigned long)S->Count, (unsigned long)S->P50, (unsigned long)S->P99, (unsigned long)S->Max);
+  }
+  const Trace_Summary *W = &Report->Wait[Item];
+  const Trace_Summary *T = &Report->Total[Item];
+  return snprintf(Text, Size, "%c{\"src\":\"%s\",\"n\":%lu,\"wait\":[%lu,%lu,%lu],\"total\":[%lu,%lu,%lu]}", Item ? ',' : '[',
+                  Relay_Source_Name(Item + 1), (unsigned long)T->Count,
+                  (unsigned long)W->P50, (unsigned long)W->P99, (unsigned long)W->Max,
+                  (unsigned long)T->P50, (unsigned long)T->P99, (unsigned long)T->Max);
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <Arduino.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_timer.h"
+
+/*************************************************************  Latency trace  *************************************************************/
+// Every relay command is stamped when it is queued (ingress), when RelayTask takes it (dequeue) and around the
+// TCA9554 write of its batch (I2C start / done). RelayTask folds the stamps into per-source histograms :
+//   Wait  : ingress -> dequeue        Total : ingress -> I2C done        I2C : one write, all sources
+// The buckets are half an octave wide, p50 / p99 are the upper edge of their bucket (at most ~40% above the real value).
+#define Trace_Sources             8       // Command sources with a histogram, at least Relay_Source_Number
+#define Trace_Buckets             48      // 0 ~ 2^24 us, longer times land in the last bucket
+#define Trace_Item_Size           128     // Longest text of one Trace_Format() item
+
+typedef struct {
+  uint32_t Count;
+  uint32_t P50;                           // unit: us
+  uint32_t P99;
+  uint32_t Max;
+} Trace_Summary;
+
+typedef struct {
+  Trace_Summary Wait[Trace_Sources];      // Index : Mode_Flag - 1
+  Trace_Summary Total[Trace_Sources];
+  Trace_Summary I2C;
+} Trace_Report;
+
+static inline uint32_t Trace_Now(void)    // Low 32 bits of esp_timer, differences stay valid across the wrap (~71 min)
+{
+  return (uint32_t)esp_timer_get_time();
+}
+void Trace_Record(uint8_t Mode_Flag, uint32_t Ingress, uint32_t Dequeue, uint32_t Done);   // One command, called by RelayTask
+void Trace_Record_I2C(uint32_t Start, uint32_t Done);                                     // One relay write, called by RelayTask
+void Trace_Get_Report(Trace_Report *Report);                                              // Consistent snapshot, any task
+void Trace_Reset(void);
+// JSON array, one item per call : Item 0 ~ Relay_Source_Number - 1 (sources), Relay_Source_Number (I2C), returns the length or -1 once Item is past the end.
+// [{"src":"DIN","n":3,"wait":[p50,p99,max],"total":[p50,p99,max]},...,{"src":"I2C","n":3,"time":[p50,p99,max]}]
+int Trace_Format(const Trace_Report *Report, int Item, char *Text, size_t Size);
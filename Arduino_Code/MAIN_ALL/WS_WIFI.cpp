@@ -1,570 +1,335 @@
 #include "WS_WIFI.h"
+#include "WS_WebPages.h"
+#include "WS_JSON.h"
+#include <atomic>
 
 // The name and password of the WiFi access point
 const char *ssid = STASSID;                
 const char *password = STAPSK;               
 
-char ipStr[16];
 WebServer server(80);         
 bool WIFI_Connection = 0;                      
+POOL_DEFINE(Pool_HTTP, Web_Text_Size, Web_Text_Count);
+
+// The pages live in web/ and are embedded by web/embed_pages.py. They are sent straight from flash,
+// and a browser that already has the current version gets a 304 without a body.
+static void Web_Send_Page(const uint8_t *Page, size_t Length, const char *ETag)
+{
+  server.sendHeader("Cache-Control", "no-cache");             // Always revalidate, the ETag makes that cheap
+  server.sendHeader("ETag", ETag);
+  if (server.header("If-None-Match") == ETag) {
+    server.send(304);
+    return;
+  }
+  server.sendHeader("Content-Encoding", "gzip");
+  server.send_P(200, "text/html", (PGM_P)Page, Length);
+}
 
 void handleRoot() {
-  String myhtmlPage =
-    String("") +
-    "<html>"+
-    "<head>"+
-    "    <meta charset=\"utf-8\">"+
-    "    <title>ESP32-S3-POE-ETH-8DI-8RO</title>"+
-    "    <style>" +
-    "        body {" +
-    "            font-family: Arial, sans-serif;" +
-    "            background-color: #f0f0f0;" +
-    "            margin: 0;" +
-    "            padding: 0;" +
-    "        }" +
-    "        .header {" +
-    "            text-align: center;" +
-    "            padding: 20px 0;" +
-    "            background-color: #333;" +
-    "            color: #fff;" +
-    "            margin-bottom: 20px;" +
-    "        }" +
-    "        .container {" +
-    "            max-width: 600px;" +
-    "            margin: 0 auto;" +
-    "            padding: 20px;" +
-    "            background-color: #fff;" +
-    "            border-radius: 5px;" +
-    "            box-shadow: 0 0 5px rgba(0, 0, 0, 0.3);" +
-    "        }" +
-    "        .input-container {//" +
-    "            display: flex;" +
-    "            align-items: center;" +
-    "            margin-bottom: 10px;" +
-    "        }" +
-    "        .input-container label {" +
-    "            width: 80px;" + 
-    "            margin-right: 10px;" +
-    "        }" +
-    "        .input-container input[type=\"text\"] {" +
-    "            flex: 1;" +
-    "            padding: 5px;" +
-    "            border: 1px solid #ccc;" +
-    "            border-radius: 3px;" +
-    "            margin-right: 10px; "+ 
-    "        }" +
-    "        .input-container button {" +
-    "            padding: 5px 10px;" +
-    "            background-color: #333;" +
-    "            color: #fff;" +
-    "            font-size: 14px;" +
-    "            font-weight: bold;" +
-    "            border: none;" +
-    "            border-radius: 3px;" +
-    "            text-transform: uppercase;" +
-    "            cursor: pointer;" +
-    "        }" +
-    "        .button-container {" +
-    "            margin-top: 20px;" +
-    "            text-align: center;" +
-    "        }" +
-    "        .button-container button {" +
-    "            margin: 0 5px;" +
-    "            padding: 10px 15px;" +
-    "            background-color: #333;" +
-    "            color: #fff;" +
-    "            font-size: 14px;" +
-    "            font-weight: bold;" +
-    "            border: none;" +
-    "            border-radius: 3px;" +
-    "            text-transform: uppercase;" +
-    "            cursor: pointer;" +
-    "        }" +
-    "        .button-container button:hover {" +
-    "            background-color: #555;" +
-    "        }" +
-    "        nav {" +
-    "            margin: 15px 0;" +
-    "            text-align: center;" +
-    "        }" +
-    "        nav a {" +
-    "            padding: 10px 50px;" +
-    "            background-color: #333;" +
-    "            color: white;" +
-    "            text-decoration: none;" +
-    "            font-weight: bold;" +
-    "            border-radius: 5px;" +
-    "        }" +
-    "        nav a.relayControlActive {" + 
-    "            background-color: #fff;" +   
-    "            color: #333;" +
-    "            box-shadow: 0 4px 6px rgba(0, 0, 0, 0.3), 0 1px 3px rgba(0, 0, 0, 0.1);" +
-    "            transform: translateY(-4px);" +
-    "            transition: all 0.2s ease-in-out;" +
-    "        }" + 
-    "        nav a.rtcEventActive {" + 
-    "            background-color: #555;" +
-    "        }" + 
-    "    </style>" +
-    "</head>"+
-    "<body>"+
-    "    <script defer=\"defer\">"+
-    "        function ledSwitch(ledNumber) {"+
-    "            var xhttp = new XMLHttpRequest();" +
-    "            xhttp.onreadystatechange = function() {" +
-    "                if (this.readyState == 4 && this.status == 200) {" +
-    "                    console.log('LED ' + ledNumber + ' state changed');" +
-    "                }" +
-    "            };" +
-    "            if (ledNumber < 9 && ledNumber > 0) {" +
-    "             xhttp.open('GET', '/Switch' + ledNumber, true);" +
-    "            }" +
-    "            else if(ledNumber == 9){" +
-    "            xhttp.open('GET', '/AllOn', true);" +
-    "            }" +
-    "            else if(ledNumber == 0){" +
-    "            xhttp.open('GET', '/AllOff', true);" +
-    "            }" +
-    "            xhttp.send();" +
-    "        }" +
-    "        function updateData() {"
-    "            var xhr = new XMLHttpRequest();"
-    "            xhr.open('GET', '/getData', true);"
-    "            xhr.onreadystatechange = function() {"
-    "              if (xhr.readyState === 4 && xhr.status === 200) {"
-    "                var dataArray = JSON.parse(xhr.responseText);"
-    "                document.getElementById('ch1').value = dataArray[0];"
-    "                document.getElementById('ch2').value = dataArray[1];"
-    "                document.getElementById('ch3').value = dataArray[2];"
-    "                document.getElementById('ch4').value = dataArray[3];"
-    "                document.getElementById('ch5').value = dataArray[4];"
-    "                document.getElementById('ch6').value = dataArray[5];"
-    "                document.getElementById('ch7').value = dataArray[6];"
-    "                document.getElementById('ch8').value = dataArray[7];"
-    // "                // Remove the button's disabled attribute to make it clickable"+
-    "                document.getElementById('btn1').removeAttribute(\'disabled\');"+
-    "                document.getElementById('btn2').removeAttribute(\'disabled\');"+
-    "                document.getElementById('btn3').removeAttribute(\'disabled\');"+
-    "                document.getElementById('btn4').removeAttribute(\'disabled\');"+
-    "                document.getElementById('btn5').removeAttribute(\'disabled\');"+
-    "                document.getElementById('btn6').removeAttribute(\'disabled\');"+
-    "                document.getElementById('btn7').removeAttribute(\'disabled\');"+
-    "                document.getElementById('btn8').removeAttribute(\'disabled\');"+
-    "                document.getElementById('btn9').removeAttribute(\'disabled\');"+
-    "                document.getElementById('btn0').removeAttribute(\'disabled\');"+
-    "              }"+
-    "            };"+
-    "            xhr.send();"+
-    "        }"+
-    "        function displayErrorTextBox(show) {"+
-    "          var errorTextbox = document.getElementById('errorTextbox');"+
-    "          errorTextbox.style.display = show ? 'block' : 'none';"+
-    "        }"+
-    "        function resetErrorTextBox() {"+
-    "          document.getElementById(\'errorTextbox\').value = \'\';"+
-    "        }"+
-    "        var refreshInterval = 200;"+                                     
-    "        setInterval(updateData, refreshInterval);"+       
-    "    </script>" +
-    "    <div class=\"header\">"+
-    "        <h1>ESP32-S3-POE-ETH-8DI-8RO</h1>"+
-    "    </div>"+
-    "    <nav>" +
-    "        <a href=\"/\" id=\"relayControlLink\" class=\"relayControlActive\">Relay Control</a>" +  
-    "        <a href=\"/RTC_Event\" id=\"rtcEventLink\" class=\"rtcEventActive\">RTC Event</a>" + 
-    "    </nav>" +
-    "    <div class=\"container\">"+
-    "        <div class=\"input-container\" style=\"margin-left: 140px;\">"+
-    "            <label for=\"input1\">CH1</label>"+
-    "            <input type=\"text\" id=\"ch1\" />"+
-    "            <button value=\"Switch1\" id=\"btn1\" disabled onclick=\"ledSwitch(1)\">Button 1</button>"+
-    "        </div>"+
-    "        <div class=\"input-container\" style=\"margin-left: 140px;\">"+
-    "            <label for=\"input2\">CH2</label>"+
-    "            <input type=\"text\" id=\"ch2\" />"+
-    "            <button value=\"Switch2\" id=\"btn2\" disabled onclick=\"ledSwitch(2)\">Button 2</button>"+
-    "        </div>"+
-    "        <div class=\"input-container\" style=\"margin-left: 140px;\">"+
-    "            <label for=\"input3\">CH3</label>"+
-    "            <input type=\"text\" id=\"ch3\" />"+
-    "            <button value=\"Switch3\" id=\"btn3\" disabled onclick=\"ledSwitch(3)\">Button 3</button>"+
-    "        </div>"+
-    "        <div class=\"input-container\" style=\"margin-left: 140px;\">"+
-    "            <label for=\"input4\">CH4</label>"+
-    "            <input type=\"text\" id=\"ch4\" />"+
-    "            <button value=\"Switch4\" id=\"btn4\" disabled onclick=\"ledSwitch(4)\">Button 4</button>"+
-    "        </div>"+
-    "        <div class=\"input-container\" style=\"margin-left: 140px;\">"+
-    "            <label for=\"input5\">CH5</label>"+
-    "            <input type=\"text\" id=\"ch5\" />"+
-    "            <button value=\"Switch5\" id=\"btn5\" disabled onclick=\"ledSwitch(5)\">Button 5</button>"+
-    "        </div>"+
-    "        <div class=\"input-container\" style=\"margin-left: 140px;\">"+
-    "            <label for=\"input6\">CH6</label>"+
-    "            <input type=\"text\" id=\"ch6\" />"+
-    "            <button value=\"Switch6\" id=\"btn6\" disabled onclick=\"ledSwitch(6)\">Button 6</button>"+
-    "        </div>"+
-    "        <div class=\"input-container\" style=\"margin-left: 140px;\">"+
-    "            <label for=\"input7\">CH7</label>"+
-    "            <input type=\"text\" id=\"ch7\" />"+
-    "            <button value=\"Switch7\" id=\"btn7\" disabled onclick=\"ledSwitch(7)\">Button 7</button>"+
-    "        </div>"+
-    "        <div class=\"input-container\" style=\"margin-left: 140px;\">"+
-    "            <label for=\"input8\">CH8</label>"+
-    "            <input type=\"text\" id=\"ch8\" />"+
-    "            <button value=\"Switch8\" id=\"btn8\" disabled onclick=\"ledSwitch(8)\">Button 8</button>"+
-    "        </div>"+
-    "        <div class=\"button-container\">"+
-    "            <button value=\"AllOn\" id=\"btn9\" disabled onclick=\"ledSwitch(9)\">All On</button>"+
-    "            <button value=\"AllOff\" id=\"btn0\" disabled onclick=\"ledSwitch(0)\">All Off</button>"+
-    "        </div>"+
-    "        <div id=\"errorTextbox\" style=\"display: none;\"> "+     
-    "            <p>English:Please refresh the page</p>"+      
-    "            <p>Chinese:请刷新页面</p>"+
-    "        </div>"+
-    "    </div>"+
-    "</body>"+
-    "</html>";
-    
-  server.send(200, "text/html", myhtmlPage); 
+  Web_Send_Page(Web_Page_Root, Web_Page_Root_Length, Web_Page_Root_ETag);
   printf("The user visited the home page\r\n");
-  
 }
 void handleRTCPage() {      
-    String rtcPage = String("") + 
-    "<html>" + 
-    "<head>" + 
-    "    <meta charset=\"utf-8\">" + 
-    "    <title>ESP32-S3-POE-ETH-8DI-8RO</title>" + 
-    "    <style>" + 
-    "        body {" + 
-    "            font-family: Arial, sans-serif;" + 
-    "            background-color: #f0f0f0;" + 
-    "            margin: 0;" + 
-    "            padding: 0;" + 
-    "        }" + 
-    "        .header {" + 
-    "            text-align: center;" + 
-    "            padding: 20px 0;" + 
-    "            background-color: #333;" + 
-    "            color: #fff;" + 
-    "            margin-bottom: 20px;" + 
-    "        }" + 
-    "        .container {" + 
-    "            max-width: 600px;" + 
-    "            margin: 10px auto;" + 
-    "            padding: 20px;" + 
-    "            background-color: #fff;" + 
-    "            border-radius: 5px;" + 
-    "            box-shadow: 0 0 5px rgba(0, 0, 0, 0.3);" + 
-    "        }" + 
-    "        .form-group {" + 
-    "            margin-bottom: 15px;" + 
-    "        }" + 
-    "        .form-group label {" + 
-    "            display: block;" + 
-    "            font-weight: bold;" + 
-    "        }" + 
-    "        .form-group input {" + 
-    "            width: 80px;" + 
-    "            height: 25px;" + 
-    "            padding: 4px;" + 
-    "            margin-top: 5px;" + 
-    "            border: 1px solid #ddd;" + 
-    "            border-radius: 4px;" + 
-    "            box-sizing: border-box;" + 
-    "            text-align: right; " + 
-    "        }" + 
-    "        .form-group select {" + 
-    "            width: 80px;" + 
-    "            height: 25px;" + 
-    "            padding: 4px;" + 
-    "            margin-top: 5px;" + 
-    "            border: 1px solid #ddd;" + 
-    "            border-radius: 4px;" + 
-    "            box-sizing: border-box;" + 
-    "            text-align: right; " + 
-    "        }" + 
-    "        .form-group .btn {" + 
-    "            padding: 10px 20px;" + 
-    "            background-color: #333;" + 
-    "            color: white;" + 
-    "            border: none;" + 
-    "            border-radius: 5px;" + 
-    "            cursor: pointer;" + 
-    "        }" + 
-    "        .form-group .btn:hover {" + 
-    "            background-color: #555;" + 
-    "        }" + 
-    "        .Events{"+
-    "            font-size: 13px;"+
-    "            word-wrap: break-word;"+
-    "            overflow-wrap: break-word;"+
-    "            max-width: 100%;"+
-    "            white-space: nowrap;"+
-    "            padding: 2px;"+
-    "        }"+
-    "        .Events button {"+
-    "            float: right;" + 
-    "            margin-left: 1px;" + 
-    "        }"+
-    "        .Events li {"+
-    "            font-size: 13px;" + 
-    "        }"+
-    "        nav {" + 
-    "            margin: 15px 0;" + 
-    "            text-align: center;" + 
-    "        }" + 
-    "        nav a {" + 
-    "            padding: 10px 50px;" + 
-    "            background-color: #333;" + 
-    "            color: white;" + 
-    "            text-decoration: none;" + 
-    "            font-weight: bold;" + 
-    "            border-radius: 5px;" + 
-    "        }" + 
-    "        nav a.relayControlActive {" + 
-    "            background-color: #555;" + 
-    "        }" + 
-    "        nav a.rtcEventActive {" + 
-    "            background-color: #fff;" + 
-    "            color: #333;" + 
-    "            box-shadow: 0 4px 6px rgba(0, 0, 0, 0.3), 0 1px 3px rgba(0, 0, 0, 0.1);" + 
-    "            transform: translateY(-4px);" + 
-    "            transition: all 0.2s ease-in-out;" + 
-    "        }" + 
-    "    </style>" + 
-    "</head>" + 
-    "<body>" +
-    "    <script defer=\"defer\">" +
-    "        function getRtcEventData() {" +
-    "            var dateBox1 = document.getElementById('DateBox1').value;" +
-    "            var dateBox2 = document.getElementById('DateBox2').value;" +
-    "            var dateBox3 = document.getElementById('DateBox3').value;" +
-    "            var week = document.getElementById('Week').value;" +
-    "            var timeBox1 = document.getElementById('TimeBox1').value;" +
-    "            var timeBox2 = document.getElementById('TimeBox2').value;" +
-    "            var timeBox3 = document.getElementById('TimeBox3').value;" +
-    "            var relayCH1 = document.getElementById('RelayCH1').value;" +
-    "            var relayCH2 = document.getElementById('RelayCH2').value;" +
-    "            var relayCH3 = document.getElementById('RelayCH3').value;" +
-    "            var relayCH4 = document.getElementById('RelayCH4').value;" +
-    "            var relayCH5 = document.getElementById('RelayCH5').value;" +
-    "            var relayCH6 = document.getElementById('RelayCH6').value;" +
-    "            var relayCH7 = document.getElementById('RelayCH7').value;" +
-    "            var relayCH8 = document.getElementById('RelayCH8').value;" +
-    "            var cycleBox = document.getElementById('CycleBox').value;" +
-    "            var WebData = " +
-    "                'Date: ' + dateBox1 + '/' + dateBox2 + '/' + dateBox3 + '  ' + '\\n' + " + 
-    "                'Week: ' + week + '  ' + '\\n' + " + 
-    "                'Time: ' + timeBox1 + ':' + timeBox2 + ':' + timeBox3 +  '  ' + '\\n' + " + 
-    "                'Relay CH1: ' + relayCH1 + '  ' + '\\n' + " + 
-    "                'Relay CH2: ' + relayCH2 + '  ' + '\\n' + " + 
-    "                'Relay CH3: ' + relayCH3 + '  ' + '\\n' + " + 
-    "                'Relay CH4: ' + relayCH4 + '  ' + '\\n' + " + 
-    "                'Relay CH5: ' + relayCH5 + '  ' + '\\n' + " + 
-    "                'Relay CH6: ' + relayCH6 + '  ' + '\\n' + " + 
-    "                'Relay CH7: ' + relayCH7 + '  ' + '\\n' + " + 
-    "                'Relay CH8: ' + relayCH8 + '  ' + '\\n' + " + 
-    "                'Cycle: ' + cycleBox + '  ' + '\\n' ;" + 
-    "            var xhr = new XMLHttpRequest();" +
-    "            xhr.open('GET', '/NewEvent?data=' + WebData, true);" +
-    "            xhr.send();" +
-    "        }" +
-    "        function deleteEvent(eventId) {"+
-    "            var xhr = new XMLHttpRequest();"+
-    "            var EventId = eventId;"+
-    "            xhr.open('GET', '/DeleteEvent?id=' + EventId, true);"+
-    "            xhr.send();"+
-    "        }"+
-    "        function updateList(data) {"+
-    "            var list = document.getElementById(\"myList\");"+
-    "            list.innerHTML = \'\'; "+
-    "            for (let i = 0; i < data.eventCount; i++) {"+
-    "                var newItem = document.createElement(\"li\");"+
-    "                var eventContent = data[\"eventStr\" + (i + 1)].replace(/\\n/g, \"<br>\");"+
-    "                newItem.innerHTML = eventContent;"+
-    "                var eventButton = document.createElement(\"button\");"+
-    "                eventButton.textContent = \"Delete\" + \"Event\" + (i + 1);"+
-    "                eventButton.onclick = function() {"+
-    "                    deleteEvent(i+1);"+
-    "                };"+
-    "                newItem.style.display = 'flex';"+
-    "                newItem.style.justifyContent = 'space-between';"+
-    "                newItem.style.alignItems = 'center';"+
-    "                newItem.appendChild(eventButton);"+
-    "                list.appendChild(newItem);"+
-    "            }"+
-    "        }"+
-    "        function upTime() {"+
-    "            var xhr = new XMLHttpRequest();"+
-    "            xhr.open('GET', '/getTimeAndEvent', true); "+
-    "            xhr.onreadystatechange = function() {"+
-    "                if (xhr.readyState === 4 && xhr.status === 200) {"+
-    "                    var data = JSON.parse(xhr.responseText); "+
-    "                    document.getElementById(\"Time\").textContent = data.time;"+
-    "                    updateList(data); "+
-    "                }"+
-    "            };"+
-    "            xhr.send();"+
-    // "        fetch(\'/getTimeAndEvent\')"+
-    // "            .then(response => response.json())"+
-    // "            .then(data => {"+
-    // "                document.getElementById(\"Time\").textContent = data.time;"+
-    // "                updateList(data);"+
-    // "            })"+
-    // "            .catch(error => {"+
-    // "                console.error(\'Error fetching time and events:\', error);"+
-    // "            });"+
-    "        }"+
-    "        var refreshInterval = 400;"+                                     
-    "        setInterval(upTime, refreshInterval);"+         
-    "    </script>" +
-    "    <div class=\"header\">"+
-    "        <h1>ESP32-S3-POE-ETH-8DI-8RO</h1>" + 
-    "    </div>" + 
-    "    <nav>" + 
-    "        <a href=\"/\" id=\"relayControlLink\" class=\"relayControlActive\">Relay Control</a>" +  
-    "        <a href=\"/RTC_Event\" id=\"rtcEventLink\" class=\"rtcEventActive\">RTC Event</a>" +  
-    "    </nav>" + 
-    "    <div class=\"container\">" +  
-    "        <div class=\"form-group\">" + 
-    "            <label for=\"Date\">Date:(example:2024/12/20)</label>" + 
-    "            <input type=\"text\" id=\"DateBox1\" style=\"width: 50px;\" value=\"2024\">" + 
-    "            <span>/</span>" + 
-    "            <input type=\"text\" id=\"DateBox2\" style=\"width: 50px;\" value=\"12\">" + 
-    "            <span>/</span>" + 
-    "            <input type=\"text\" id=\"DateBox3\" style=\"width: 50px;\" value=\"20\">" + 
-    "            <span>&nbsp;&nbsp;&nbsp;</span>" + 
-    "            <select id=\"Week\" style=\"width: 150px;\">" + 
-    "                <option value=\"1\">星期一(Monday)</option>" + 
-    "                <option value=\"2\">星期二(Tuesday)</option>" + 
-    "                <option value=\"3\">星期三(Wednesday)</option>" + 
-    "                <option value=\"4\">星期四(Thursday)</option>" + 
-    "                <option value=\"5\">星期五(Friday)</option>" + 
-    "                <option value=\"6\">星期六(Saturday)</option>" + 
-    "                <option value=\"0\">星期日(Sunday)</option>" + 
-    "            </select>" + 
-    "        </div>" + 
-    "        <div class=\"form-group\">" + 
-    "            <label for=\"Time\">Time:(example:16:51:21)</label>" + 
-    "            <input type=\"text\" id=\"TimeBox1\" style=\"width: 50px;\" value=\"0\">" + 
-    "            <span>:</span>" + 
-    "            <input type=\"text\" id=\"TimeBox2\" style=\"width: 50px;\" value=\"0\">" + 
-    "            <span>:</span>" + 
-    "            <input type=\"text\" id=\"TimeBox3\" style=\"width: 50px;\" value=\"0\">" + 
-    "        </div>" + 
-    "        <div class=\"form-group\">" + 
-    "            <label for=\"relayBox\">Relay:</label>" +
-    "            <span>CH1~CH4: </span>" + 
-    "            <select id=\"RelayCH1\" style=\"width: 100px;\">" + 
-    "                <option value=\"2\">保留(Retain)</option>" + 
-    "                <option value=\"0\">关闭(close)</option>" + 
-    "                <option value=\"1\">打开(Open)</option>" + 
-    "            </select>" + 
-    "            <select id=\"RelayCH2\" style=\"width: 100px;\">" + 
-    "                <option value=\"2\">保留(Retain)</option>" + 
-    "                <option value=\"0\">关闭(close)</option>" + 
-    "                <option value=\"1\">打开(Open)</option>" + 
-    "            </select>" + 
-    "            <select id=\"RelayCH3\" style=\"width: 100px;\">" + 
-    "                <option value=\"2\">保留(Retain)</option>" + 
-    "                <option value=\"0\">关闭(close)</option>" + 
-    "                <option value=\"1\">打开(Open)</option>" + 
-    "            </select>" + 
-    "            <select id=\"RelayCH4\" style=\"width: 100px;\">" + 
-    "                <option value=\"2\">保留(Retain)</option>" + 
-    "                <option value=\"0\">关闭(close)</option>" + 
-    "                <option value=\"1\">打开(Open)</option>" + 
-    "            </select>" + 
-    "            <span><br>CH5~CH8: </span>" + 
-    "            <select id=\"RelayCH5\" style=\"width: 100px;\">" + 
-    "                <option value=\"2\">保留(Retain)</option>" + 
-    "                <option value=\"0\">关闭(close)</option>" + 
-    "                <option value=\"1\">打开(Open)</option>" + 
-    "            </select>" + 
-    "            <select id=\"RelayCH6\" style=\"width: 100px;\">" + 
-    "                <option value=\"2\">保留(Retain)</option>" + 
-    "                <option value=\"0\">关闭(close)</option>" + 
-    "                <option value=\"1\">打开(Open)</option>" + 
-    "            </select>" + 
-    "            <select id=\"RelayCH7\" style=\"width: 100px;\">" + 
-    "                <option value=\"2\">保留(Retain)</option>" + 
-    "                <option value=\"0\">关闭(close)</option>" + 
-    "                <option value=\"1\">打开(Open)</option>" + 
-    "            </select>" + 
-    "            <select id=\"RelayCH8\" style=\"width: 100px;\">" + 
-    "                <option value=\"2\">保留(Retain)</option>" + 
-    "                <option value=\"0\">关闭(close)</option>" + 
-    "                <option value=\"1\">打开(Open)</option>" + 
-    "            </select>" + 
-    "        </div>" + 
-    "        <div class=\"form-group\">" + 
-    "            <label for=\"cycleBox\">Cycle:</label>" + 
-    "            <select id=\"CycleBox\" style=\"width: 150px;\">" + 
-    "                <option value=\"0\">无重复(Aperiodicity)</option>" + 
-    "                <option value=\"1\">每天(everyday)</option>" + 
-    "                <option value=\"2\">每周(Weekly)</option>" + 
-    "                <option value=\"3\">每月(monthly)</option>" + 
-    "            </select>" + 
-    "        </div>" + 
-    "        <div class=\"form-group\">" + 
-    "            <button class=\"btn\" id=\"NewEvent\" onclick=\"getRtcEventData()\">New Event</button>" + 
-    "        </div>" + 
-    "    </div>" + 
-    "    <div class=\"container\">" +  
-    "        <div class=\"form-group\">" + 
-    "            <span id=\"Time\"></span> "+
-    "        </div>" + 
-    "        <div class=\"Events\">" + 
-    "            <ul id=\"myList\"> "+
-    "            </ul> "+
-    "        </div>" + 
-    "    </div>" + 
-    "</body>" + 
-    "</html>"; 
-
-    server.send(200, "text/html", rtcPage);   
-    printf("The user visited the RTC Event page\r\n"); 
+  Web_Send_Page(Web_Page_RTC, Web_Page_RTC_Length, Web_Page_RTC_ETag);
+  printf("The user visited the RTC Event page\r\n"); 
 }
 
 
 
 void handleGetData() {
-  String json = "[";
-  for (int i = 0; i < sizeof(Relay_Flag) / sizeof(Relay_Flag[0]); i++) {
-    json += String(Relay_Flag[i]);
-    if (i < sizeof(Relay_Flag) / sizeof(Relay_Flag[0]) - 1) {
-      json += ",";
+  char Text[Relay_Number_MAX * 2 + 2];                        // "[0,1,...]", sent from here without a String copy
+  int Length = 0;
+  Text[Length++] = '[';
+  for (int i = 0; i < Relay_Number_MAX; i++) {
+    if (i)
+      Text[Length++] = ',';
+    Text[Length++] = Relay_Flag[i] ? '1' : '0';
+  }
+  Text[Length++] = ']';
+  server.send_P(200, "application/json", Text, Length);
+}
+
+/********************************************************  Relay API  ********************************************************/
+// GET  /api/relay : {"relay":5,"din":0,"channels":8}                 masks, bit0 = CH1 / DIN1
+// POST /api/relay : {"set":5,"clear":2,"toggle":128}                 masks
+//                   {"data":{"CH1":1,"CH3":0,"ALL":1}}               the MQTT format, keys applied in order
+// Both forms can be combined, everything one request asks for ends up in the same RelayTask batch.
+static int Web_Format_State(char *Text, size_t Size)
+{
+  return snprintf(Text, Size, "{\"relay\":%lu,\"din\":%u,\"channels\":%d}", (unsigned long)Relay_Get_PinState(), (unsigned int)DIN_Data, Relay_Number_MAX);
+}
+static bool Web_Parse_Mask(JSON_Parser *P, Relay_Mask_t *Mask)
+{
+  uint32_t Value;
+  if(!JSON_Parse_Uint(P, &Value) || (Value & ~(uint32_t)Relay_Channels.All))
+    return false;
+  *Mask = (Relay_Mask_t)Value;
+  return true;
+}
+static bool Web_Parse_Relay(const uint8_t *Body, unsigned int Length, Relay_Mask_t *Open, Relay_Mask_t *Closs, Relay_Mask_t *Toggle)
+{
+  JSON_Parser P = {Body, Length, 0};
+  const char *Key;
+  unsigned int Key_Length;
+  Relay_Mask_t Mask;
+  *Open = 0;
+  *Closs = 0;
+  *Toggle = 0;
+  if(!JSON_Expect(&P, '{'))
+    return false;
+  if(JSON_Expect(&P, '}'))
+    return true;
+  do {
+    if(!JSON_Parse_Key(&P, &Key, &Key_Length))
+      return false;
+    if(JSON_Key_Is(Key, Key_Length, "data")){
+      if(!JSON_Parse_Channels(&P, Open, Closs, "WIFI"))
+        return false;
+    }
+    else if(JSON_Key_Is(Key, Key_Length, "set")){
+      if(!Web_Parse_Mask(&P, &Mask))
+        return false;
+      *Open |= Mask;
+      *Closs &= (Relay_Mask_t)~Mask;
+    }
+    else if(JSON_Key_Is(Key, Key_Length, "clear")){
+      if(!Web_Parse_Mask(&P, &Mask))
+        return false;
+      *Closs |= Mask;
+      *Open &= (Relay_Mask_t)~Mask;
+    }
+    else if(JSON_Key_Is(Key, Key_Length, "toggle")){
+      if(!Web_Parse_Mask(&P, &Mask))
+        return false;
+      *Toggle ^= Mask;
+    }
+    else if(!JSON_Skip_Value(&P))
+      return false;
+  } while(JSON_Expect(&P, ','));
+  return JSON_Expect(&P, '}');
+}
+void handleRelayAPI() {
+  char Text[64];
+  if(server.method() == HTTP_POST){
+    Relay_Mask_t Open, Closs, Toggle;
+    String Body = server.arg("plain");
+    if(!Web_Parse_Relay((const uint8_t *)Body.c_str(), Body.length(), &Open, &Closs, &Toggle)){
+      server.send(400, "application/json", "{\"error\":\"bad request\"}");
+      return;
     }
+    if(Open || Closs || Toggle)
+      Relay_Immediate_Change(Open, Closs, Toggle, WIFI_Mode);            // One command, so always one batch
+    server.send(202, "application/json", "{\"queued\":true}");          // The new state follows on /api/events
+    return;
   }
-  json += "]";
-  server.send(200, "application/json", json);
+  Web_Format_State(Text, sizeof(Text));
+  server.send(200, "application/json", Text);
 }
 
-void handleSwitch(uint8_t ledNumber) {
-  uint8_t Data[1]={0};
-  Data[0]=ledNumber+48;
-  Relay_Analysis(Data,WIFI_Mode);
-  server.send(200, "text/plain", "OK");
+/********************************************************  Trace API  ********************************************************/
+// GET /api/trace : latency histograms of the relay commands (see WS_Trace.h), ?reset=1 clears them after the report
+void handleTraceAPI() {
+  Trace_Report Report;
+  char Text[Trace_Item_Size];
+  Trace_Get_Report(&Report);
+  if(server.hasArg("reset") && server.arg("reset") == "1")
+    Trace_Reset();
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send(200, "application/json", "");
+  for (int i = 0, n; (n = Trace_Format(&Report, i, Text, sizeof(Text))) >= 0; i++) {
+    server.sendContent(Text, n);
+  }
+  server.sendContent(Text, 0);                                // End of the chunked response
+}
+
+/********************************************************  Audit log API  ********************************************************/
+// GET /api/log                          : [{"file":"20261014_00.bin","size":4096},...] and the dropped record count
+// GET /api/log?file=NAME                : the binary records of WS_SD_Log.h as they are on the card
+// GET /api/log?file=NAME&format=csv     : epoch,millis,type,source,arg16,arg32 per record
+static bool Web_Log_Name_Valid(const char *Name)            // A file of the log directory, no path
+{
+  size_t Length = strlen(Name);
+  if(!Length || Length >= SD_Log_Name_MAX || Name[0] == '.')
+    return false;
+  for (size_t i = 0; i < Length; i++) {
+    if(!isalnum((unsigned char)Name[i]) && Name[i] != '_' && Name[i] != '.')
+      return false;
+  }
+  return true;
+}
+void handleLogAPI() {
+  char Text[160];
+  if(!server.hasArg("file")){
+    SD_Log_File_Info Files[SD_Log_Export_Files];
+    int Count = SD_Log_List(0, Files, SD_Log_Export_Files);
+    if(Count < 0){                                            // SDLogTask writes, rotates or remounts, or there is no card
+      server.send(503, "text/plain", "SD card busy or not mounted");
+      return;
+    }
+    server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    server.send(200, "application/json", "");
+    int n = snprintf(Text, sizeof(Text), "{\"dropped\":%lu,\"files\":[", (unsigned long)SD_Log_Dropped());
+    server.sendContent(Text, n);
+    for (uint16_t First = 0; Count > 0; First += Count) {
+      for (int i = 0; i < Count; i++) {
+        n = snprintf(Text, sizeof(Text), "%s{\"file\":\"%s\",\"size\":%lu}", (First + i) ? "," : "", Files[i].Name, (unsigned long)Files[i].Size);
+        server.sendContent(Text, n);
+      }
+      if(Count < SD_Log_Export_Files)
+        break;
+      Count = SD_Log_List(First + Count, Files, SD_Log_Export_Files);   // The card is free while the client reads
+    }
+    server.sendContent("]}", 2);
+    server.sendContent(Text, 0);                              // End of the chunked response
+    return;
+  }
+  String Name = server.arg("file");
+  if(!Web_Log_Name_Valid(Name.c_str())){
+    server.send(400, "text/plain", "Invalid file name");
+    return;
+  }
+  uint8_t Data[SD_Log_Export_Chunk];
+  uint32_t Size = 0;
+  int Length = SD_Log_Read(Name.c_str(), 0, Data, sizeof(Data), &Size);
+  if(Length == -1){
+    server.send(503, "text/plain", "SD card busy or not mounted");
+    return;
+  }
+  if(Length < 0){
+    server.send(404, "text/plain", "No such log file");
+    return;
+  }
+  bool CSV = server.hasArg("format") && server.arg("format") == "csv";
+  if(CSV){
+    server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    server.send(200, "text/csv", "epoch,millis,type,source,arg16,arg32\n");
+  }
+  else{
+    server.setContentLength(Size);                            // The size when the export started, later records are left out
+    server.send(200, "application/octet-stream", "");
+  }
+  for (uint32_t Offset = 0; Length > 0; ) {
+    if(CSV){
+      Length -= Length % sizeof(SD_Log_Record);
+      for (int i = 0; i < Length / (int)sizeof(SD_Log_Record); i++) {
+        const SD_Log_Record *R = (const SD_Log_Record *)&Data[i * sizeof(SD_Log_Record)];
+        int n = snprintf(Text, sizeof(Text), "%lu,%lu,%s,%u,%u,%lu\n", (unsigned long)R->Epoch, (unsigned long)R->Millis,
+                         SD_Log_Type_Name(R->Type), R->Source, R->Arg16, (unsigned long)R->Arg32);
+        server.sendContent(Text, n);
+      }
+    }
+    else
+      server.sendContent((const char *)Data, Length);
+    Offset += Length;
+    if(Length <= 0 || Offset >= Size)
+      break;
+    Length = SD_Log_Read(Name.c_str(), Offset, Data, Size - Offset < sizeof(Data) ? Size - Offset : sizeof(Data), NULL);   // A lost card ends the export early
+  }
+  if(CSV)
+    server.sendContent(Text, 0);
 }
-void handleSwitch1() { handleSwitch(1); }
-void handleSwitch2() { handleSwitch(2); }
-void handleSwitch3() { handleSwitch(3); }
-void handleSwitch4() { handleSwitch(4); }
-void handleSwitch5() { handleSwitch(5); }
-void handleSwitch6() { handleSwitch(6); }
-void handleSwitch7() { handleSwitch(7); }
-void handleSwitch8() { handleSwitch(8); }
-void handleSwitch9() { handleSwitch(9); }
-void handleSwitch0() { handleSwitch(0); }
+
+/********************************************************  Event stream  ********************************************************/
+// /api/events is a Server-Sent Events stream. The pages get the relay / DIN state when it changes and
+// the time once a second, instead of every open page polling the server.
+//   event: state   data: {"relay":5,"din":0,"channels":8}
+//   event: time    data: {"time":" 2024/12/20  Fri  9:50:0","events":3}     events : TimerEvent_Revision()
+static WiFiClient Web_Event_Clients[Web_Event_Client_MAX];
+static bool Web_Event_Used[Web_Event_Client_MAX];
+static uint8_t Web_Event_Count = 0;
+static std::atomic<bool> Web_State_Changed(false);           // Set by the relay / DIN listeners, sent from WifiStaTask
+static uint32_t Web_Time_Epoch = 0;       // Second of the last time event, 0 : send at once
+
+static void Web_Relay_Changed(Relay_Mask_t PinState)
+{
+  Web_State_Changed.store(true, std::memory_order_release);
+}
+static void Web_DIN_Changed(uint8_t Data)
+{
+  Web_State_Changed.store(true, std::memory_order_release);
+}
+static int Web_Format_Time(char *Text, size_t Size)
+{
+  datetime_t datetime = {0};
+  Time_Get(&datetime);
+  return snprintf(Text, Size, " %d/%d/%d  %s  %d:%d:%d", datetime.year, datetime.month, datetime.day, Week[datetime.dotw], datetime.hour, datetime.minute, datetime.second);
+}
+static void Web_Events_Drop(int Slot)
+{
+  Web_Event_Clients[Slot].stop();
+  Web_Event_Clients[Slot] = WiFiClient();
+  Web_Event_Used[Slot] = false;
+  Web_Event_Count--;
+}
+static void Web_Events_Send(const char *Text, int Length)
+{
+  for (int i = 0; i < Web_Event_Client_MAX; i++) {
+    if(!Web_Event_Used[i])
+      continue;
+    if(!Web_Event_Clients[i].connected() || Web_Event_Clients[i].write((const uint8_t *)Text, Length) != (size_t)Length)
+      Web_Events_Drop(i);                                     // Closed by the browser or not reading any more
+  }
+}
+static void Web_Events_Loop(void)
+{
+  static char Text[128];
+  if(!Web_Event_Count)
+    return;
+  if(Web_State_Changed.exchange(false, std::memory_order_acquire)){
+    int Length = snprintf(Text, sizeof(Text), "event: state\ndata: ");
+    Length += Web_Format_State(Text + Length, sizeof(Text) - Length);
+    Length += snprintf(Text + Length, sizeof(Text) - Length, "\n\n");
+    Web_Events_Send(Text, Length);
+  }
+  uint32_t Now = 1;
+  Time_Get_Epoch(&Now);
+  if(Now != Web_Time_Epoch){                                  // The time event also keeps idle streams alive
+    Web_Time_Epoch = Now;
+    int Length = snprintf(Text, sizeof(Text), "event: time\ndata: {\"time\":\"");
+    Length += Web_Format_Time(Text + Length, sizeof(Text) - Length);
+    Length += snprintf(Text + Length, sizeof(Text) - Length, "\",\"events\":%lu}\n\n", (unsigned long)TimerEvent_Revision());
+    Web_Events_Send(Text, Length);
+  }
+}
+static void Web_Events_Close(void)
+{
+  for (int i = 0; i < Web_Event_Client_MAX; i++) {
+    if(Web_Event_Used[i])
+      Web_Events_Drop(i);
+  }
+}
+void handleEvents() {
+  static const char Header[] = "HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\nCache-Control: no-cache\r\nConnection: keep-alive\r\n\r\nretry: 2000\n\n";
+  for (int i = 0; i < Web_Event_Client_MAX; i++) {
+    if(Web_Event_Used[i] && !Web_Event_Clients[i].connected())
+      Web_Events_Drop(i);
+  }
+  for (int i = 0; i < Web_Event_Client_MAX; i++) {
+    if(!Web_Event_Used[i]){
+      // WebServer only drops its reference once the handler returns, this copy keeps the socket open
+      Web_Event_Clients[i] = server.client();
+      Web_Event_Clients[i].setNoDelay(true);
+      Web_Event_Clients[i].write((const uint8_t *)Header, sizeof(Header) - 1);
+      Web_Event_Used[i] = true;
+      Web_Event_Count++;
+      Web_State_Changed.store(true, std::memory_order_release);   // The new page gets the current state and time right away
+      Web_Time_Epoch = 0;
+      return;
+    }
+  }
+  server.send(503, "text/plain", "Too many event streams");
+}
+
 
 void handleNewEvent(void) {
-  char Text[200];
-  if (server.hasArg("data")) {
-    String newData = server.arg("data");
-    newData.toCharArray(Text, sizeof(Text));
+  char *Text = (char *)Pool_Alloc(&Pool_HTTP);
+  if (!Text) {
+    server.send(503, "text/plain", "Busy");
+    return;
   }
+  Text[0] = '\0';
+  if (server.hasArg("data"))
+    strlcpy(Text, server.arg("data").c_str(), Web_Text_Size);
   server.send(200, "text/plain", "OK");
 
   printf("Text=%s.\r\n",Text);  // Text=Date: 2024/12/20  Week: 0  Time: 0:0:0  Relay CH1: 0  Relay CH2: 2  Relay CH3: 2  Relay CH4: 2  Relay CH5: 2  Relay CH6: 2  Relay CH7: 2  Relay CH8: 2  Cycle: 0.
@@ -587,33 +352,38 @@ void handleNewEvent(void) {
     printf("Error parsing Event_Time !!!!\r\n");
   else
     TimerEvent_CHxn_Set(Event_Time, Relay_n, cycleEvent);
+  Pool_Free(&Pool_HTTP, Text);
 }
 
 void handleUpTimeAndEvent() {
-  // Format the datetime string
+  static char Text[RTC_Event_Text_Size + 24];                 // One event at a time with its JSON key, the response is sent in chunks
+  Timing_RTC event;
   char datetime_str[50];
-  sprintf(datetime_str, " %d/%d/%d  %s  %d:%d:%d", datetime.year, datetime.month, datetime.day, Week[datetime.dotw], datetime.hour, datetime.minute, datetime.second);
+  Web_Format_Time(datetime_str, sizeof(datetime_str));
 
-  int eventCount = Timing_events_Num;  // Get the event count (e.g., Timing_events_Num)
-
-  // Create a JSON response
-  String jsonResponse = "{";
-  
-  jsonResponse += "\"time\":\"" + String(datetime_str) + "\",";
-  for (int i = 0; i < eventCount; i++) {
-    jsonResponse += "\"eventStr" + String(i + 1) + "\":\"" + String(Event_str[i]) + "\",";
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send(200, "text/plain", "");
+  server.sendContent(Text, snprintf(Text, sizeof(Text), "{\"time\":\"%s\",", datetime_str));
+  int eventCount = 0;
+  while (TimerEvent_Get(eventCount + 1, &event)) {
+    eventCount++;
+    int Length = snprintf(Text, sizeof(Text), "\"eventStr%d\":\"", eventCount);
+    Length += TimerEvent_Render(&event, Text + Length, sizeof(Text) - Length - 2);
+    Text[Length++] = '"';
+    Text[Length++] = ',';
+    server.sendContent(Text, Length);
   }
-  jsonResponse += "\"eventCount\":" + String(eventCount);
-  jsonResponse += "}";
-  // Send the datetime string as a response
-  server.send(200, "text/plain", jsonResponse );
+  server.sendContent(Text, snprintf(Text, sizeof(Text), "\"eventCount\":%d}", eventCount));
+  server.sendContent(Text, 0);                                // End of the chunked response
 }
 void handleDeleteEvent() {
   if (server.hasArg("id")) {
     int id = server.arg("id").toInt();
     if (id > 0) {
+      char Text[32];
       TimerEvent_Del_Number((uint8_t)id);
-      server.send(200, "text/plain", "Event " + String(id) + " deleted.");
+      snprintf(Text, sizeof(Text), "Event %d deleted.", id);
+      server.send(200, "text/plain", Text);
       printf("Event %d deleted.\r\n", id);
     } else {
       server.send(400, "text/plain", "Invalid event ID.");
@@ -624,18 +394,12 @@ void handleDeleteEvent() {
 }
 void WIFI_Init()
 {
-  xTaskCreatePinnedToCore(
-    WifiStaTask,    
-    "WifiStaTask",   
-    4096,                
-    NULL,                 
-    3,                   
-    NULL,                 
-    0                   
-  );
+  Network_Init();
+  Web_Init();
+  Task_Start(Task_WiFi_STA, WifiStaTask);
 }
 
-
+// Keeps the STA link up. The web server and MQTT use it through WS_Network whenever ETH is down.
 void WifiStaTask(void *parameter) {
   uint8_t Count = 0;
   WiFi.mode(WIFI_STA);                                   
@@ -660,44 +424,68 @@ void WifiStaTask(void *parameter) {
         WiFi.begin(ssid, password);
       }
     }
-    else{
+    else if(!WIFI_Connection){
       WIFI_Connection = 1;
+      Count = 0;
       IPAddress myIP = WiFi.localIP();
-      printf("IP Address: ");
-      sprintf(ipStr, "%d.%d.%d.%d", myIP[0], myIP[1], myIP[2], myIP[3]);
-      printf("%s\r\n", ipStr);
+      printf("WIFI IP Address: %d.%d.%d.%d\r\n", myIP[0], myIP[1], myIP[2], myIP[3]);
       //RGB_Open_Time(0, 50, 0, 1000, 0); 
-      
-      server.on("/", handleRoot);            // Relay Control page
-      server.on("/getData", handleGetData);
-      server.on("/Switch1", handleSwitch1);
-      server.on("/Switch2", handleSwitch2);
-      server.on("/Switch3", handleSwitch3);
-      server.on("/Switch4", handleSwitch4);
-      server.on("/Switch5", handleSwitch5);
-      server.on("/Switch6", handleSwitch6);
-      server.on("/Switch7", handleSwitch7);
-      server.on("/Switch8", handleSwitch8);
-      server.on("/AllOn"  , handleSwitch9);
-      server.on("/AllOff" , handleSwitch0);
-      
-      server.on("/RTC_Event", handleRTCPage);      // RTC Event page
-      server.on("/NewEvent" , handleNewEvent);
-      server.on("/getTimeAndEvent", handleUpTimeAndEvent);
-      server.on("/DeleteEvent", handleDeleteEvent);
-      
-      server.begin(); 
-      printf("Web server started\r\n"); 
-
-      while (WiFi.status() == WL_CONNECTED){
-        server.handleClient(); // Processing requests from clients
-        vTaskDelay(pdMS_TO_TICKS(10));
-      }
     }
     vTaskDelay(pdMS_TO_TICKS(1000));
   }
   vTaskDelete(NULL);
 }
+
+// Serves the pages and the API on whichever link WS_Network made active (ETH first, WiFi as fallback)
+void WebServerTask(void *parameter) {
+  bool Started = false;
+  uint32_t Generation = 0;
+  server.on("/", handleRoot);            // Relay Control page
+  server.on("/getData", handleGetData);
+  server.on("/api/relay", handleRelayAPI);    // GET state / POST command
+  server.on("/api/events", handleEvents);     // State and time push (Server-Sent Events)
+  server.on("/api/trace", handleTraceAPI);    // Relay command latency histograms
+  server.on("/api/log", handleLogAPI);        // SD card audit log, list and export
+  
+  server.on("/RTC_Event", handleRTCPage);      // RTC Event page
+  server.on("/NewEvent" , handleNewEvent);
+  server.on("/getTimeAndEvent", handleUpTimeAndEvent);
+  server.on("/DeleteEvent", handleDeleteEvent);
+  
+  static const char *Header_Keys[] = {"If-None-Match"};
+  server.collectHeaders(Header_Keys, 1);
+  while(1){
+    if(!Network_Connected()){
+      vTaskDelay(pdMS_TO_TICKS(100));
+      continue;
+    }
+    if(!Started){
+      server.begin();                                 // Listens on every interface, a link switch does not need a restart
+      Started = true;
+      printf("Web server started\r\n"); 
+    }
+    if(Generation != Network_Generation()){
+      Generation = Network_Generation();
+      Web_Events_Close();                             // The streams of the old link are dead, the pages reconnect
+      printf("Web server on %s : http://%s/\r\n", Network_Link_Name(Network_Active()), ipStr);
+    }
+    server.handleClient(); // Processing requests from clients
+    Web_Events_Loop();
+    vTaskDelay(pdMS_TO_TICKS(Web_Loop_Delay_MS));
+  }
+  vTaskDelete(NULL);
+}
+void Web_Init(void)
+{
+  static bool Initialized = false;
+  if(Initialized)
+    return;
+  Initialized = true;
+  Network_Init();
+  Relay_Add_Listener(Web_Relay_Changed);
+  DIN_Add_Listener(Web_DIN_Changed);
+  Task_Start(Task_Web_Server, WebServerTask);
+}
 // String decoding
 bool parseData(const char* Text, datetime_t* dt, Status_adjustment* Relay_n, Repetition_event* cycleEvent) {    
   int ret;
@@ -10,24 +10,29 @@
 #include "WS_Information.h"
 #include "WS_Relay.h"
 #include "WS_RTC.h"
+#include "WS_DIN.h"
+#include "WS_Network.h"
+#include "WS_Pool.h"
+#include "WS_Tasks.h"
+#include "WS_SD_Log.h"
 
-extern char ipStr[16];
-extern bool WIFI_Connection;     
+#define Web_Event_Client_MAX  4        // Pages that can hold an /api/events stream at the same time
+#define Web_Loop_Delay_MS     2        // WebServerTask polls the listening socket this often (unit: ms)
+#define Web_Text_Size         200      // Request text and response bodies built by the handlers, from Pool_HTTP
+#define Web_Text_Count        2        // Handlers run one at a time in WebServerTask, one spare block
+
+extern bool WIFI_Connection;           // WiFi STA has an address, see WS_Network for the active link
 
 void handleRoot();
 void handleGetData();
-void handleSwitch(uint8_t ledNumber);
-
-void handleSwitch1();
-void handleSwitch2();
-void handleSwitch3();
-void handleSwitch4();
-void handleSwitch5();
-void handleSwitch6();
-void handleSwitch7();
-void handleSwitch8();
+void handleRelayAPI();                 // /api/relay
+void handleEvents();                   // /api/events
+void handleTraceAPI();                 // /api/trace
+void handleLogAPI();                   // /api/log
 void WIFI_Init();
 void WIFI_Loop();
 void WifiStaTask(void *parameter);
+void Web_Init(void);                   // Web server task, also started by WIFI_Init()
+void WebServerTask(void *parameter);
 
 bool parseData(const char* Text, datetime_t* dt, Status_adjustment* Relay, Repetition_event* cycleEvent) ;
\ No newline at end of file
@@ -0,0 +1,229 @@
+#pragma once
+
+// Generated by web/embed_pages.py from the pages in web/, do not edit by hand.
+// The pages are stored gzip compressed and sent as they are with "Content-Encoding: gzip".
+
+#include <stdint.h>
+#include <stddef.h>
+#include <pgmspace.h>
+
+#define Web_Page_Root_ETag   "\"0f818dbbfd1d9c86\""
+#define Web_Page_Root_Length 1818   // 7624 bytes before compression
+static const uint8_t Web_Page_Root[] PROGMEM = {
+  0x1F, 0x8B, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xED, 0x99, 0xCD, 0x6E, 0xDB, 0x46, 0x10, 0xC7, 0xEF, 0x79,
+  0x8A, 0x05, 0x03, 0x84, 0x14, 0x6C, 0xEA, 0x5B, 0xB2, 0xAC, 0x48, 0x2A, 0x1C, 0x5B, 0x40, 0x52, 0x18, 0xB1, 0x11, 0xFB,
+  0x52, 0x14, 0x45, 0xB1, 0x22, 0x97, 0xE2, 0xD6, 0x14, 0x97, 0x58, 0xAE, 0xFC, 0xD1, 0xC0, 0xF7, 0x3E, 0x41, 0x6F, 0x3D,
+  0xB4, 0x2F, 0xD0, 0x5E, 0x8A, 0x3C, 0x51, 0x8B, 0xE6, 0x2D, 0x3A, 0xBB, 0xA4, 0xF8, 0x25, 0x8A, 0xA6, 0x10, 0x14, 0xBE,
+  0xD4, 0x09, 0x2C, 0x8A, 0x5C, 0xFE, 0x77, 0xE6, 0x37, 0xB3, 0xB3, 0x43, 0x7A, 0xE2, 0x8A, 0x95, 0x37, 0x7B, 0x31, 0x71,
+  0x09, 0xB6, 0x67, 0x2F, 0x10, 0xFC, 0x4C, 0x56, 0x44, 0x60, 0x64, 0xB9, 0x98, 0x87, 0x44, 0x4C, 0xB5, 0xB5, 0x70, 0xCC,
+  0x91, 0x16, 0x5F, 0x12, 0x54, 0x78, 0x64, 0x36, 0xBF, 0xBA, 0xEC, 0x75, 0xCD, 0xAB, 0x9E, 0x79, 0x79, 0x31, 0x37, 0xE7,
+  0xD7, 0x6F, 0xCD, 0xD1, 0xD9, 0x3B, 0x73, 0xF4, 0xE1, 0x62, 0xD2, 0x8A, 0xAE, 0x47, 0x63, 0x43, 0xF1, 0xB0, 0x39, 0x96,
+  0x3F, 0x0B, 0x66, 0x3F, 0xA0, 0x8F, 0xC9, 0x57, 0xF9, 0xE3, 0x30, 0x5F, 0x98, 0x0E, 0x5E, 0x51, 0xEF, 0x61, 0x8C, 0x4E,
+  0x38, 0xC5, 0xDE, 0x21, 0x0A, 0xB1, 0x1F, 0x9A, 0x21, 0xE1, 0xD4, 0x79, 0x9D, 0x1B, 0xBB, 0xC0, 0xD6, 0xCD, 0x92, 0xB3,
+  0xB5, 0x6F, 0x9B, 0x16, 0xF3, 0x18, 0x1F, 0xA3, 0x97, 0x4E, 0x5B, 0xFE, 0xCB, 0x0F, 0x5B, 0x61, 0xBE, 0xA4, 0xFE, 0x18,
+  0x15, 0x4E, 0x07, 0xD8, 0xB6, 0xA9, 0xBF, 0xCC, 0x9D, 0x7F, 0x4C, 0x8E, 0x9A, 0xD2, 0x79, 0xC2, 0x0B, 0xD6, 0x09, 0x72,
+  0x2F, 0x4C, 0xEC, 0xD1, 0x25, 0xC8, 0x59, 0xC4, 0x17, 0x84, 0xEF, 0xD0, 0xEC, 0xB6, 0x83, 0xFB, 0xE2, 0x84, 0x25, 0xE6,
+  0xF6, 0x7A, 0xBD, 0xFC, 0x98, 0xC4, 0x0F, 0xC7, 0x29, 0x73, 0xC2, 0x5C, 0x30, 0x21, 0xD8, 0x2A, 0xD2, 0x2F, 0x35, 0xDB,
+  0x02, 0x7E, 0x98, 0xFA, 0x5B, 0x96, 0xAF, 0xF0, 0xBD, 0x79, 0x47, 0x6D, 0xE1, 0x8E, 0xD1, 0xB0, 0x9D, 0xBB, 0x39, 0x87,
+  0x08, 0xE1, 0xB5, 0x60, 0x15, 0x3E, 0x3D, 0x1D, 0x80, 0xA2, 0xE1, 0x0B, 0xC6, 0x81, 0xA3, 0xC9, 0xB1, 0x4D, 0xD7, 0xE1,
+  0x18, 0x0D, 0xB6, 0x34, 0xD8, 0xBD, 0x19, 0xBA, 0xD8, 0x66, 0x77, 0x72, 0xFA, 0xB6, 0x1C, 0x80, 0xF8, 0x72, 0x81, 0x8D,
+  0xF6, 0x21, 0x8A, 0xFF, 0x37, 0x7B, 0x8D, 0x52, 0x5F, 0xA9, 0x1F, 0xAC, 0x85, 0x99, 0xF1, 0xB8, 0xD5, 0xCA, 0x49, 0xDB,
+  0x34, 0x0C, 0x3C, 0x0C, 0x79, 0xE4, 0x78, 0xA4, 0x30, 0xAB, 0x8A, 0xA1, 0x49, 0x05, 0x59, 0x85, 0xE5, 0x91, 0x2C, 0xF0,
+  0xEE, 0xEC, 0xE2, 0x5D, 0xB4, 0xC1, 0xC3, 0x0B, 0xE2, 0x15, 0xD8, 0xC7, 0xDC, 0x47, 0x3B, 0xB0, 0x9B, 0x9C, 0x2E, 0x5D,
+  0xB1, 0xC7, 0x1C, 0xEA, 0xFB, 0xB7, 0xE2, 0x21, 0x20, 0x53, 0x4D, 0x66, 0xA4, 0xF6, 0x5D, 0x71, 0x11, 0x81, 0xBF, 0xA0,
+  0xB7, 0x23, 0x8E, 0x25, 0x21, 0x90, 0x21, 0x82, 0x1B, 0x00, 0x7D, 0xC8, 0x3C, 0x6A, 0xA3, 0x97, 0x96, 0x65, 0x55, 0x86,
+  0xB1, 0x57, 0xC3, 0x15, 0x54, 0xC7, 0x97, 0xC5, 0x1A, 0x00, 0xFB, 0x05, 0xFB, 0xB3, 0xA6, 0x16, 0xB0, 0x7C, 0xF1, 0x42,
+  0x52, 0x05, 0x26, 0xA4, 0x3F, 0x12, 0xB0, 0xB2, 0x5F, 0x54, 0x56, 0x17, 0xEF, 0x48, 0xE4, 0xC4, 0x82, 0x79, 0x76, 0x39,
+  0x28, 0x9F, 0xF9, 0x64, 0x3F, 0x3C, 0xAA, 0x70, 0x08, 0x0E, 0x85, 0xCC, 0x61, 0x1C, 0xF2, 0x69, 0x1D, 0x04, 0x84, 0x5B,
+  0x38, 0x2C, 0xC8, 0x58, 0x6B, 0x1E, 0x4A, 0xB3, 0x03, 0x46, 0xF3, 0x29, 0x99, 0x21, 0x18, 0x11, 0x33, 0x77, 0x2F, 0x74,
+  0x15, 0x08, 0xC1, 0x82, 0xB2, 0x15, 0x5B, 0x55, 0xC0, 0xAA, 0xE6, 0x28, 0x0D, 0x53, 0x5A, 0x35, 0xB6, 0x52, 0x2A, 0x89,
+  0xA0, 0x8C, 0x1E, 0xEA, 0x0C, 0xFE, 0x0F, 0x61, 0x0D, 0xBC, 0x63, 0x97, 0xDD, 0x6E, 0xC5, 0xB3, 0x84, 0xD4, 0x60, 0x30,
+  0x28, 0x93, 0xF5, 0xF1, 0xED, 0x8E, 0x00, 0x49, 0xFE, 0xC5, 0xDD, 0xA8, 0x5E, 0x26, 0x48, 0x4D, 0xBC, 0x6B, 0x75, 0xAA,
+  0xD8, 0x0E, 0xBE, 0x64, 0x79, 0xDE, 0xB9, 0x50, 0x82, 0x4B, 0xEC, 0xB2, 0x89, 0xC5, 0x38, 0x16, 0x14, 0x98, 0x94, 0x44,
+  0xAA, 0x56, 0x88, 0xCB, 0x77, 0x9C, 0x82, 0x67, 0x4D, 0x4E, 0x60, 0x83, 0x38, 0x05, 0x3D, 0xCE, 0xBC, 0x13, 0x4B, 0xD0,
+  0x5B, 0xF2, 0x34, 0xFE, 0xAD, 0x7C, 0xDC, 0xE9, 0x65, 0x7E, 0x6F, 0x83, 0x54, 0x45, 0xC3, 0xD2, 0xDD, 0x0D, 0x7E, 0xAB,
+  0xE2, 0xDB, 0x2B, 0xB9, 0xDA, 0x69, 0x14, 0xF8, 0xA4, 0x19, 0xA8, 0x0E, 0x3D, 0x2C, 0xC8, 0x37, 0x86, 0x09, 0xE2, 0x65,
+  0x03, 0x69, 0xC4, 0x10, 0x7B, 0x1E, 0x48, 0x75, 0x43, 0x44, 0x20, 0x5F, 0x4D, 0x28, 0x0F, 0x6C, 0x2D, 0x2A, 0xA0, 0x08,
+  0x6B, 0x7E, 0x0B, 0x29, 0x51, 0x17, 0x48, 0x49, 0x3E, 0x4E, 0x5A, 0x71, 0xAB, 0x37, 0x69, 0x45, 0x5D, 0xE4, 0x44, 0xF6,
+  0x7A, 0x9B, 0x2E, 0xD0, 0xE2, 0x34, 0x10, 0xC8, 0x26, 0x0E, 0xE1, 0x53, 0x4D, 0x7D, 0x68, 0x69, 0x53, 0xE8, 0xAC, 0x7D,
+  0x4B, 0x5A, 0x8D, 0x3C, 0x62, 0x5F, 0xDD, 0x51, 0x61, 0xB9, 0x06, 0x1C, 0xBD, 0x5F, 0xAF, 0x16, 0x84, 0x37, 0x0A, 0xC6,
+  0xDC, 0x62, 0x0E, 0xF4, 0x57, 0x2B, 0xEC, 0x17, 0x72, 0x80, 0x3A, 0x28, 0xBD, 0x0B, 0x4D, 0xD0, 0x31, 0x7A, 0xF5, 0x0A,
+  0xA5, 0x27, 0x66, 0xA8, 0x5D, 0x94, 0x8A, 0x02, 0xA9, 0xA4, 0xD0, 0x14, 0x7D, 0x44, 0x82, 0x2D, 0x97, 0x9E, 0xAC, 0x30,
+  0x68, 0x32, 0xC9, 0x6A, 0x99, 0xA8, 0xD3, 0x40, 0x8F, 0xF9, 0xD9, 0x1E, 0x73, 0xDF, 0x88, 0x17, 0x92, 0x82, 0x01, 0xD3,
+  0x29, 0x3A, 0x7E, 0x6A, 0x42, 0x1B, 0x0B, 0x3C, 0x86, 0xCF, 0x93, 0xF3, 0x73, 0x39, 0xEB, 0x63, 0x8D, 0x49, 0xF6, 0x10,
+  0x6C, 0x3F, 0x25, 0xE8, 0x10, 0x49, 0x5A, 0x6F, 0xE1, 0x80, 0xB6, 0xD4, 0xAA, 0xD0, 0x0F, 0x4B, 0xF4, 0xE1, 0x39, 0xC0,
+  0x65, 0xF6, 0x18, 0xE9, 0x97, 0x17, 0x57, 0xD7, 0xFA, 0xE1, 0xD6, 0xF5, 0xA8, 0x6B, 0x0E, 0xE5, 0xB4, 0xBA, 0x5C, 0x56,
+  0x90, 0x45, 0xE6, 0x35, 0x34, 0x2A, 0x3A, 0xDC, 0x82, 0x83, 0xC0, 0xA3, 0x96, 0x5A, 0xD5, 0xAD, 0x1F, 0x42, 0xE6, 0xEB,
+  0xE8, 0x71, 0x5B, 0x40, 0xA6, 0xC9, 0x18, 0x7D, 0x7D, 0x75, 0xF1, 0xBE, 0x19, 0x0A, 0x0E, 0x65, 0x86, 0x3A, 0x0F, 0x46,
+  0xEC, 0x55, 0x23, 0x6F, 0x7E, 0xA3, 0x29, 0x5C, 0xE2, 0x1B, 0x9B, 0x7C, 0x31, 0x38, 0x09, 0x03, 0xE6, 0x87, 0xA4, 0x0C,
+  0xB4, 0x0C, 0xC7, 0xE6, 0x7A, 0x93, 0xDD, 0x94, 0x0D, 0x89, 0xF0, 0xF9, 0xD0, 0x00, 0x91, 0xA6, 0xC7, 0x96, 0x86, 0x7E,
+  0x3E, 0x3F, 0x43, 0x3A, 0x3A, 0xC8, 0xA4, 0xCD, 0x01, 0x7C, 0x0F, 0x05, 0x2C, 0x38, 0xF9, 0x28, 0xE4, 0x2F, 0x89, 0xAD,
+  0x17, 0xD6, 0xDC, 0x36, 0xD6, 0xC7, 0xD2, 0xD6, 0x35, 0xC9, 0xF1, 0xD0, 0x65, 0x77, 0x57, 0x52, 0xD1, 0x50, 0xBA, 0x8D,
+  0xAD, 0xA7, 0x21, 0x8E, 0x0C, 0x99, 0xE4, 0x14, 0x22, 0xDA, 0x79, 0x0D, 0x1F, 0x93, 0x29, 0x1A, 0xC1, 0xE7, 0xC1, 0x41,
+  0x99, 0x0B, 0x36, 0xB3, 0xD6, 0x2B, 0x40, 0xDE, 0x5C, 0x12, 0x31, 0xF7, 0x88, 0x3C, 0x7C, 0xF3, 0xF0, 0xCE, 0x36, 0x74,
+  0xCB, 0x95, 0x8E, 0xD0, 0x46, 0xF3, 0x16, 0x7B, 0x6B, 0x02, 0x5A, 0xD1, 0x74, 0x51, 0xF9, 0x43, 0xB3, 0x19, 0x32, 0xA8,
+  0x4A, 0xEC, 0x06, 0x7A, 0x55, 0x6C, 0x1B, 0x2B, 0x75, 0x17, 0xC2, 0x8F, 0x85, 0x39, 0x59, 0xC1, 0xE6, 0x75, 0x22, 0x20,
+  0x66, 0xB0, 0x99, 0x11, 0x43, 0x87, 0xE6, 0x1B, 0x2F, 0xBC, 0x6D, 0x44, 0x79, 0x3C, 0x55, 0xCA, 0xC7, 0xFA, 0x1E, 0xB2,
+  0x55, 0x42, 0xED, 0xBA, 0x42, 0x25, 0x01, 0x5A, 0x07, 0xB0, 0x8C, 0xC8, 0x19, 0x2C, 0x25, 0x63, 0x2B, 0x38, 0x5B, 0x2B,
+  0x66, 0x9F, 0x8C, 0xE4, 0x44, 0xAC, 0xB9, 0x8F, 0x92, 0xA4, 0x94, 0x2B, 0xC2, 0x28, 0xB2, 0x8A, 0x05, 0x93, 0x2C, 0xA9,
+  0xB6, 0x95, 0x05, 0xC4, 0x57, 0x85, 0x3B, 0x34, 0xCA, 0x0A, 0x65, 0xC8, 0xD6, 0xDC, 0x92, 0xC1, 0xF7, 0xC9, 0x1D, 0x52,
+  0xE3, 0xAE, 0xD4, 0x99, 0xD8, 0x05, 0xA2, 0xEE, 0x2C, 0x72, 0x8D, 0x6E, 0x6A, 0xC2, 0x96, 0xAF, 0xEE, 0x38, 0xA7, 0x21,
+  0xAC, 0x69, 0xC2, 0x0D, 0x5D, 0x25, 0x10, 0xD4, 0x88, 0xC4, 0x59, 0x75, 0x7F, 0x99, 0xA7, 0x69, 0x8E, 0xAB, 0x65, 0x1D,
+  0xC8, 0x97, 0x08, 0xD1, 0xE8, 0xA6, 0x2C, 0x51, 0x8D, 0x2D, 0xA7, 0x4B, 0x2D, 0x80, 0x2E, 0x80, 0x73, 0x58, 0x0E, 0xD3,
+  0x74, 0xC6, 0x5D, 0x0B, 0x3D, 0xBE, 0x83, 0x43, 0x2D, 0x7A, 0x50, 0x13, 0xCB, 0xFA, 0x9B, 0x71, 0xB8, 0x79, 0x7A, 0x7E,
+  0x71, 0x35, 0x3F, 0xDB, 0x55, 0x04, 0x42, 0x22, 0xAE, 0xE9, 0x8A, 0xC0, 0x16, 0x69, 0xA4, 0x44, 0x0F, 0xA1, 0xD1, 0x69,
+  0xB7, 0x9F, 0x5E, 0xEE, 0x95, 0x01, 0x8A, 0x1F, 0x48, 0xE7, 0xD2, 0x91, 0x6B, 0xE8, 0x73, 0xDE, 0xB0, 0x7B, 0x15, 0xDB,
+  0xBC, 0x25, 0x32, 0x56, 0x64, 0x33, 0x04, 0x5A, 0x08, 0x70, 0x79, 0x67, 0x76, 0x67, 0xC7, 0xE5, 0x43, 0x97, 0xBD, 0xD2,
+  0x54, 0x9B, 0x71, 0x33, 0x9E, 0x1E, 0xF4, 0xE4, 0xA4, 0xE8, 0x2B, 0xA4, 0x2F, 0x3C, 0x66, 0xDD, 0xE8, 0x08, 0x8A, 0xB3,
+  0xEC, 0xB2, 0xF4, 0x4A, 0xE3, 0x21, 0x53, 0x61, 0xF2, 0xAC, 0xE9, 0x79, 0xB3, 0x6B, 0xDA, 0x98, 0x94, 0x20, 0xBD, 0x74,
+  0xBA, 0xEC, 0x7A, 0x4B, 0xAF, 0x67, 0x33, 0xFB, 0xF5, 0xA6, 0xC1, 0x50, 0x5D, 0x44, 0xDC, 0x52, 0xD8, 0xF4, 0x16, 0x59,
+  0x1E, 0x0E, 0xC3, 0xA9, 0x16, 0x6D, 0x41, 0x99, 0x86, 0x62, 0xE2, 0x76, 0x2A, 0x5E, 0x4F, 0xC1, 0xC5, 0x58, 0x10, 0x34,
+  0xE2, 0x43, 0x68, 0x83, 0x32, 0xB7, 0x63, 0xE4, 0x72, 0xE2, 0x4C, 0xB5, 0x96, 0x86, 0xA8, 0x3D, 0xD5, 0xB2, 0x2D, 0xE3,
+  0x39, 0xF5, 0x6F, 0xB4, 0xCD, 0xC4, 0xDB, 0xBD, 0xA4, 0x36, 0xFB, 0xA0, 0x0A, 0x6C, 0x7C, 0x72, 0xD2, 0xC2, 0x65, 0xB2,
+  0x1F, 0xAE, 0x4F, 0xBF, 0x57, 0xCE, 0xC5, 0xFA, 0x71, 0xF7, 0x95, 0xD7, 0xCE, 0xB5, 0x64, 0xA0, 0x7B, 0x7D, 0x1A, 0x65,
+  0x74, 0xA2, 0x39, 0x69, 0x25, 0x56, 0x67, 0x69, 0x24, 0xCF, 0x18, 0x59, 0x20, 0x99, 0xEB, 0x85, 0xE7, 0x71, 0x0D, 0xA9,
+  0x54, 0x99, 0x6A, 0xF1, 0x63, 0xA4, 0x47, 0x1C, 0xF9, 0x38, 0xDF, 0x97, 0x4D, 0x7E, 0x46, 0x41, 0xA9, 0x44, 0xAF, 0x3A,
+  0x60, 0x8B, 0x8A, 0x55, 0x3A, 0xDA, 0xEC, 0xF4, 0x6D, 0x67, 0xD2, 0x52, 0xE7, 0x0B, 0x63, 0xD5, 0x00, 0x94, 0x79, 0x65,
+  0xA1, 0x5C, 0xB5, 0xDC, 0x8E, 0x86, 0x5A, 0x85, 0xA1, 0xF1, 0xA3, 0xA6, 0x4A, 0x93, 0xA9, 0x16, 0x75, 0x80, 0x9D, 0x68,
+  0x3C, 0xD4, 0x72, 0x38, 0xDA, 0x54, 0x6E, 0xC4, 0x7C, 0x0B, 0x1A, 0x8A, 0x9B, 0xA9, 0x96, 0x76, 0x8A, 0x9D, 0x86, 0x36,
+  0x7B, 0x13, 0x09, 0x80, 0x25, 0x91, 0x54, 0xC6, 0xF1, 0x34, 0xC6, 0xFF, 0x21, 0x87, 0xAE, 0xE4, 0xD0, 0xDD, 0x8F, 0x43,
+  0xB7, 0x1E, 0x87, 0x6E, 0xC2, 0xA1, 0x5B, 0xCD, 0xA1, 0x9B, 0x72, 0xE8, 0x3E, 0x17, 0x87, 0x9E, 0xE4, 0xD0, 0xDB, 0x8F,
+  0x43, 0xAF, 0x1E, 0x87, 0x5E, 0xC2, 0xA1, 0x57, 0xCD, 0xA1, 0x97, 0x72, 0xE8, 0x3D, 0x17, 0x87, 0xBE, 0xE4, 0xD0, 0xDF,
+  0x8F, 0x43, 0xBF, 0x1E, 0x87, 0x7E, 0xC2, 0xA1, 0x5F, 0xCD, 0xA1, 0x9F, 0x72, 0xE8, 0x3F, 0x17, 0x87, 0x81, 0xE4, 0x30,
+  0xD8, 0x8F, 0xC3, 0xA0, 0x1E, 0x87, 0x41, 0xC2, 0x61, 0x50, 0xCD, 0x61, 0x90, 0x72, 0x18, 0x3C, 0x17, 0x87, 0xA1, 0xE4,
+  0x30, 0xDC, 0x8F, 0xC3, 0xB0, 0x1E, 0x87, 0x61, 0xC2, 0x61, 0x58, 0xCD, 0x61, 0x98, 0x72, 0x18, 0x3E, 0x17, 0x87, 0x23,
+  0xC9, 0xE1, 0x68, 0x3F, 0x0E, 0x47, 0xF5, 0x38, 0x1C, 0x25, 0x1C, 0x8E, 0xAA, 0x39, 0x1C, 0xA5, 0x1C, 0x8E, 0x9E, 0x8B,
+  0xC3, 0x48, 0x72, 0x18, 0xED, 0xC7, 0x61, 0x54, 0x8F, 0xC3, 0x28, 0xE1, 0x30, 0xAA, 0xE6, 0x30, 0x4A, 0x39, 0x8C, 0xF6,
+  0xE2, 0x50, 0x7C, 0x95, 0xA9, 0x55, 0x5A, 0x75, 0xE2, 0x79, 0x17, 0x7E, 0x62, 0xD3, 0x71, 0xB5, 0x4D, 0xC7, 0x60, 0x13,
+  0xDC, 0x80, 0x2E, 0xFC, 0x6D, 0x8B, 0x76, 0x68, 0x3B, 0x4E, 0x22, 0xDE, 0xAE, 0x16, 0x6F, 0x6F, 0xC4, 0x1D, 0xA7, 0x9E,
+  0xBF, 0x52, 0x36, 0xDB, 0xC9, 0x26, 0x11, 0x4F, 0xFE, 0xCA, 0xA4, 0x5E, 0x54, 0x6A, 0x33, 0x94, 0x37, 0x32, 0x98, 0xCD,
+  0xFD, 0xA5, 0x47, 0x43, 0x77, 0x7C, 0xE9, 0xC9, 0xB7, 0x6F, 0xD0, 0x47, 0x3B, 0xD0, 0x4A, 0xBB, 0x08, 0x9E, 0xEC, 0x50,
+  0x80, 0x97, 0x64, 0xD2, 0x0A, 0x66, 0xC5, 0x5B, 0x4E, 0x5D, 0x60, 0x19, 0x92, 0xF1, 0x3F, 0xBF, 0x7F, 0xFA, 0xEB, 0xA7,
+  0x4F, 0x7F, 0xFF, 0xFC, 0xC7, 0xE7, 0x5F, 0xFF, 0xFC, 0xFC, 0xCB, 0x6F, 0xB9, 0xA1, 0xD9, 0x86, 0x35, 0x3A, 0x04, 0x47,
+  0xD4, 0x4B, 0x36, 0x68, 0x6A, 0xD5, 0x1F, 0x70, 0xFF, 0x05, 0x86, 0xAC, 0x8E, 0x13, 0xC8, 0x1D, 0x00, 0x00,
+};
+
+#define Web_Page_RTC_ETag   "\"11f56b11b0156c15\""
+#define Web_Page_RTC_Length 2400   // 11799 bytes before compression
+static const uint8_t Web_Page_RTC[] PROGMEM = {
+  0x1F, 0x8B, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xED, 0x5A, 0x5B, 0x6F, 0xE3, 0xC6, 0x15, 0x7E, 0xDF, 0x5F,
+  0x31, 0x65, 0xD0, 0x15, 0x0D, 0x9B, 0xBA, 0x50, 0x96, 0x6D, 0xE8, 0x16, 0xEC, 0xDA, 0x6E, 0xBD, 0x85, 0x77, 0x1D, 0xD8,
+  0x06, 0xB6, 0x45, 0x53, 0x14, 0x23, 0x72, 0x64, 0x4D, 0x4D, 0x91, 0x2C, 0x39, 0xB4, 0xAC, 0x16, 0x1B, 0xE4, 0x25, 0x68,
+  0x03, 0x34, 0x08, 0x8A, 0xB6, 0xD8, 0x16, 0x49, 0x91, 0x3E, 0xA4, 0x40, 0xFB, 0x10, 0xE4, 0xA1, 0x2F, 0x45, 0x51, 0xA0,
+  0x7F, 0x26, 0xBB, 0x45, 0xFE, 0x45, 0xCF, 0xCC, 0x90, 0x12, 0x49, 0x0D, 0x45, 0x6A, 0x77, 0xD3, 0x87, 0xBA, 0xF2, 0x42,
+  0xD2, 0x92, 0xE7, 0x7C, 0xE7, 0x7E, 0x66, 0xE6, 0x50, 0xFD, 0x09, 0x9B, 0x3A, 0xC3, 0x7B, 0xFD, 0x09, 0xC1, 0xF6, 0xF0,
+  0x1E, 0x82, 0x57, 0x7F, 0x4A, 0x18, 0x46, 0xD6, 0x04, 0x07, 0x21, 0x61, 0x03, 0x2D, 0x62, 0x63, 0xE3, 0x40, 0x8B, 0x6F,
+  0x31, 0xCA, 0x1C, 0x32, 0x3C, 0xBE, 0x78, 0xA7, 0x6D, 0x1A, 0x17, 0x6D, 0xE3, 0x9D, 0xB3, 0x63, 0xE3, 0xF8, 0xF2, 0xC4,
+  0x38, 0x38, 0x7A, 0x64, 0x1C, 0x9C, 0x9F, 0xF5, 0x1B, 0xF2, 0xBE, 0xA4, 0x0D, 0xD9, 0x3C, 0xF9, 0xCE, 0x5F, 0x23, 0xCF,
+  0x9E, 0xA3, 0x9F, 0x2F, 0xFE, 0xCB, 0x5F, 0x63, 0xCF, 0x65, 0xC6, 0x18, 0x4F, 0xA9, 0x33, 0xEF, 0xA2, 0x07, 0x01, 0xC5,
+  0xCE, 0x0E, 0x0A, 0xB1, 0x1B, 0x1A, 0x21, 0x09, 0xE8, 0xB8, 0x97, 0xA1, 0x1D, 0x61, 0xEB, 0xFA, 0x2A, 0xF0, 0x22, 0xD7,
+  0x36, 0x2C, 0xCF, 0xF1, 0x82, 0x2E, 0x7A, 0x6B, 0xDC, 0xE4, 0x7F, 0x59, 0xB2, 0x29, 0x0E, 0xAE, 0xA8, 0xDB, 0x45, 0xB9,
+  0xCB, 0x3E, 0xB6, 0x6D, 0xEA, 0x5E, 0x65, 0xAE, 0x3F, 0x5B, 0x7C, 0xAB, 0x73, 0xE3, 0x49, 0x90, 0xD3, 0x8E, 0x91, 0x5B,
+  0x66, 0x60, 0x87, 0x5E, 0x01, 0x9C, 0x45, 0x5C, 0x46, 0x82, 0x02, 0x4C, 0xB3, 0xE9, 0xDF, 0xE6, 0x05, 0x2A, 0xD4, 0x6D,
+  0xB7, 0xDB, 0x59, 0x9A, 0x85, 0x1D, 0xE3, 0xB1, 0xCA, 0x08, 0x63, 0xE4, 0x31, 0xE6, 0x4D, 0x25, 0xBE, 0x52, 0x6D, 0x0B,
+  0xFC, 0x87, 0xA9, 0xBB, 0xA2, 0xF9, 0x14, 0xDF, 0x1A, 0x33, 0x6A, 0xB3, 0x49, 0x17, 0xED, 0x35, 0x33, 0xCC, 0x69, 0x17,
+  0xB5, 0xB8, 0xDA, 0x38, 0x62, 0xDE, 0x1A, 0xB3, 0xCA, 0x63, 0x90, 0xD7, 0x7D, 0xE4, 0x05, 0xE0, 0x4A, 0x23, 0xC0, 0x36,
+  0x8D, 0xC2, 0x2E, 0xEA, 0xAC, 0x60, 0x78, 0xB7, 0x46, 0x38, 0xC1, 0xB6, 0x37, 0x83, 0x60, 0xC0, 0x1F, 0x10, 0xA0, 0xE0,
+  0x6A, 0x84, 0xF5, 0xE6, 0x0E, 0x8A, 0xFF, 0xD5, 0xDB, 0x5B, 0x4A, 0x73, 0xC7, 0x5E, 0x30, 0x35, 0xB8, 0x7C, 0x7F, 0xC5,
+  0xDE, 0x8C, 0xBF, 0x5A, 0x9D, 0x02, 0x7F, 0xA5, 0x00, 0x1C, 0x3C, 0x22, 0x4E, 0x0E, 0xC6, 0xA6, 0xA1, 0xEF, 0x60, 0x48,
+  0xC5, 0x91, 0xE3, 0x59, 0xD7, 0xBD, 0xD5, 0x54, 0x9D, 0x11, 0x7A, 0x35, 0x61, 0x70, 0xDF, 0x73, 0xEC, 0x32, 0x01, 0xD4,
+  0xF5, 0x23, 0x96, 0x13, 0x10, 0xC7, 0xE4, 0x60, 0xC5, 0xB1, 0x93, 0x18, 0xD8, 0x5C, 0x71, 0xD7, 0x22, 0x1A, 0xBB, 0xEA,
+  0x30, 0x1A, 0xCC, 0xF3, 0x95, 0x5E, 0xE6, 0x51, 0x00, 0x57, 0x80, 0x77, 0x43, 0xCF, 0xA1, 0x36, 0x7A, 0xCB, 0xB6, 0xED,
+  0xB5, 0x91, 0xDA, 0x55, 0x46, 0x8A, 0xFE, 0x4C, 0x48, 0x8F, 0x69, 0xE1, 0x52, 0xAF, 0xB0, 0x46, 0x02, 0x6E, 0x43, 0x0F,
+  0x95, 0xF8, 0x25, 0x24, 0x0E, 0xB1, 0xFE, 0xEF, 0x98, 0x55, 0xC7, 0xD4, 0x47, 0xCC, 0xCD, 0xB9, 0x65, 0x61, 0xA3, 0x28,
+  0xD5, 0x4A, 0xF5, 0x58, 0xD4, 0x64, 0x66, 0x13, 0xCA, 0x88, 0xDA, 0x15, 0xAE, 0xE7, 0x92, 0xCD, 0x6A, 0xD8, 0x8A, 0x82,
+  0x90, 0x83, 0xFA, 0x1E, 0xCD, 0xB6, 0xC5, 0x62, 0xCB, 0xBA, 0x13, 0xEF, 0x66, 0xA5, 0x4F, 0x29, 0xF4, 0xEF, 0x74, 0x3A,
+  0x4A, 0xB8, 0xE3, 0x1B, 0xE8, 0xC0, 0xA1, 0x62, 0xF9, 0x80, 0x40, 0x10, 0x70, 0x50, 0x3B, 0xAF, 0xE3, 0x0C, 0x6C, 0x30,
+  0x66, 0x01, 0x86, 0x24, 0x18, 0x05, 0x04, 0x5F, 0x1B, 0xFC, 0x42, 0x96, 0x84, 0x6B, 0x34, 0x76, 0xBC, 0x59, 0x09, 0x59,
+  0xAA, 0x9B, 0xB6, 0x9A, 0xCD, 0x6F, 0xE7, 0xC4, 0x70, 0xBF, 0x1A, 0xA1, 0x8F, 0x2D, 0xC2, 0x3D, 0xC9, 0x91, 0x8A, 0xDA,
+  0x69, 0x41, 0x53, 0x92, 0x96, 0xA1, 0x51, 0x04, 0xCD, 0x2B, 0x9F, 0x00, 0xA0, 0x1D, 0x66, 0x49, 0x02, 0xA9, 0x92, 0xDC,
+  0x21, 0x63, 0x26, 0x92, 0x79, 0x1D, 0xB4, 0x43, 0x51, 0x45, 0xC7, 0x2D, 0x79, 0x5D, 0x7C, 0xA3, 0x6C, 0xB2, 0xB2, 0xBB,
+  0xE6, 0x57, 0xBB, 0x75, 0x4B, 0x65, 0x16, 0x13, 0xAF, 0x4D, 0xF1, 0xCE, 0x1B, 0x4E, 0x71, 0xA1, 0x97, 0x4D, 0x2C, 0x2F,
+  0xC0, 0x8C, 0x7A, 0xAE, 0x2A, 0xD7, 0xD7, 0x34, 0xF6, 0xB2, 0x52, 0xC8, 0x59, 0x56, 0x0F, 0x08, 0xAC, 0x1E, 0x87, 0x80,
+  0x17, 0x78, 0xCE, 0x03, 0x8B, 0xD1, 0x1B, 0xF2, 0xCA, 0xF9, 0x1E, 0x03, 0x32, 0x4B, 0x84, 0xB0, 0x2A, 0xD8, 0xCA, 0x62,
+  0x5C, 0xE8, 0xB2, 0xEC, 0x2A, 0x0C, 0x1D, 0x0E, 0xED, 0x29, 0xD7, 0x61, 0x78, 0x17, 0xAD, 0xB2, 0xAD, 0xB8, 0xDB, 0xDA,
+  0xCA, 0x39, 0x3B, 0x80, 0xAD, 0x1B, 0x2F, 0xFB, 0xAE, 0xFC, 0xEA, 0x60, 0x46, 0x7E, 0xA0, 0x1B, 0x00, 0xAE, 0x22, 0xA4,
+  0x32, 0x20, 0xD8, 0x71, 0x00, 0xCA, 0x0C, 0x11, 0xC1, 0x21, 0x31, 0x20, 0xA3, 0xBD, 0x88, 0xE5, 0x1D, 0xD2, 0x6F, 0xC4,
+  0x5B, 0xC9, 0x7E, 0x43, 0xEE, 0x52, 0xFB, 0x7C, 0x2F, 0x99, 0xEC, 0x32, 0xAD, 0x80, 0xFA, 0x0C, 0xD9, 0x64, 0x4C, 0x82,
+  0x81, 0x26, 0x3E, 0xB4, 0xE5, 0xA6, 0x73, 0x1C, 0xB9, 0x16, 0x17, 0x84, 0xAE, 0x08, 0x3B, 0x8F, 0xBD, 0x79, 0x84, 0x19,
+  0xD6, 0xB7, 0x72, 0xDE, 0xBC, 0xC1, 0x01, 0xB2, 0x41, 0xE1, 0x87, 0xDE, 0x6D, 0x0B, 0x0D, 0x90, 0xED, 0x59, 0xD1, 0x14,
+  0x68, 0xEB, 0xC0, 0x77, 0xEC, 0x10, 0xFE, 0xF5, 0xE1, 0xFC, 0x91, 0xAD, 0xD7, 0x8E, 0x62, 0x9A, 0xDA, 0x56, 0xFD, 0x06,
+  0x3B, 0x51, 0x2E, 0x99, 0x52, 0x28, 0x66, 0x05, 0x14, 0xB3, 0x14, 0xA5, 0x5D, 0x01, 0xA5, 0x5D, 0x8C, 0x32, 0x23, 0xE4,
+  0x7A, 0x1D, 0xC2, 0x53, 0xB8, 0x5F, 0xCC, 0xCD, 0xE8, 0xB4, 0xD4, 0x1F, 0x97, 0x31, 0x4D, 0x29, 0x8A, 0x59, 0x01, 0xC5,
+  0x2C, 0x45, 0x69, 0x57, 0x40, 0x59, 0xE3, 0x0F, 0x59, 0xA1, 0x27, 0x6B, 0x2D, 0x3A, 0x8F, 0x69, 0x4A, 0x51, 0xCC, 0x0A,
+  0x28, 0x66, 0x29, 0x4A, 0xBB, 0x02, 0x4A, 0xB9, 0x45, 0xBB, 0x15, 0x50, 0x76, 0x4B, 0x51, 0x3A, 0x15, 0x50, 0x3A, 0xA5,
+  0x28, 0x7B, 0x15, 0x50, 0xF6, 0x4A, 0x51, 0xF6, 0x2B, 0xA0, 0xEC, 0x97, 0xA2, 0x1C, 0x54, 0x40, 0x39, 0x28, 0x46, 0xB1,
+  0xE6, 0x96, 0xC3, 0x53, 0x6A, 0x1D, 0xCA, 0x61, 0x4C, 0x53, 0x8C, 0xF2, 0x94, 0x8C, 0x78, 0xCF, 0x01, 0x90, 0xCC, 0x2D,
+  0xFE, 0x12, 0x35, 0xDC, 0x45, 0x35, 0xB4, 0xBD, 0xEC, 0x3E, 0xDB, 0xA8, 0xD6, 0x48, 0x5D, 0x30, 0xF3, 0x17, 0xDA, 0xFC,
+  0x02, 0x12, 0x3C, 0xB5, 0x77, 0x5D, 0xFE, 0xB1, 0x0A, 0xCB, 0x0B, 0x5B, 0xC2, 0x8A, 0x16, 0x50, 0xCE, 0xC0, 0x6B, 0x47,
+  0x32, 0x2C, 0xAA, 0x1E, 0xA8, 0xBB, 0xA9, 0x0B, 0x66, 0xFE, 0x02, 0xD7, 0xA3, 0x14, 0x57, 0xF8, 0x18, 0x41, 0x39, 0x49,
+  0xF0, 0x45, 0x01, 0x6E, 0x57, 0xE6, 0x34, 0x33, 0x9C, 0xE6, 0x06, 0x9C, 0xED, 0x0C, 0x67, 0x7B, 0x03, 0xCE, 0xDD, 0x0C,
+  0xE7, 0xEE, 0x06, 0x9C, 0x9D, 0x0C, 0x67, 0x67, 0x03, 0xCE, 0xBD, 0x0C, 0xE7, 0xDE, 0x06, 0x9C, 0xFB, 0x19, 0xCE, 0xFD,
+  0x0D, 0x38, 0x0F, 0x32, 0x9C, 0x07, 0x15, 0x38, 0x45, 0xB6, 0x4B, 0xAE, 0x45, 0x71, 0x64, 0xB9, 0x56, 0xF3, 0xFF, 0x76,
+  0x12, 0x40, 0xEE, 0xBB, 0x64, 0x86, 0xBE, 0xFF, 0xF8, 0xF4, 0x84, 0x31, 0xFF, 0x9C, 0xFC, 0x34, 0x22, 0x21, 0xD3, 0x73,
+  0xFB, 0x02, 0xA0, 0xAB, 0x7B, 0x3E, 0x71, 0xF5, 0xDA, 0x77, 0x8F, 0x2F, 0x6B, 0x3B, 0x90, 0xF5, 0x4F, 0xC8, 0x4C, 0x2C,
+  0xD9, 0x6F, 0x43, 0xEA, 0xE3, 0x01, 0x17, 0x11, 0xD7, 0xD2, 0x0E, 0x6C, 0x22, 0x22, 0xA2, 0xE0, 0x0F, 0x89, 0x6B, 0xEB,
+  0xCA, 0xF1, 0xC1, 0x62, 0x2B, 0x60, 0xC3, 0x09, 0x94, 0x11, 0x81, 0xAB, 0x13, 0xFE, 0xFE, 0xC8, 0x56, 0xED, 0x06, 0xAA,
+  0x6A, 0xCD, 0x69, 0x8F, 0x25, 0x0C, 0xD0, 0xC7, 0x80, 0x65, 0x86, 0x1D, 0x2D, 0x75, 0x78, 0x9B, 0xDA, 0xC2, 0xB2, 0x18,
+  0xE3, 0x75, 0x2C, 0x8B, 0x7C, 0xDE, 0x22, 0x4E, 0x29, 0x28, 0xC9, 0x1D, 0xA6, 0xB2, 0xCA, 0x81, 0x9B, 0x6B, 0xBA, 0x99,
+  0x36, 0x9D, 0x73, 0x76, 0x2D, 0x27, 0x9F, 0x73, 0xD5, 0xA9, 0xEB, 0x92, 0xE0, 0xE4, 0xF2, 0xF1, 0x29, 0xF0, 0xD7, 0x6A,
+  0x3D, 0x94, 0xDB, 0x46, 0x07, 0x48, 0x07, 0x9B, 0x10, 0x85, 0xBB, 0xCD, 0x1E, 0x7C, 0xF4, 0x79, 0xBF, 0xC2, 0x75, 0xE1,
+  0x90, 0x43, 0xD8, 0xA6, 0xC2, 0x09, 0x98, 0x6E, 0x6F, 0xE7, 0x75, 0x4A, 0xF4, 0x02, 0x3F, 0x3F, 0x62, 0x64, 0x9A, 0x56,
+  0xCD, 0x82, 0xF3, 0x18, 0xF8, 0x48, 0x6A, 0xA7, 0x6B, 0x0E, 0xCD, 0x6B, 0x95, 0xF0, 0xC6, 0x22, 0xE0, 0xD8, 0xE1, 0x0A,
+  0xDB, 0x40, 0xEC, 0x0F, 0x35, 0x71, 0xF1, 0x82, 0x05, 0x1A, 0xB8, 0x56, 0xA7, 0xF0, 0xD6, 0xDA, 0xFA, 0x11, 0xEC, 0xD0,
+  0x7D, 0x07, 0x4E, 0x6A, 0x7A, 0xE3, 0x5D, 0xB7, 0x71, 0xB5, 0x83, 0xB4, 0xFE, 0x28, 0x18, 0xAA, 0x50, 0x63, 0x6D, 0x32,
+  0x26, 0xA7, 0xA5, 0xAC, 0xD1, 0xE3, 0xA1, 0x3C, 0xC7, 0x15, 0xDB, 0x21, 0x0F, 0x7A, 0x2A, 0xA9, 0x29, 0xFE, 0x3A, 0x3F,
+  0xB9, 0x2C, 0x4D, 0xD2, 0x64, 0xBE, 0x70, 0x5B, 0x34, 0x91, 0x27, 0x29, 0xAB, 0xD6, 0xE3, 0x78, 0xAE, 0xE5, 0x50, 0x8B,
+  0x6F, 0x02, 0x93, 0x2C, 0xD1, 0x55, 0x21, 0x10, 0xE3, 0xAF, 0x54, 0x5D, 0xD0, 0x6D, 0x15, 0xF0, 0xB3, 0x62, 0x4F, 0x89,
+  0x1D, 0x7A, 0x3D, 0x9E, 0xA0, 0xF1, 0x04, 0x19, 0x3B, 0xE4, 0xB6, 0x56, 0x46, 0xFF, 0x93, 0x28, 0x64, 0x74, 0x3C, 0x5F,
+  0x1A, 0x5A, 0x13, 0x27, 0x69, 0x63, 0x44, 0x18, 0xAC, 0x5B, 0x6E, 0x29, 0xBF, 0x38, 0x72, 0xF2, 0xFF, 0x87, 0x9C, 0x57,
+  0x9E, 0x3C, 0xD7, 0x30, 0x61, 0x1F, 0x8A, 0xD0, 0x3E, 0x9C, 0x50, 0xC7, 0xD6, 0x53, 0x4E, 0x52, 0x58, 0x2A, 0x12, 0x3E,
+  0x4D, 0x1E, 0x43, 0xE4, 0x48, 0x9F, 0x29, 0xAA, 0x71, 0x91, 0x09, 0xE7, 0xE4, 0x86, 0x86, 0x54, 0xE4, 0x82, 0xD1, 0xEA,
+  0xA9, 0xAA, 0x95, 0x2F, 0xBA, 0xFA, 0xEB, 0xF4, 0x9E, 0xD5, 0xC6, 0x02, 0xF5, 0xCC, 0x51, 0x1F, 0xB8, 0xB6, 0x08, 0x64,
+  0x2D, 0x69, 0x27, 0x68, 0x95, 0xCF, 0x85, 0xBC, 0xB4, 0xE7, 0x21, 0x83, 0xE4, 0xB4, 0x26, 0xD8, 0xBD, 0x22, 0x65, 0x49,
+  0x42, 0xC7, 0x48, 0xE7, 0x9C, 0x82, 0xEF, 0x82, 0xF3, 0xA1, 0xC1, 0x60, 0x80, 0x76, 0xD1, 0xFD, 0xFB, 0xB2, 0x43, 0xC1,
+  0xA5, 0x28, 0x14, 0xD7, 0xCC, 0x66, 0xB3, 0x28, 0xCD, 0xE2, 0xD3, 0x0D, 0xDF, 0x0E, 0x7D, 0xEF, 0xE2, 0xEC, 0x49, 0xDD,
+  0xE7, 0xCF, 0x19, 0x62, 0xDC, 0xD0, 0xF7, 0xDC, 0x90, 0x5C, 0x42, 0xEE, 0xE7, 0x35, 0x5E, 0x24, 0x69, 0x51, 0xE3, 0xE2,
+  0x56, 0x6B, 0x5B, 0xB9, 0xBA, 0x11, 0x1D, 0x88, 0x6F, 0x57, 0x7A, 0x4A, 0xB0, 0x7C, 0xBF, 0x54, 0xC8, 0x7C, 0x76, 0x6F,
+  0x4D, 0x01, 0x54, 0x6C, 0xCB, 0x3C, 0x42, 0x72, 0x14, 0xA3, 0x0C, 0x76, 0xE8, 0x45, 0x81, 0x45, 0xE2, 0x78, 0x0B, 0xBA,
+  0x0B, 0x71, 0x45, 0xAF, 0x35, 0xB0, 0x4F, 0x1B, 0x22, 0x97, 0xC2, 0x5A, 0x2E, 0xF2, 0x92, 0xA9, 0x8E, 0x6D, 0x19, 0x67,
+  0x6E, 0x03, 0x81, 0x5E, 0xA5, 0xD7, 0xB8, 0xB5, 0x10, 0xF5, 0x45, 0x20, 0x05, 0x7B, 0x51, 0xD7, 0x5D, 0x8D, 0x83, 0x20,
+  0xAF, 0x4B, 0x6F, 0xDC, 0xFB, 0xC6, 0x9C, 0xCF, 0x33, 0x69, 0xB9, 0x3A, 0x84, 0xE8, 0x5B, 0x83, 0x6C, 0xC9, 0x14, 0xE5,
+  0x4E, 0xBE, 0xAE, 0x52, 0x18, 0x45, 0x11, 0x96, 0x35, 0xD6, 0x2B, 0x0B, 0xAC, 0xDA, 0xBD, 0x1E, 0xB8, 0x34, 0xF0, 0x82,
+  0x2A, 0x85, 0x11, 0x73, 0x64, 0x6A, 0x23, 0x1D, 0xCD, 0xFA, 0xE1, 0xE9, 0xD9, 0xC5, 0xF1, 0x51, 0x91, 0x65, 0xA1, 0xAC,
+  0x5B, 0x2F, 0x62, 0xFA, 0x32, 0x5D, 0x76, 0x50, 0xA7, 0x09, 0x85, 0xD4, 0xAB, 0x9E, 0x95, 0xCB, 0x1B, 0xAB, 0x96, 0xA7,
+  0xD3, 0xB0, 0x97, 0x0C, 0x56, 0xC4, 0xF4, 0x24, 0x1E, 0xA5, 0xD8, 0xF4, 0x06, 0x59, 0x0E, 0x0E, 0xC3, 0x81, 0x26, 0x1F,
+  0x88, 0xA5, 0x06, 0x29, 0xFD, 0x49, 0x6B, 0xCD, 0x63, 0x3F, 0xB8, 0x19, 0x03, 0x02, 0x46, 0xFC, 0xD5, 0xC5, 0x37, 0x29,
+  0x76, 0x8C, 0x26, 0x01, 0x19, 0x0F, 0xB4, 0x86, 0x86, 0x60, 0xBF, 0xA3, 0xA5, 0x47, 0x65, 0xA7, 0xD4, 0xBD, 0xD6, 0x12,
+  0xC1, 0xAB, 0x33, 0x34, 0x6D, 0x18, 0xEF, 0x56, 0xE5, 0xC5, 0x7E, 0x03, 0xAB, 0x60, 0xCF, 0x2F, 0x0F, 0x7F, 0x1C, 0xAF,
+  0x8C, 0x02, 0x3F, 0x9E, 0xF5, 0x64, 0xB1, 0x33, 0xE3, 0x34, 0xC0, 0xBD, 0x3C, 0x94, 0x11, 0x5A, 0x60, 0xF6, 0x1B, 0x0B,
+  0xAD, 0xD3, 0xDE, 0x58, 0x3C, 0x67, 0x4B, 0x3B, 0x24, 0x75, 0x7F, 0x39, 0xEB, 0x4E, 0x11, 0x08, 0x22, 0xF9, 0x98, 0x09,
+  0xEE, 0x0F, 0x34, 0x7E, 0xD2, 0xD3, 0x86, 0xE2, 0xBC, 0xA7, 0x93, 0x5B, 0x3C, 0xF5, 0x61, 0x1F, 0x6D, 0x36, 0xCD, 0xDD,
+  0x46, 0xCB, 0x6C, 0x98, 0xCD, 0xAD, 0x7E, 0x43, 0xD0, 0xE6, 0xF8, 0xE5, 0x53, 0x24, 0x36, 0xF7, 0xC9, 0x40, 0xE3, 0xD5,
+  0x25, 0xAD, 0x4B, 0x86, 0x50, 0x1A, 0x12, 0xCB, 0xE0, 0x40, 0x8B, 0xC7, 0xD3, 0x62, 0x7C, 0xAA, 0x21, 0x71, 0x0C, 0x1D,
+  0x68, 0x1C, 0x3C, 0xAF, 0x0F, 0x2C, 0xAF, 0xEE, 0xB0, 0x01, 0x71, 0xE7, 0x9F, 0x1B, 0x88, 0x32, 0xD7, 0x8B, 0x6A, 0x99,
+  0x6F, 0x4A, 0x50, 0xBB, 0xCC, 0x26, 0xA5, 0xA0, 0xFB, 0xEE, 0x28, 0xF4, 0x7B, 0xE9, 0x77, 0xA5, 0xE4, 0xF8, 0xD9, 0x13,
+  0x17, 0xC7, 0x0F, 0xC8, 0x79, 0x51, 0x2D, 0x29, 0x6B, 0xB8, 0x52, 0x6E, 0x7D, 0xCF, 0x17, 0x8D, 0x3C, 0xB1, 0x56, 0x1B,
+  0xBE, 0xFC, 0xFD, 0x67, 0x2F, 0x3F, 0xFD, 0xEC, 0xAB, 0xBF, 0xBF, 0xAF, 0x3F, 0xF6, 0x5C, 0x1B, 0xCF, 0x21, 0x7C, 0x92,
+  0xA6, 0x94, 0xD9, 0x5C, 0x30, 0xFF, 0xE3, 0x57, 0xFA, 0x25, 0x2C, 0xEA, 0x1B, 0x71, 0xB7, 0x97, 0xA2, 0x3F, 0xD4, 0x9F,
+  0x12, 0xDB, 0xDD, 0x90, 0x7F, 0x37, 0xE1, 0x7F, 0xF1, 0xC9, 0x27, 0xFA, 0xE5, 0x24, 0x0A, 0x36, 0x63, 0xEF, 0x2C, 0x95,
+  0xFF, 0xAD, 0xFE, 0x9D, 0x80, 0x6E, 0xC4, 0xBC, 0xB7, 0x90, 0xFD, 0xC1, 0x17, 0xFA, 0x05, 0x6C, 0x15, 0x82, 0x8D, 0xD8,
+  0x9B, 0x09, 0xFB, 0xCB, 0xE7, 0x7F, 0xD6, 0x2F, 0xA2, 0x35, 0x5E, 0x87, 0xD8, 0x8B, 0x40, 0xA7, 0x8A, 0x75, 0xD9, 0x97,
+  0x5E, 0xA9, 0x76, 0xC5, 0xFA, 0x36, 0x14, 0x33, 0x92, 0x45, 0xED, 0xB6, 0xF6, 0xBA, 0x9D, 0x56, 0xD7, 0x6C, 0x6D, 0x54,
+  0xB9, 0xC9, 0xB8, 0x74, 0x7D, 0x96, 0xAB, 0x93, 0xBC, 0xBB, 0x41, 0x35, 0x25, 0x03, 0xD5, 0xFF, 0x92, 0x9C, 0x76, 0x75,
+  0x39, 0xAF, 0x1B, 0x0A, 0xB1, 0x40, 0x80, 0xC8, 0x78, 0x59, 0xE8, 0xAA, 0xBD, 0x2F, 0x0C, 0x38, 0x3C, 0x69, 0xBD, 0x27,
+  0x66, 0x39, 0x65, 0xCD, 0x20, 0x19, 0xF9, 0xAE, 0x34, 0x84, 0x66, 0xB5, 0x86, 0x00, 0x35, 0xFD, 0xD5, 0xBF, 0xFE, 0xF8,
+  0xEF, 0xDF, 0xFD, 0x41, 0x3F, 0x27, 0x7C, 0xA1, 0xD8, 0x28, 0xA9, 0x5F, 0x7C, 0xF0, 0xB7, 0xAF, 0x9F, 0x7F, 0xA1, 0x5B,
+  0x8E, 0x17, 0x92, 0xEA, 0x8C, 0xBC, 0x07, 0x7D, 0xF8, 0x9B, 0x17, 0xFF, 0x7C, 0x5F, 0x3F, 0x83, 0x65, 0xBD, 0x72, 0x21,
+  0x14, 0x58, 0x6E, 0xDE, 0x59, 0xCB, 0xDB, 0x77, 0xD6, 0xF2, 0xDD, 0xBB, 0x62, 0x39, 0x2F, 0x7D, 0x3E, 0xE8, 0x39, 0x3C,
+  0xE9, 0xBC, 0x27, 0x46, 0x9E, 0x15, 0xDB, 0x41, 0xE7, 0xCE, 0xA6, 0xC6, 0xDE, 0x9D, 0xB5, 0x7C, 0xFF, 0xCE, 0x5A, 0x7E,
+  0xF0, 0xBF, 0x6F, 0xF9, 0xEB, 0x6E, 0x3D, 0x92, 0x07, 0x1E, 0xDA, 0x50, 0x3E, 0x05, 0x29, 0xD8, 0x7A, 0x2C, 0x5D, 0x9B,
+  0x3C, 0x1A, 0x7C, 0xD5, 0x83, 0x06, 0xDF, 0xF2, 0x3E, 0xFF, 0xD3, 0xD7, 0xBF, 0xF8, 0xE8, 0xC5, 0xE7, 0x1F, 0xE9, 0x0F,
+  0x7C, 0x12, 0x50, 0xCF, 0xA6, 0x16, 0x65, 0xF3, 0xCD, 0x5C, 0xF5, 0xE5, 0xC7, 0x2F, 0x3E, 0xFF, 0x2B, 0x9F, 0xEC, 0x04,
+  0xF3, 0x8D, 0x8F, 0x2A, 0xC0, 0xFB, 0xEB, 0xBF, 0xE8, 0xFC, 0xB4, 0xE4, 0x6C, 0x78, 0x4C, 0xF9, 0xF2, 0xE3, 0x97, 0x9F,
+  0xFE, 0x52, 0x9F, 0xC2, 0xD1, 0x79, 0xE2, 0x7C, 0xC3, 0x3B, 0xF5, 0xF8, 0xB7, 0x53, 0x31, 0xDD, 0x88, 0xB9, 0x72, 0x73,
+  0x9A, 0x3C, 0x3D, 0xD2, 0x50, 0x3C, 0x05, 0x1F, 0x68, 0x2B, 0x3F, 0x03, 0xD1, 0x86, 0x4F, 0x92, 0xA9, 0x5B, 0xBF, 0x21,
+  0x71, 0x94, 0xCA, 0xA4, 0xBF, 0xBE, 0x91, 0xC9, 0x00, 0x5F, 0x82, 0x16, 0x5B, 0x68, 0x6D, 0x18, 0xAF, 0x49, 0xA8, 0x8A,
+  0x23, 0xE4, 0x10, 0x27, 0x0F, 0x18, 0x39, 0x02, 0x2E, 0x7E, 0x80, 0x33, 0x44, 0x39, 0x47, 0x47, 0x8E, 0x1A, 0x3C, 0xFE,
+  0x0A, 0xC6, 0x8B, 0xDF, 0xD4, 0xF4, 0x1B, 0xF2, 0xF7, 0xE0, 0xFF, 0x01, 0x7F, 0xFC, 0xDB, 0x16, 0x17, 0x2E, 0x00, 0x00,
+};
@@ -0,0 +1,36 @@
+#!/usr/bin/env python3
+# Compresses the pages in this folder and writes them to ../WS_WebPages.h as PROGMEM arrays.
+# Run it after editing a page:  python3 embed_pages.py
+import gzip
+import hashlib
+import os
+
+PAGES = [                      # (source file, C name)
+    ("index.html", "Web_Page_Root"),
+    ("rtc.html", "Web_Page_RTC"),
+]
+
+here = os.path.dirname(os.path.abspath(__file__))
+out = ['#pragma once',
+       '',
+       '// Generated by web/embed_pages.py from the pages in web/, do not edit by hand.',
+       '// The pages are stored gzip compressed and sent as they are with "Content-Encoding: gzip".',
+       '',
+       '#include <stdint.h>',
+       '#include <stddef.h>',
+       '#include <pgmspace.h>',
+       '']
+for source, name in PAGES:
+    with open(os.path.join(here, source), 'rb') as f:
+        html = f.read()
+    data = gzip.compress(html, compresslevel=9, mtime=0)
+    etag = hashlib.sha1(data).hexdigest()[:16]
+    out.append('#define %s_ETag   "\\"%s\\""' % (name, etag))
+    out.append('#define %s_Length %d   // %d bytes before compression' % (name, len(data), len(html)))
+    out.append('static const uint8_t %s[] PROGMEM = {' % name)
+    for i in range(0, len(data), 20):
+        out.append('  ' + ', '.join('0x%02X' % b for b in data[i:i + 20]) + ',')
+    out.append('};')
+    out.append('')
+with open(os.path.join(here, '..', 'WS_WebPages.h'), 'w', newline='\r\n') as f:
+    f.write('\n'.join(out))
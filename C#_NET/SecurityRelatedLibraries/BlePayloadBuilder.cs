@@ -8,6 +8,7 @@ namespace SecurityRelatedLibraries
 {
     // Usage:
     // Console.WriteLine(BlePayloadBuilder.BuildPayloadHex(0x01));
+    // Console.WriteLine(BlePayloadBuilder.BuildBatchPayloadHex(0x0F, 0xF0));   // v2 frame, see below
     /*
       [channel][epoch UTC seconds (4 bytes, big-endian)][HMAC-SHA256 first 12 bytes]
       17 bytes total → 34 hex characters. 
@@ -71,5 +72,70 @@ namespace SecurityRelatedLibraries
 
             return hex;
         }
+
+        /*
+          v2 batch frame: several relays switch in one write and one HMAC.
+
+          [ 1 byte version = 0x02 ]
+          [ 1 byte set mask   (bit0 = CH1) ]
+          [ 1 byte clear mask (bit0 = CH1), must not overlap the set mask ]
+          [ 2 bytes sequence (big-endian), tells commands of the same second apart ]
+          [ 4 bytes epoch-seconds (UTC, big-endian) ]
+          [ 12 bytes HMAC-SHA256 of the first 9 bytes, truncated ]
+          = 21 bytes total
+          = 42 hex characters
+
+          Example (set CH1~CH4, clear CH5~CH8, sequence 1, epoch 0x67B5A230):
+          > 020FF0000167B5A230E9E26C031F4B56D34432B077
+          > 02 | 0F | F0 | 00 01 | 67 B5 A2 30 | E9 E2 6C 03 1F 4B 56 D3 44 32 B0 77
+         */
+        public const byte BatchVersion = 0x02;
+
+        private static ushort batchSequence;
+
+        // Builds the 21-byte binary v2 payload, the sequence counts up per call unless given
+        public static byte[] BuildBatchPayload(byte setMask, byte clearMask, ushort? sequence = null)
+        {
+            if ((setMask & clearMask) != 0)
+                throw new ArgumentException("A channel cannot be in the set and the clear mask");
+
+            ushort seq = sequence ?? unchecked(++batchSequence);
+            uint epoch = (uint)DateTimeOffset.UtcNow.ToUnixTimeSeconds();
+
+            byte[] payload = new byte[21];
+            payload[0] = BatchVersion;
+            payload[1] = setMask;
+            payload[2] = clearMask;
+            payload[3] = (byte)(seq >> 8);
+            payload[4] = (byte)(seq);
+            payload[5] = (byte)(epoch >> 24);
+            payload[6] = (byte)(epoch >> 16);
+            payload[7] = (byte)(epoch >> 8);
+            payload[8] = (byte)(epoch);
+
+            byte[] fullMac;
+            using (var h = new HMACSHA256(SecretKey))
+            {
+                fullMac = h.ComputeHash(payload, 0, 9);
+            }
+
+            // payload = signed bytes + first 12 bytes of HMAC
+            Buffer.BlockCopy(fullMac, 0, payload, 9, 12);
+
+            return payload;
+        }
+
+        // Builds the 42-hex-character string for BLE tools (nRF Connect, etc.)
+        public static string BuildBatchPayloadHex(byte setMask, byte clearMask, ushort? sequence = null)
+        {
+            byte[] payload = BuildBatchPayload(setMask, clearMask, sequence);
+            string hex = BitConverter.ToString(payload).Replace("-", "");
+
+            Console.WriteLine($"UTC now  : {DateTimeOffset.UtcNow:O}");
+            Console.WriteLine($"HEX(42)  : {hex}");
+            Console.WriteLine($"LEN      : {hex.Length}");
+
+            return hex;
+        }
     }
 }
\ No newline at end of file